@@ -0,0 +1,195 @@
+/*
+ * Binance Adapter
+ *
+ * Connects to Binance.US combined streams and parses 24hr ticker, bookTicker
+ * and trade events.
+ *
+ * Features:
+ *  - Up to BINANCE_SYMBOLS_PER_CONNECTION symbols per connection, subscribed
+ *    in SUBSCRIBE batches of BINANCE_STREAMS_PER_REQUEST streams.
+ *  - Each symbol gets its feed profile's quote stream plus "@trade".
+ *  - Events are unwrapped from the {"stream":...,"data":{...}} envelope.
+ *
+ * Dependencies:
+ *  - jansson: Symbol list and subscription requests.
+ *  - libwebsockets: Outgoing frames.
+ *
+ * Usage:
+ *  - Registered as `binance_adapter` in `exchange_adapter.c`.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#include "exchange_adapter.h"
+#include "exchange_websocket.h"
+#include "json_parser.h"
+#include "feed_profiles.h"
+#include "cryptofeed_internal.h"
+#include "utils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BINANCE_SYMBOLS_FILE "currency_text_files/binance_currency_ids_trades.txt"
+
+/* Combined streams wrap each event as {"stream":"<symbol>@<channel>","data":{...}}; return the inner object */
+static const char *unwrap_binance_stream(const char *msg, size_t *len) {
+    if (*len < 11 || memcmp(msg, "{\"stream\":\"", 11) != 0) return msg;
+
+    size_t window = (*len < CLASSIFY_WINDOW) ? *len : CLASSIFY_WINDOW;
+    const char *data = json_find(msg, window, "\"data\":");
+    if (!data) return msg;
+    data += 7;
+    *len = (msg + *len) - data;
+    return data;
+}
+
+/* Binance bookTicker event: best bid/ask only, no event time */
+static void handle_binance_quote(const char *msg, size_t len) {
+    msg = unwrap_binance_stream(msg, &len);
+    TickerData binance_quote = {0};
+    strncpy(binance_quote.exchange, "Binance", MAX_EXCHANGE_NAME_LENGTH - 1);
+    binance_quote.exchange[MAX_EXCHANGE_NAME_LENGTH - 1] = '\0';
+
+    if (extract_order_data(msg, len, "\"s\":\"", binance_quote.currency, sizeof(binance_quote.currency)) &&
+        extract_order_data(msg, len, "\"b\":\"", binance_quote.bid, sizeof(binance_quote.bid)) &&
+        extract_order_data(msg, len, "\"a\":\"", binance_quote.ask, sizeof(binance_quote.ask))) {
+
+        extract_order_data(msg, len, "\"B\":\"", binance_quote.bid_qty, sizeof(binance_quote.bid_qty));
+        extract_order_data(msg, len, "\"A\":\"", binance_quote.ask_qty, sizeof(binance_quote.ask_qty));
+        extract_order_data(msg, len, "\"u\":", binance_quote.sequence, sizeof(binance_quote.sequence));
+
+        get_timestamp(binance_quote.timestamp, sizeof(binance_quote.timestamp));
+        binance_quote.local_time = 1;
+        cryptofeed_emit_ticker(&binance_quote);
+    }
+}
+
+/* Binance trade event */
+static void handle_binance_trade(const char *msg, size_t len) {
+    msg = unwrap_binance_stream(msg, &len);
+    TradeData binance_trade = {0};
+    strncpy(binance_trade.exchange, "Binance", sizeof(binance_trade.exchange) - 1);
+
+    char trade_time[32] = {0};
+    if (extract_order_data(msg, len, "\"E\":", trade_time, sizeof(trade_time)) &&
+        extract_order_data(msg, len, "\"s\":\"", binance_trade.currency, sizeof(binance_trade.currency)) &&
+        extract_order_data(msg, len, "\"p\":\"", binance_trade.price, sizeof(binance_trade.price)) &&
+        extract_order_data(msg, len, "\"q\":\"", binance_trade.size, sizeof(binance_trade.size)) &&
+        extract_order_data(msg, len, "\"t\":", binance_trade.trade_id, sizeof(binance_trade.trade_id)) &&
+        extract_order_data(msg, len, "\"m\":", binance_trade.market_maker, sizeof(binance_trade.market_maker))) {
+
+        convert_binance_timestamp(binance_trade.timestamp, sizeof(binance_trade.timestamp), trade_time);
+        cryptofeed_emit_trade(&binance_trade);
+        // printf("[TRADE] %s | %s | Price: %s | Size: %s | ID: %s | MM: %s\n", binance_trade.exchange, binance_trade.currency, binance_trade.price, binance_trade.size, binance_trade.trade_id, binance_trade.market_maker);
+    }
+}
+
+/* Binance 24hr ticker event */
+static void handle_binance_ticker(const char *msg, size_t len) {
+    msg = unwrap_binance_stream(msg, &len);
+    TickerData binance_ticker = {0};
+    strncpy(binance_ticker.exchange, "Binance", MAX_EXCHANGE_NAME_LENGTH - 1);
+    binance_ticker.exchange[MAX_EXCHANGE_NAME_LENGTH - 1] = '\0';
+
+    if (extract_order_data(msg, len, "\"E\":", binance_ticker.time_ms, sizeof(binance_ticker.time_ms)) &&
+        extract_order_data(msg, len, "\"s\":\"", binance_ticker.currency, sizeof(binance_ticker.currency)) &&
+        extract_order_data(msg, len, "\"c\":\"", binance_ticker.price, sizeof(binance_ticker.price))) {
+
+        extract_order_data(msg, len, "\"b\":\"", binance_ticker.bid, sizeof(binance_ticker.bid));
+        extract_order_data(msg, len, "\"B\":\"", binance_ticker.bid_qty, sizeof(binance_ticker.bid_qty));
+        extract_order_data(msg, len, "\"a\":\"", binance_ticker.ask, sizeof(binance_ticker.ask));
+        extract_order_data(msg, len, "\"A\":\"", binance_ticker.ask_qty, sizeof(binance_ticker.ask_qty));
+        extract_order_data(msg, len, "\"o\":\"", binance_ticker.open_price, sizeof(binance_ticker.open_price));
+        extract_order_data(msg, len, "\"h\":\"", binance_ticker.high_price, sizeof(binance_ticker.high_price));
+        extract_order_data(msg, len, "\"l\":\"", binance_ticker.low_price, sizeof(binance_ticker.low_price));
+        extract_order_data(msg, len, "\"v\":\"", binance_ticker.volume_24h, sizeof(binance_ticker.volume_24h));
+        extract_order_data(msg, len, "\"q\":\"", binance_ticker.quote_volume, sizeof(binance_ticker.quote_volume));
+        extract_order_data(msg, len, "\"t\":\"", binance_ticker.last_trade_time, sizeof(binance_ticker.last_trade_time));
+        extract_order_data(msg, len, "\"p\":\"", binance_ticker.last_trade_price, sizeof(binance_ticker.last_trade_price));
+        extract_order_data(msg, len, "\"C\":\"", binance_ticker.close_price, sizeof(binance_ticker.close_price));
+        extract_order_data(msg, len, "\"S\":\"", binance_ticker.symbol, sizeof(binance_ticker.symbol));
+
+        convert_binance_timestamp(binance_ticker.timestamp, sizeof(binance_ticker.timestamp), binance_ticker.time_ms);
+
+        cryptofeed_emit_ticker(&binance_ticker);
+    }
+}
+
+/* Subscribe one Binance connection to its slice of the symbol list on the combined-stream endpoint.
+ * Connection N takes symbols [N * BINANCE_SYMBOLS_PER_CONNECTION, (N + 1) * BINANCE_SYMBOLS_PER_CONNECTION),
+ * each with its feed profile's quote stream plus "@trade", queued as SUBSCRIBE requests of at most
+ * BINANCE_STREAMS_PER_REQUEST streams each (~10 KB), one sent per writeable callback. */
+static int subscribe_binance_chunk(struct lws *wsi, int chunk_index) {
+    json_t *symbols = load_json_array(BINANCE_SYMBOLS_FILE);
+    if (!symbols) return -1;
+
+    size_t first = (size_t)chunk_index * BINANCE_SYMBOLS_PER_CONNECTION;
+    size_t total = json_array_size(symbols);
+    size_t last = first + BINANCE_SYMBOLS_PER_CONNECTION;
+    if (last > total) last = total;
+
+    /* "<symbol>@<stream>" entries are well under 64 bytes */
+    size_t capacity = 64 + (size_t)BINANCE_STREAMS_PER_REQUEST * 64;
+    char *request = malloc(capacity);
+    if (!request) {
+        json_decref(symbols);
+        fprintf(stderr, "[ERROR] Memory allocation failed\n");
+        return -1;
+    }
+
+    int result = 0, in_request = 0, request_id = 1, total_streams = 0;
+    size_t used = 0;
+    for (size_t i = first; i < last && result == 0; i++) {
+        const char *symbol = json_string_value(json_array_get(symbols, i));
+        if (!symbol || strlen(symbol) > 32) continue;
+
+        const char *streams[BINANCE_STREAMS_PER_SYMBOL];
+        int stream_count = 0;
+        const char *quote = feed_quote_channel("binance", get_feed_profile("binance", symbol));
+        if (quote) streams[stream_count++] = quote;
+        streams[stream_count++] = "trade";
+
+        for (int s = 0; s < stream_count && result == 0; s++) {
+            if (in_request == 0)
+                used = snprintf(request, capacity, "{\"method\": \"SUBSCRIBE\", \"params\": [");
+            used += snprintf(request + used, capacity - used, "%s\"%s@%s\"",
+                             in_request ? "," : "", symbol, streams[s]);
+            in_request++;
+            total_streams++;
+
+            if (in_request == BINANCE_STREAMS_PER_REQUEST) {
+                used += snprintf(request + used, capacity - used, "], \"id\": %d}", request_id++);
+                result = queue_ws_text(wsi, request, used);
+                in_request = 0;
+            }
+        }
+    }
+    if (result == 0 && in_request > 0) {
+        used += snprintf(request + used, capacity - used, "], \"id\": %d}", request_id++);
+        result = queue_ws_text(wsi, request, used);
+    }
+
+    free(request);
+    json_decref(symbols);
+    if (result == 0)
+        printf("[INFO] Queued %d Binance stream subscriptions on connection %d\n", total_streams, chunk_index);
+    return result;
+}
+
+const ExchangeAdapter binance_adapter = {
+    .display_name = "Binance",
+    .endpoint = { "binance", "stream.binance.us", 9443, "/stream", BINANCE_SYMBOLS_FILE,
+                  BINANCE_SYMBOLS_PER_CONNECTION, 6, 10, 1000, 1 },
+    .max_connections = 6,
+    .taker_fee_bps = 10,
+    .subscribe = subscribe_binance_chunk,
+    .on_message = adapter_route_message,
+    .classify = classify_binance_message,
+    .on_ticker = handle_binance_ticker,
+    .on_quote = handle_binance_quote,
+    .on_trade = handle_binance_trade,
+    .normalize_symbol = normalize_concatenated_symbol
+};
@@ -0,0 +1,229 @@
+/*
+ * Bitfinex Adapter
+ *
+ * Connects to the Bitfinex v2 public feed and parses ticker and executed
+ * trade updates.
+ *
+ * Features:
+ *  - One connection per 15-symbol chunk file (30 channels per connection).
+ *  - Updates carry only a channel ID; subscribe acks fill a dense
+ *    per-connection table (`bitfinex_channels.c`) used to route them, so
+ *    this adapter replaces the default receive path.
+ *  - Pairs look like "BTCUSD" or "BTC:UST"; UST is Bitfinex's code for USDT.
+ *
+ * Dependencies:
+ *  - libwebsockets: Outgoing frames.
+ *  - Standard C libraries (stdio, stdlib, string, ctype).
+ *
+ * Usage:
+ *  - Registered as `bitfinex_adapter` in `exchange_adapter.c`.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#include "exchange_adapter.h"
+#include "exchange_websocket.h"
+#include "json_parser.h"
+#include "feed_profiles.h"
+#include "cryptofeed_internal.h"
+#include "utils.h"
+#include "bitfinex_channels.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+/* Subscribe one Bitfinex connection to ticker and trades for every symbol in its chunk file; one frame per
+ * channel, queued and sent one per writeable callback */
+static int subscribe_bitfinex_chunk(struct lws *wsi, int chunk_index) {
+    char filename[64];
+    snprintf(filename, sizeof(filename), "currency_text_files/bitfinex_currency_chunk_%d.txt", chunk_index);
+
+    FILE *fp = fopen(filename, "r");
+    if (!fp) {
+        fprintf(stderr, "[ERROR] Could not open %s\n", filename);
+        return -1;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    long fsize = ftell(fp);
+    rewind(fp);
+
+    char *file_buf = malloc(fsize + 1);
+    if (!file_buf) {
+        fclose(fp);
+        fprintf(stderr, "[ERROR] Memory allocation failed\n");
+        return -1;
+    }
+
+    fread(file_buf, 1, fsize, fp);
+    file_buf[fsize] = '\0';
+    fclose(fp);
+
+    /* Channel IDs are only valid for the connection that subscribed them */
+    bitfinex_channels_reset(chunk_index);
+
+    int sent = 0;
+    char *token = strtok(file_buf, "[\", \n]");
+    while (token) {
+        static const char *channels[] = { "ticker", "trades" };
+        int first = feed_quote_channel("bitfinex", get_feed_profile("bitfinex", token)) ? 0 : 1;
+        for (int i = first; i < 2; i++) {
+            char sub_msg[128];
+            int n = snprintf(sub_msg, sizeof(sub_msg),
+                             "{\"event\": \"subscribe\", \"channel\": \"%s\", \"symbol\": \"%s\"}",
+                             channels[i], token);
+            if (queue_ws_text(wsi, sub_msg, (size_t)n) != 0) {
+                free(file_buf);
+                return -1;
+            }
+            sent++;
+        }
+        token = strtok(NULL, "[\", \n]");
+    }
+
+    free(file_buf);
+    printf("[INFO] Queued %d Bitfinex subscriptions on connection %d\n", sent, chunk_index);
+    return 0;
+}
+
+/* Bitfinex subscribe ack: {"event":"subscribed","channel":"ticker","chanId":N,"symbol":"tBTCUSD","pair":"BTCUSD"} */
+static void handle_bitfinex_subscribed(int connection, const char *msg, size_t len) {
+    if (!json_contains(msg, len, "\"event\":\"subscribed\""))
+        return;
+
+    char chan_id[24] = {0}, channel[16] = {0}, pair[24] = {0};
+    if (!extract_numeric(msg, len, "\"chanId\":", chan_id, sizeof(chan_id)) || !chan_id[0] ||
+        !extract_order_data(msg, len, "\"channel\":\"", channel, sizeof(channel)) ||
+        !extract_order_data(msg, len, "\"pair\":\"", pair, sizeof(pair)))
+        return;
+
+    BitfinexChannelType type = BITFINEX_CHANNEL_NONE;
+    if (strcmp(channel, "ticker") == 0) type = BITFINEX_CHANNEL_TICKER;
+    else if (strcmp(channel, "trades") == 0) type = BITFINEX_CHANNEL_TRADES;
+    else return;
+
+    bitfinex_channels_add(connection, atol(chan_id), type, pair, strlen(pair));
+}
+
+/* Bitfinex ticker update: [chanId,[BID,BID_SIZE,ASK,ASK_SIZE,DAILY_CHANGE,DAILY_CHANGE_RELATIVE,LAST_PRICE,VOLUME,HIGH,LOW]] */
+static void handle_bitfinex_ticker(const BitfinexChannel *channel, const char *msg, size_t len) {
+    const char *inner = memchr(msg + 1, '[', len - 1);
+    if (!inner) return;
+
+    JsonField f[10];
+    if (split_flat_array(inner, (msg + len) - inner, f, 10) < 10) return;
+
+    TickerData bitfinex_ticker = {0};
+    strncpy(bitfinex_ticker.exchange, "Bitfinex", MAX_EXCHANGE_NAME_LENGTH - 1);
+    strncpy(bitfinex_ticker.currency, channel->symbol, sizeof(bitfinex_ticker.currency) - 1);
+
+    copy_field(&f[0], bitfinex_ticker.bid, sizeof(bitfinex_ticker.bid));
+    copy_field(&f[1], bitfinex_ticker.bid_qty, sizeof(bitfinex_ticker.bid_qty));
+    copy_field(&f[2], bitfinex_ticker.ask, sizeof(bitfinex_ticker.ask));
+    copy_field(&f[3], bitfinex_ticker.ask_qty, sizeof(bitfinex_ticker.ask_qty));
+    copy_field(&f[6], bitfinex_ticker.price, sizeof(bitfinex_ticker.price));
+    copy_field(&f[7], bitfinex_ticker.volume_24h, sizeof(bitfinex_ticker.volume_24h));
+    copy_field(&f[8], bitfinex_ticker.high_price, sizeof(bitfinex_ticker.high_price));
+    copy_field(&f[9], bitfinex_ticker.low_price, sizeof(bitfinex_ticker.low_price));
+
+    get_timestamp(bitfinex_ticker.timestamp, sizeof(bitfinex_ticker.timestamp));
+    bitfinex_ticker.local_time = 1;
+    cryptofeed_emit_ticker(&bitfinex_ticker);
+}
+
+/* Bitfinex executed trade: [chanId,"te",[ID,MTS,AMOUNT,PRICE]]; a negative amount is a taker sell */
+static void handle_bitfinex_trade(const BitfinexChannel *channel, const char *msg, size_t len) {
+    const char *inner = memchr(msg + 1, '[', len - 1);
+    if (!inner) return;
+
+    JsonField f[4];
+    if (split_flat_array(inner, (msg + len) - inner, f, 4) < 4) return;
+
+    TradeData bitfinex_trade = {0};
+    strncpy(bitfinex_trade.exchange, "Bitfinex", sizeof(bitfinex_trade.exchange) - 1);
+    strncpy(bitfinex_trade.currency, channel->symbol, sizeof(bitfinex_trade.currency) - 1);
+
+    copy_field(&f[0], bitfinex_trade.trade_id, sizeof(bitfinex_trade.trade_id));
+    copy_field(&f[3], bitfinex_trade.price, sizeof(bitfinex_trade.price));
+
+    char mts[32];
+    copy_field(&f[1], mts, sizeof(mts));
+    convert_binance_timestamp(bitfinex_trade.timestamp, sizeof(bitfinex_trade.timestamp), mts);
+
+    /* Same convention as Binance's "m": true when the buyer was the maker */
+    JsonField amount = f[2];
+    int taker_sell = (amount.len > 0 && amount.ptr[0] == '-');
+    if (taker_sell) {
+        amount.ptr++;
+        amount.len--;
+    }
+    copy_field(&amount, bitfinex_trade.size, sizeof(bitfinex_trade.size));
+    strncpy(bitfinex_trade.market_maker, taker_sell ? "true" : "false", sizeof(bitfinex_trade.market_maker) - 1);
+
+    cryptofeed_emit_trade(&bitfinex_trade);
+}
+
+/* Bitfinex messages are routed by channel ID, so the connection's table is needed */
+static int bitfinex_on_message(ConnectionSlot *slot, struct lws *wsi, const char *msg, size_t len) {
+    (void)wsi;
+    int connection = slot->chunk_index;
+    MessageKind kind = classify_bitfinex_message(msg, len);
+    switch (kind) {
+        case MSG_ACK:
+            handle_bitfinex_subscribed(connection, msg, len);
+            break;
+        case MSG_TICKER:
+        case MSG_TRADE: {
+            /* The classifier has checked that digits and a ',' follow the '[' */
+            long chan_id = strtol(msg + 1, NULL, 10);
+            const BitfinexChannel *channel = bitfinex_channels_lookup(connection, chan_id);
+            if (!channel) break;
+            if (kind == MSG_TICKER && channel->type == BITFINEX_CHANNEL_TICKER)
+                handle_bitfinex_ticker(channel, msg, len);
+            else if (kind == MSG_TRADE && channel->type == BITFINEX_CHANNEL_TRADES)
+                handle_bitfinex_trade(channel, msg, len);
+            break;
+        }
+        case MSG_ERROR:
+            log_exchange_error(slot->protocol, msg, len);
+            break;
+        default:
+            break;
+    }
+    return 0;
+}
+
+/* "BTCUSD", "tBTCUSD" or "BTC:UST" to "BTC-USD" / "BTC-USDT" */
+static int normalize_bitfinex_symbol(const char *symbol, char *dest, size_t dest_size) {
+    if (symbol[0] == 't' && isupper((unsigned char)symbol[1])) symbol++;
+
+    char pair[32];
+    if (strchr(symbol, ':')) {
+        snprintf(pair, sizeof(pair), "%s", symbol);
+    } else if (strlen(symbol) == 6) {
+        snprintf(pair, sizeof(pair), "%.3s:%s", symbol, symbol + 3);
+    } else {
+        return 0;
+    }
+    if (!normalize_separated_symbol(pair, dest, dest_size)) return 0;
+
+    size_t n = strlen(dest);
+    if (n >= 4 && strcmp(dest + n - 4, "-UST") == 0 && n + 2 <= dest_size)
+        strcpy(dest + n - 4, "-USDT");
+    return 1;
+}
+
+const ExchangeAdapter bitfinex_adapter = {
+    .display_name = "Bitfinex",
+    .endpoint = { "bitfinex", "api-pub.bitfinex.com", 443, "/ws/2", "currency_text_files/bitfinex_currency_ids.txt",
+                  15, 2, 5, 3000, 0 },      // 30 channels per connection, 20 connects/min
+    .max_connections = BITFINEX_MAX_CONNECTIONS,
+    .taker_fee_bps = 20,
+    .subscribe = subscribe_bitfinex_chunk,
+    .on_message = bitfinex_on_message,
+    .classify = classify_bitfinex_message,
+    .normalize_symbol = normalize_bitfinex_symbol
+};
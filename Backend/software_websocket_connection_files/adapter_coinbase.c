@@ -0,0 +1,134 @@
+/*
+ * Coinbase Adapter
+ *
+ * Connects to the Coinbase Exchange feed and parses ticker and match messages.
+ *
+ * Features:
+ *  - One connection subscribing every product to "matches", and to "ticker"
+ *    unless its feed profile is trades only.
+ *  - Coinbase has no separate top-of-book channel; tickers carry best bid/ask.
+ *
+ * Dependencies:
+ *  - jansson: Product list and subscription request.
+ *  - libwebsockets: Outgoing frames.
+ *
+ * Usage:
+ *  - Registered as `coinbase_adapter` in `exchange_adapter.c`.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#include "exchange_adapter.h"
+#include "exchange_websocket.h"
+#include "json_parser.h"
+#include "feed_profiles.h"
+#include "cryptofeed_internal.h"
+#include "utils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define COINBASE_SYMBOLS_FILE "currency_text_files/coinbase_currency_ids.txt"
+
+/* Coinbase match (trade) message */
+static void handle_coinbase_trade(const char *msg, size_t len) {
+    TradeData coinbase_trade = {0};
+    strncpy(coinbase_trade.exchange, "Coinbase", sizeof(coinbase_trade.exchange) - 1);
+
+    if (extract_order_data(msg, len, "\"time\":\"", coinbase_trade.timestamp, sizeof(coinbase_trade.timestamp)) &&
+        extract_order_data(msg, len, "\"product_id\":\"", coinbase_trade.currency, sizeof(coinbase_trade.currency)) &&
+        extract_order_data(msg, len, "\"price\":\"", coinbase_trade.price, sizeof(coinbase_trade.price)) &&
+        extract_order_data(msg, len, "\"size\":\"", coinbase_trade.size, sizeof(coinbase_trade.size))) {
+
+        extract_order_data(msg, len, "\"trade_id\":", coinbase_trade.trade_id, sizeof(coinbase_trade.trade_id));
+
+        /* A match's "side" is the maker order's side, so "buy" means the buyer was the maker */
+        char side[8] = {0};
+        extract_order_data(msg, len, "\"side\":\"", side, sizeof(side));
+        if (strcmp(side, "buy") == 0) strcpy(coinbase_trade.market_maker, "true");
+        else if (strcmp(side, "sell") == 0) strcpy(coinbase_trade.market_maker, "false");
+
+        cryptofeed_emit_trade(&coinbase_trade);
+        // printf("[TRADE] %s | %s | Price: %s | Size: %s | ID: %s\n", coinbase_trade.exchange, coinbase_trade.currency, coinbase_trade.price, coinbase_trade.size, coinbase_trade.trade_id);
+    }
+}
+
+/* Coinbase ticker message */
+static void handle_coinbase_ticker(const char *msg, size_t len) {
+    TickerData coinbase_ticker = {0};
+    strncpy(coinbase_ticker.exchange, "Coinbase", MAX_EXCHANGE_NAME_LENGTH - 1);
+    coinbase_ticker.exchange[MAX_EXCHANGE_NAME_LENGTH - 1] = '\0';
+
+    if (extract_order_data(msg, len, "\"time\":\"", coinbase_ticker.timestamp, sizeof(coinbase_ticker.timestamp)) &&
+        extract_order_data(msg, len, "\"product_id\":\"", coinbase_ticker.currency, sizeof(coinbase_ticker.currency)) &&
+        extract_order_data(msg, len, "\"price\":\"", coinbase_ticker.price, sizeof(coinbase_ticker.price))) {
+        // printf("[TICKER] Coinbase | %s | Price: %s\n", coinbase_ticker.currency, coinbase_ticker.price);
+
+        extract_order_data(msg, len, "\"best_bid\":\"", coinbase_ticker.bid, sizeof(coinbase_ticker.bid));
+        extract_order_data(msg, len, "\"best_ask\":\"", coinbase_ticker.ask, sizeof(coinbase_ticker.ask));
+        extract_order_data(msg, len, "\"best_bid_size\":\"", coinbase_ticker.bid_qty, sizeof(coinbase_ticker.bid_qty));
+        extract_order_data(msg, len, "\"best_ask_size\":\"", coinbase_ticker.ask_qty, sizeof(coinbase_ticker.ask_qty));
+
+        extract_order_data(msg, len, "\"open_24h\":\"", coinbase_ticker.open_price, sizeof(coinbase_ticker.open_price));
+        extract_order_data(msg, len, "\"high_24h\":\"", coinbase_ticker.high_price, sizeof(coinbase_ticker.high_price));
+        extract_order_data(msg, len, "\"low_24h\":\"", coinbase_ticker.low_price, sizeof(coinbase_ticker.low_price));
+        extract_order_data(msg, len, "\"volume_24h\":\"", coinbase_ticker.volume_24h, sizeof(coinbase_ticker.volume_24h));
+        extract_order_data(msg, len, "\"volume_30d\":\"", coinbase_ticker.volume_30d, sizeof(coinbase_ticker.volume_30d));
+        extract_order_data(msg, len, "\"trade_id\":", coinbase_ticker.trade_id, sizeof(coinbase_ticker.trade_id));
+        extract_order_data(msg, len, "\"last_size\":\"", coinbase_ticker.last_trade_size, sizeof(coinbase_ticker.last_trade_size));
+        cryptofeed_emit_ticker(&coinbase_ticker);
+    }
+}
+
+/* Subscribe Coinbase: every product to "matches", and to "ticker" unless its feed profile is trades only */
+static int subscribe_coinbase(struct lws *wsi, int chunk_index) {
+    (void)chunk_index;      // single connection
+    json_t *products = load_json_array(COINBASE_SYMBOLS_FILE);
+    if (!products) return -1;
+
+    json_t *ticker_ids = json_array();
+    size_t index;
+    json_t *product;
+    json_array_foreach(products, index, product) {
+        if (feed_quote_channel("coinbase", get_feed_profile("coinbase", json_string_value(product))))
+            json_array_append(ticker_ids, product);
+    }
+
+    json_t *channels = json_array();
+    if (json_array_size(ticker_ids) > 0)
+        json_array_append_new(channels, json_pack("{s:s, s:o}", "name", "ticker", "product_ids", ticker_ids));
+    else
+        json_decref(ticker_ids);
+    json_array_append_new(channels, json_pack("{s:s, s:O}", "name", "matches", "product_ids", products));
+
+    json_t *request = json_pack("{s:s, s:o}", "type", "subscribe", "channels", channels);
+    char *subscribe_msg = json_dumps(request, JSON_COMPACT);
+    json_decref(request);
+    json_decref(products);
+    if (!subscribe_msg) {
+        fprintf(stderr, "[ERROR] Failed to serialize Coinbase subscription\n");
+        return -1;
+    }
+
+    int result = send_ws_text(wsi, subscribe_msg, strlen(subscribe_msg));
+    free(subscribe_msg);
+    if (result == 0)
+        printf("[INFO] Sent subscription message to coinbase-websocket\n");
+    return result;
+}
+
+const ExchangeAdapter coinbase_adapter = {
+    .display_name = "Coinbase",
+    .endpoint = { "coinbase", "ws-feed.exchange.coinbase.com", 443, "/", NULL, 0, 1, 1, 1000, 0 },
+    .max_connections = 1,
+    .taker_fee_bps = 60,
+    .subscribe = subscribe_coinbase,
+    .on_message = adapter_route_message,
+    .classify = classify_coinbase_message,
+    .on_ticker = handle_coinbase_ticker,
+    .on_quote = NULL,
+    .on_trade = handle_coinbase_trade,
+    .normalize_symbol = normalize_separated_symbol
+};
@@ -0,0 +1,218 @@
+/*
+ * Huobi Adapter
+ *
+ * Connects to the Huobi (HTX) market feed and parses ticker, bbo and
+ * trade.detail pushes.
+ *
+ * Features:
+ *  - One connection per 100-symbol chunk file.
+ *  - Every frame is gzip-compressed; it is inflated before classification.
+ *  - Answers the server's {"ping": ts} heartbeats with {"pong": ts}.
+ *
+ * Dependencies:
+ *  - zlib: GZIP decompression (`decompress_gzip()` in `utils.c`).
+ *  - libwebsockets: Outgoing frames.
+ *
+ * Usage:
+ *  - Registered as `huobi_adapter` in `exchange_adapter.c`.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#include "exchange_adapter.h"
+#include "exchange_websocket.h"
+#include "json_parser.h"
+#include "feed_profiles.h"
+#include "cryptofeed_internal.h"
+#include "utils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Huobi ticker push (already decompressed) */
+static void handle_huobi_ticker(const char *msg, size_t len) {
+    TickerData huobi_ticker = {0};
+    strncpy(huobi_ticker.exchange, "Huobi", MAX_EXCHANGE_NAME_LENGTH - 1);
+    huobi_ticker.exchange[MAX_EXCHANGE_NAME_LENGTH - 1] = '\0';
+
+    if (extract_numeric(msg, len, "\"close\":", huobi_ticker.price, sizeof(huobi_ticker.price)) &&
+        extract_huobi_currency(msg, len, huobi_ticker.currency, sizeof(huobi_ticker.currency))) {
+
+        extract_numeric(msg, len, "\"bid\":\"", huobi_ticker.bid, sizeof(huobi_ticker.bid));
+        extract_numeric(msg, len, "\"bidSize\":\"", huobi_ticker.bid_qty, sizeof(huobi_ticker.bid_qty));
+        extract_numeric(msg, len, "\"ask\":\"", huobi_ticker.ask, sizeof(huobi_ticker.ask));
+        extract_numeric(msg, len, "\"askSize\":\"", huobi_ticker.ask_qty, sizeof(huobi_ticker.ask_qty));
+
+        extract_numeric(msg, len, "\"open\":\"", huobi_ticker.open_price, sizeof(huobi_ticker.open_price));
+        extract_numeric(msg, len, "\"high\":\"", huobi_ticker.high_price, sizeof(huobi_ticker.high_price));
+        extract_numeric(msg, len, "\"low\":\"", huobi_ticker.low_price, sizeof(huobi_ticker.low_price));
+        extract_numeric(msg, len, "\"close\":\"", huobi_ticker.close_price, sizeof(huobi_ticker.close_price));
+
+        extract_numeric(msg, len, "\"amount\":\"", huobi_ticker.volume_24h, sizeof(huobi_ticker.volume_24h));
+
+        char ts_str[32] = {0};
+        if (extract_numeric(msg, len, "\"ts\":", ts_str, sizeof(ts_str))) {
+            convert_binance_timestamp(huobi_ticker.timestamp, sizeof(huobi_ticker.timestamp), ts_str);
+        } else {
+            get_timestamp(huobi_ticker.timestamp, sizeof(huobi_ticker.timestamp));
+            huobi_ticker.local_time = 1;
+        }
+        cryptofeed_emit_ticker(&huobi_ticker);
+    }
+}
+
+/* Huobi bbo push: best bid/ask only, numbers are unquoted */
+static void handle_huobi_quote(const char *msg, size_t len) {
+    TickerData huobi_quote = {0};
+    strncpy(huobi_quote.exchange, "Huobi", MAX_EXCHANGE_NAME_LENGTH - 1);
+    huobi_quote.exchange[MAX_EXCHANGE_NAME_LENGTH - 1] = '\0';
+
+    if (extract_numeric(msg, len, "\"bid\":", huobi_quote.bid, sizeof(huobi_quote.bid)) &&
+        extract_numeric(msg, len, "\"ask\":", huobi_quote.ask, sizeof(huobi_quote.ask)) &&
+        extract_huobi_currency(msg, len, huobi_quote.currency, sizeof(huobi_quote.currency))) {
+
+        extract_numeric(msg, len, "\"bidSize\":", huobi_quote.bid_qty, sizeof(huobi_quote.bid_qty));
+        extract_numeric(msg, len, "\"askSize\":", huobi_quote.ask_qty, sizeof(huobi_quote.ask_qty));
+        extract_numeric(msg, len, "\"seqId\":", huobi_quote.sequence, sizeof(huobi_quote.sequence));
+
+        char ts_str[32] = {0};
+        if (extract_numeric(msg, len, "\"ts\":", ts_str, sizeof(ts_str))) {
+            convert_binance_timestamp(huobi_quote.timestamp, sizeof(huobi_quote.timestamp), ts_str);
+        } else {
+            get_timestamp(huobi_quote.timestamp, sizeof(huobi_quote.timestamp));
+            huobi_quote.local_time = 1;
+        }
+        cryptofeed_emit_ticker(&huobi_quote);
+    }
+}
+
+/* Huobi trade.detail push (already decompressed) */
+static void handle_huobi_trade(const char *msg, size_t len) {
+    TradeData huobi_trade = {0};
+    strncpy(huobi_trade.exchange, "Huobi", sizeof(huobi_trade.exchange) - 1);
+
+    // Extract symbol from channel string
+    extract_huobi_currency(msg, len, huobi_trade.currency, sizeof(huobi_trade.currency));
+
+    // Extract trade details
+    extract_numeric(msg, len, "\"price\":", huobi_trade.price, sizeof(huobi_trade.price));
+    extract_numeric(msg, len, "\"amount\":", huobi_trade.size, sizeof(huobi_trade.size));
+    extract_numeric(msg, len, "\"ts\":", huobi_trade.timestamp, sizeof(huobi_trade.timestamp));
+    extract_numeric(msg, len, "\"id\":", huobi_trade.trade_id, sizeof(huobi_trade.trade_id));
+
+    /* "direction" is the taker's side; "market_maker" is true when the buyer was the maker, as on Binance */
+    char direction[8] = {0};
+    extract_order_data(msg, len, "\"direction\":\"", direction, sizeof(direction));
+    if (strcmp(direction, "buy") == 0) strcpy(huobi_trade.market_maker, "false");
+    else if (strcmp(direction, "sell") == 0) strcpy(huobi_trade.market_maker, "true");
+
+    char iso_ts[64] = {0};
+    convert_binance_timestamp(iso_ts, sizeof(iso_ts), huobi_trade.timestamp);
+    strncpy(huobi_trade.timestamp, iso_ts, sizeof(huobi_trade.timestamp) - 1);
+
+    cryptofeed_emit_trade(&huobi_trade);
+    // printf("[TRADE] %s | %s | Price: %s | Size: %s | ID: %s\n", huobi_trade.exchange, huobi_trade.currency, huobi_trade.price, huobi_trade.size, huobi_trade.trade_id);
+}
+
+/* Answer a Huobi {"ping": <ts>} with {"pong": <ts>} */
+static int send_huobi_pong(struct lws *wsi, const char *msg, size_t len) {
+    char ping_value[32] = {0};
+    if (!extract_numeric(msg, len, "\"ping\":", ping_value, sizeof(ping_value)))
+        return 0;
+
+    char pong_msg[64];
+    snprintf(pong_msg, sizeof(pong_msg), "{\"pong\": %s}", ping_value);
+    unsigned char *buf = malloc(LWS_PRE + strlen(pong_msg));
+    if (!buf) {
+        printf("[ERROR] Memory allocation failed for Huobi pong\n");
+        return -1;
+    }
+    memcpy(buf + LWS_PRE, pong_msg, strlen(pong_msg));
+    lws_write(wsi, buf + LWS_PRE, strlen(pong_msg), LWS_WRITE_TEXT);
+    // printf("[INFO] Sent Huobi Pong: %s\n", pong_msg);
+
+    free(buf);
+    return 0;
+}
+
+/* Subscribe one Huobi connection: each symbol in its chunk gets its profile's quote channel plus trade.detail */
+static int subscribe_huobi_chunk(struct lws *wsi, int chunk_index) {
+    char filename[64];
+    snprintf(filename, sizeof(filename), "currency_text_files/huobi_currency_chunk_%d.txt", chunk_index);
+
+    FILE *fp = fopen(filename, "r");
+    if (!fp) {
+        fprintf(stderr, "[ERROR] Could not open %s\n", filename);
+        return -1;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    long fsize = ftell(fp);
+    rewind(fp);
+
+    char *file_buf = malloc(fsize + 1);
+    if (!file_buf) {
+        fclose(fp);
+        fprintf(stderr, "[ERROR] Memory allocation failed\n");
+        return -1;
+    }
+
+    fread(file_buf, 1, fsize, fp);
+    file_buf[fsize] = '\0';
+    fclose(fp);
+
+    char *token = strtok(file_buf, "[\", \n]");
+    while (token) {
+        char ticker_msg[128];
+        char trade_msg[128];
+        const char *quote = feed_quote_channel("huobi", get_feed_profile("huobi", token));
+
+        if (quote)
+            snprintf(ticker_msg, sizeof(ticker_msg),
+                     "{\"sub\": \"market.%s.%s\", \"id\": \"huobi_%s_%s\"}",
+                     token, quote, token, quote);
+        snprintf(trade_msg, sizeof(trade_msg),
+                 "{\"sub\": \"market.%s.trade.detail\", \"id\": \"huobi_%s_trade\"}",
+                 token, token);
+
+        for (int i = quote ? 0 : 1; i < 2; i++) {
+            const char *msg = (i == 0) ? ticker_msg : trade_msg;
+            if (queue_ws_text(wsi, msg, strlen(msg)) != 0) {
+                free(file_buf);
+                return -1;
+            }
+        }
+
+        token = strtok(NULL, "[\", \n]");
+    }
+
+    free(file_buf);
+    return 0;
+}
+
+/* Huobi gzips every frame; inflate it, then classify and route as usual */
+static int huobi_on_message(ConnectionSlot *slot, struct lws *wsi, const char *msg, size_t len) {
+    char decompressed[8192];
+    int decompressed_len = decompress_gzip(msg, len, decompressed, sizeof(decompressed));
+    if (decompressed_len <= 0) return 0;
+    // printf("[DATA][Huobi] %.*s\n", decompressed_len, decompressed);
+    return adapter_route_message(slot, wsi, decompressed, (size_t)decompressed_len);
+}
+
+const ExchangeAdapter huobi_adapter = {
+    .display_name = "Huobi",
+    .endpoint = { "huobi", "api.huobi.pro", 443, "/ws", "currency_text_files/huobi_currency_ids.txt",
+                  100, 8, 10, 200, 0 },     // payloads are already gzip
+    .max_connections = 20,
+    .taker_fee_bps = 20,
+    .subscribe = subscribe_huobi_chunk,
+    .on_message = huobi_on_message,
+    .classify = classify_huobi_message,
+    .on_ticker = handle_huobi_ticker,
+    .on_quote = handle_huobi_quote,
+    .on_trade = handle_huobi_trade,
+    .heartbeat = send_huobi_pong,
+    .normalize_symbol = normalize_concatenated_symbol
+};
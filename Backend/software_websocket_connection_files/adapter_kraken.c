@@ -0,0 +1,278 @@
+/*
+ * Kraken Adapter
+ *
+ * Connects to the Kraken v1 public feed and parses ticker, spread and trade
+ * messages.
+ *
+ * Features:
+ *  - One connection; pairs are subscribed in chunks of 100, grouped by the
+ *    quote channel ("ticker" or "spread") their feed profile maps to.
+ *  - Kraken reports BTC as "XBT"; the normalizer maps it back.
+ *
+ * Dependencies:
+ *  - jansson: Pair list and ticker payloads.
+ *  - libwebsockets: Outgoing frames.
+ *
+ * Usage:
+ *  - Registered as `kraken_adapter` in `exchange_adapter.c`.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#include "exchange_adapter.h"
+#include "exchange_websocket.h"
+#include "json_parser.h"
+#include "feed_profiles.h"
+#include "cryptofeed_internal.h"
+#include "utils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+/* Kraken trade message: [channelID, [[price, volume, time, ...], ...], "trade", pair] */
+static void handle_kraken_trade(const char *msg, size_t len) {
+    json_error_t err;
+    json_t *root = json_loadb(msg, len, 0, &err);
+    if (!root) return;
+    if (json_is_array(root) && json_array_size(root) >= 4) {
+        json_t *trades = json_array_get(root, 1);  // array of trades
+        json_t *meta = json_array_get(root, json_array_size(root) - 1);
+        const char *pair = json_string_value(meta);
+        if (json_is_array(trades)) {
+            for (size_t i = 0; i < json_array_size(trades); i++) {
+                json_t *t = json_array_get(trades, i);
+                if (json_is_array(t) && json_array_size(t) >= 3) {
+                    TradeData kraken_trade = {0};
+                    strncpy(kraken_trade.exchange, "Kraken", sizeof(kraken_trade.exchange) - 1);
+                    if (pair)
+                        strncpy(kraken_trade.currency, pair, sizeof(kraken_trade.currency) - 1);
+
+                    const char *price = json_string_value(json_array_get(t, 0));
+                    const char *size = json_string_value(json_array_get(t, 1));
+                    const char *time = json_string_value(json_array_get(t, 2));
+                    const char *side = json_string_value(json_array_get(t, 3));     // taker side: "b" / "s"
+
+                    if (price) strncpy(kraken_trade.price, price, sizeof(kraken_trade.price) - 1);
+                    if (size) strncpy(kraken_trade.size, size, sizeof(kraken_trade.size) - 1);
+                    if (time) {
+                        strncpy(kraken_trade.timestamp, time, sizeof(kraken_trade.timestamp) - 1);
+                    } else {
+                        get_timestamp(kraken_trade.timestamp, sizeof(kraken_trade.timestamp));
+                        kraken_trade.local_time = 1;
+                    }
+                    /* "market_maker" is true when the buyer was the maker, as on Binance */
+                    if (side && strcmp(side, "b") == 0) strcpy(kraken_trade.market_maker, "false");
+                    else if (side && strcmp(side, "s") == 0) strcpy(kraken_trade.market_maker, "true");
+
+                    cryptofeed_emit_trade(&kraken_trade);
+                    // printf("[TRADE] %s | %s | Price: %s | Size: %s\n", kraken_trade.exchange, kraken_trade.currency, kraken_trade.price, kraken_trade.size);
+                }
+            }
+        }
+    }
+    json_decref(root);
+}
+
+/* The Kraken pair name is the last quoted string of a channel message */
+static void extract_kraken_pair(const char *msg, size_t len, char *dest, size_t dest_size) {
+    const char *last_quote = msg + len;
+    while (last_quote > msg && *--last_quote != '"') {
+    }
+    if (last_quote > msg) {
+        const char *start = last_quote - 1;
+        while (start > msg && *start != '"') {
+            start--;
+        }
+        start++;
+        size_t currency_len = last_quote - start;
+        if (currency_len < dest_size) {
+            memcpy(dest, start, currency_len);
+            dest[currency_len] = '\0';
+        }
+    }
+}
+
+/* Kraken ticker message: [channelID, {...}, "ticker", pair] */
+static void handle_kraken_ticker(const char *msg, size_t len) {
+    TickerData kraken_ticker = {0};
+    strncpy(kraken_ticker.exchange, "Kraken", MAX_EXCHANGE_NAME_LENGTH - 1);
+    kraken_ticker.exchange[MAX_EXCHANGE_NAME_LENGTH - 1] = '\0';
+
+    json_t *root, *obj, *b, *a, *c, *v, *p, *l, *h, *o;
+    json_error_t err;
+    bool qty_found = true;
+
+    root = json_loadb(msg, len, 0, &err);
+    if (!root) {
+        qty_found = false;
+    }
+    else {
+        if (!json_is_array(root) || json_array_size(root) < 4) {
+            qty_found = false;
+        }
+        else {
+            obj = json_array_get(root, 1);
+            b = json_object_get(obj, "b");
+            a = json_object_get(obj, "a");
+            c = json_object_get(obj, "c");
+            v = json_object_get(obj, "v");
+            p = json_object_get(obj, "p");
+            // t = json_object_get(obj, "t");
+            l = json_object_get(obj, "l");
+            h = json_object_get(obj, "h");
+            o = json_object_get(obj, "o");
+
+            if  (json_is_string(json_array_get(b, 0)))
+                strncpy(kraken_ticker.bid,        json_string_value(json_array_get(b, 0)), sizeof(kraken_ticker.bid) - 1);
+            if  (json_is_string(json_array_get(a, 0)))
+                strncpy(kraken_ticker.ask,        json_string_value(json_array_get(a, 0)), sizeof(kraken_ticker.ask) - 1);
+            if  (json_is_string(json_array_get(b, 1)))
+                strncpy(kraken_ticker.bid_whole,  json_string_value(json_array_get(b, 1)), sizeof(kraken_ticker.bid_whole) - 1);
+            if  (json_is_string(json_array_get(b, 2)))
+                strncpy(kraken_ticker.bid_qty,    json_string_value(json_array_get(b, 2)), sizeof(kraken_ticker.bid_qty) - 1);
+            if  (json_is_string(json_array_get(a, 1)))
+                strncpy(kraken_ticker.ask_whole,  json_string_value(json_array_get(a, 1)), sizeof(kraken_ticker.ask_whole) - 1);
+            if  (json_is_string(json_array_get(a, 2)))
+                strncpy(kraken_ticker.ask_qty,    json_string_value(json_array_get(a, 2)), sizeof(kraken_ticker.ask_qty) - 1);
+            if  (json_is_string(json_array_get(c, 0)))
+                strncpy(kraken_ticker.price,      json_string_value(json_array_get(c, 0)), sizeof(kraken_ticker.price) - 1);
+            if  (json_is_string(json_array_get(c, 1)))
+                strncpy(kraken_ticker.last_vol,   json_string_value(json_array_get(c, 1)), sizeof(kraken_ticker.last_vol) - 1);
+            if  (json_is_string(json_array_get(v, 0)))
+                strncpy(kraken_ticker.vol_today,  json_string_value(json_array_get(v, 0)), sizeof(kraken_ticker.vol_today) - 1);
+            if  (json_is_string(json_array_get(v, 1)))
+                strncpy(kraken_ticker.volume_24h,    json_string_value(json_array_get(v, 1)), sizeof(kraken_ticker.volume_24h) - 1);
+            if  (json_is_string(json_array_get(p, 0)))
+                strncpy(kraken_ticker.vwap_today, json_string_value(json_array_get(p, 0)), sizeof(kraken_ticker.vwap_today) - 1);
+            if  (json_is_string(json_array_get(p, 1)))
+                strncpy(kraken_ticker.vwap_24h,   json_string_value(json_array_get(p, 1)), sizeof(kraken_ticker.vwap_24h) - 1);
+            if  (json_is_string(json_array_get(l, 0)))
+                strncpy(kraken_ticker.low_today,  json_string_value(json_array_get(l, 0)), sizeof(kraken_ticker.low_today) - 1);
+            if  (json_is_string(json_array_get(l, 1)))
+                strncpy(kraken_ticker.low_price,    json_string_value(json_array_get(l, 1)), sizeof(kraken_ticker.low_price) - 1);
+            if  (json_is_string(json_array_get(h, 0)))
+                strncpy(kraken_ticker.high_today, json_string_value(json_array_get(h, 0)), sizeof(kraken_ticker.high_today) - 1);
+            if  (json_is_string(json_array_get(h, 1)))
+                strncpy(kraken_ticker.high_price,   json_string_value(json_array_get(h, 1)), sizeof(kraken_ticker.high_price) - 1);
+            if  (json_is_string(json_object_get(o, "o")))
+                strncpy(kraken_ticker.open_today, json_string_value(json_object_get(o, "o")), sizeof(kraken_ticker.open_today) - 1);
+
+        }
+        json_decref(root);
+    }
+    if (extract_order_data(msg, len, "\"c\":[\"", kraken_ticker.price, sizeof(kraken_ticker.price)) &&
+        qty_found ) {
+        extract_kraken_pair(msg, len, kraken_ticker.currency, sizeof(kraken_ticker.currency));
+        // Kraken tickers carry no event time
+        get_timestamp(kraken_ticker.timestamp, sizeof(kraken_ticker.timestamp));
+        kraken_ticker.local_time = 1;
+        cryptofeed_emit_ticker(&kraken_ticker);
+    }
+}
+
+/* Kraken spread message: [channelID, [bid, ask, time, bidVolume, askVolume], "spread", pair] */
+static void handle_kraken_quote(const char *msg, size_t len) {
+    TickerData kraken_quote = {0};
+    strncpy(kraken_quote.exchange, "Kraken", MAX_EXCHANGE_NAME_LENGTH - 1);
+    kraken_quote.exchange[MAX_EXCHANGE_NAME_LENGTH - 1] = '\0';
+
+    if (extract_array_field(msg, len, ",[", kraken_quote.bid, sizeof(kraken_quote.bid), 0) &&
+        extract_array_field(msg, len, ",[", kraken_quote.ask, sizeof(kraken_quote.ask), 1)) {
+
+        extract_array_field(msg, len, ",[", kraken_quote.bid_qty, sizeof(kraken_quote.bid_qty), 3);
+        extract_array_field(msg, len, ",[", kraken_quote.ask_qty, sizeof(kraken_quote.ask_qty), 4);
+        extract_kraken_pair(msg, len, kraken_quote.currency, sizeof(kraken_quote.currency));
+
+        // Spread time is "seconds.fraction", parsed by timestamp_to_ms()
+        if (!extract_array_field(msg, len, ",[", kraken_quote.timestamp, sizeof(kraken_quote.timestamp), 2)) {
+            get_timestamp(kraken_quote.timestamp, sizeof(kraken_quote.timestamp));
+            kraken_quote.local_time = 1;
+        }
+        cryptofeed_emit_ticker(&kraken_quote);
+    }
+}
+
+/* Send chunked subscription messages to Kraken using pairs from a JSON file and LWS connection.
+ * Pairs are grouped by the quote channel their feed profile maps to; every pair also gets "trade". */
+static int build_kraken_subscription_from_file(struct lws *wsi, const char *filename, size_t chunk_size) {
+    json_t *pair_array = load_json_array(filename);
+    if (!pair_array) return -1;
+
+    size_t total = json_array_size(pair_array);
+    static const char *channels[] = { "ticker", "spread", "trade" };
+
+    for (size_t i = 0; i < total; i += chunk_size) {
+        size_t end = (i + chunk_size > total) ? total : i + chunk_size;
+
+        for (int c = 0; c < 3; c++) {
+            json_t *chunk = json_array();
+            for (size_t j = i; j < end; j++) {
+                json_t *pair = json_array_get(pair_array, j);
+                const char *quote = feed_quote_channel("kraken", get_feed_profile("kraken", json_string_value(pair)));
+                int wanted = (c == 2) || (quote && strcmp(quote, channels[c]) == 0);
+                if (wanted) json_array_append(chunk, pair);
+            }
+            if (json_array_size(chunk) == 0) {
+                json_decref(chunk);
+                continue;
+            }
+
+            char *pair_list_str = json_dumps(chunk, JSON_ENSURE_ASCII);
+            json_decref(chunk);
+            if (!pair_list_str) {
+                json_decref(pair_array);
+                fprintf(stderr, "[ERROR] Failed to serialize chunk JSON\n");
+                return -1;
+            }
+
+            size_t msg_size = strlen(pair_list_str) + 128;
+            char *subscribe_msg = malloc(msg_size);
+            if (!subscribe_msg) {
+                free(pair_list_str);
+                json_decref(pair_array);
+                fprintf(stderr, "[ERROR] Memory allocation failed for subscribe_msg\n");
+                return -1;
+            }
+
+            int len = snprintf(subscribe_msg, msg_size,
+                "{\"event\": \"subscribe\", \"pair\": %s, \"subscription\": {\"name\": \"%s\"}}",
+                pair_list_str, channels[c]);
+            free(pair_list_str);
+
+            if (queue_ws_text(wsi, subscribe_msg, (size_t)len) != 0) {
+                fprintf(stderr, "[ERROR] Failed to send %s subscription\n", channels[c]);
+                free(subscribe_msg);
+                json_decref(pair_array);
+                return -1;
+            }
+
+            // printf("[DEBUG] Sent Kraken %s chunk: %s\n", channels[c], subscribe_msg);
+            free(subscribe_msg);
+        }
+    }
+
+    json_decref(pair_array);
+    return 0;
+}
+
+static int subscribe_kraken(struct lws *wsi, int chunk_index) {
+    (void)chunk_index;      // single connection; the orchestrator's token bucket spaces out (re)connects
+    return build_kraken_subscription_from_file(wsi, "currency_text_files/kraken_currency_ids.txt", 100);
+}
+
+const ExchangeAdapter kraken_adapter = {
+    .display_name = "Kraken",
+    .endpoint = { "kraken", "ws.kraken.com", 443, "/", NULL, 0, 1, 1, 1000, 0 },
+    .max_connections = 1,
+    .taker_fee_bps = 40,
+    .subscribe = subscribe_kraken,
+    .on_message = adapter_route_message,
+    .classify = classify_kraken_message,
+    .on_ticker = handle_kraken_ticker,
+    .on_quote = handle_kraken_quote,
+    .on_trade = handle_kraken_trade,
+    .normalize_symbol = normalize_separated_symbol
+};
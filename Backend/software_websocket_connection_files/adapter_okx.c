@@ -0,0 +1,161 @@
+/*
+ * OKX Adapter
+ *
+ * Connects to the OKX v5 public feed and parses tickers, bbo-tbt and trades
+ * pushes.
+ *
+ * Features:
+ *  - One connection per 100-instrument chunk file.
+ *  - Each instrument gets its feed profile's quote channel plus "trades".
+ *
+ * Dependencies:
+ *  - jansson: Instrument list and subscription request.
+ *  - libwebsockets: Outgoing frames.
+ *
+ * Usage:
+ *  - Registered as `okx_adapter` in `exchange_adapter.c`.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#include "exchange_adapter.h"
+#include "exchange_websocket.h"
+#include "json_parser.h"
+#include "feed_profiles.h"
+#include "cryptofeed_internal.h"
+#include "utils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* OKX tickers push */
+static void handle_okx_ticker(const char *msg, size_t len) {
+    TickerData okx_ticker = {0};
+    strncpy(okx_ticker.exchange, "OKX", MAX_EXCHANGE_NAME_LENGTH - 1);
+    okx_ticker.exchange[MAX_EXCHANGE_NAME_LENGTH - 1] = '\0';
+
+    if (extract_order_data(msg, len, "\"last\":\"", okx_ticker.price, sizeof(okx_ticker.price)) &&
+        extract_order_data(msg, len, "\"instId\":\"", okx_ticker.currency, sizeof(okx_ticker.currency))) {
+
+        extract_order_data(msg, len, "\"bidPx\":\"", okx_ticker.bid, sizeof(okx_ticker.bid));
+        extract_order_data(msg, len, "\"bidSz\":\"", okx_ticker.bid_qty, sizeof(okx_ticker.bid_qty));
+        extract_order_data(msg, len, "\"askPx\":\"", okx_ticker.ask, sizeof(okx_ticker.ask));
+        extract_order_data(msg, len, "\"askSz\":\"", okx_ticker.ask_qty, sizeof(okx_ticker.ask_qty));
+
+        extract_order_data(msg, len, "\"open24h\":\"", okx_ticker.open_price, sizeof(okx_ticker.open_price));
+        extract_order_data(msg, len, "\"high24h\":\"", okx_ticker.high_price, sizeof(okx_ticker.high_price));
+        extract_order_data(msg, len, "\"low24h\":\"", okx_ticker.low_price, sizeof(okx_ticker.low_price));
+        extract_order_data(msg, len, "\"vol24h\":\"", okx_ticker.volume_24h, sizeof(okx_ticker.volume_24h));
+
+        if (!extract_order_data(msg, len, "\"ts\":\"", okx_ticker.timestamp, sizeof(okx_ticker.timestamp))) {
+            get_timestamp(okx_ticker.timestamp, sizeof(okx_ticker.timestamp));
+            okx_ticker.local_time = 1;
+        }
+
+        cryptofeed_emit_ticker(&okx_ticker);
+    }
+}
+
+/* OKX bbo-tbt push: one level of asks/bids as [price, size, "0", orders] */
+static void handle_okx_quote(const char *msg, size_t len) {
+    TickerData okx_quote = {0};
+    strncpy(okx_quote.exchange, "OKX", MAX_EXCHANGE_NAME_LENGTH - 1);
+    okx_quote.exchange[MAX_EXCHANGE_NAME_LENGTH - 1] = '\0';
+
+    if (extract_order_data(msg, len, "\"instId\":\"", okx_quote.currency, sizeof(okx_quote.currency)) &&
+        extract_array_field(msg, len, "\"bids\":[[", okx_quote.bid, sizeof(okx_quote.bid), 0) &&
+        extract_array_field(msg, len, "\"asks\":[[", okx_quote.ask, sizeof(okx_quote.ask), 0)) {
+
+        extract_array_field(msg, len, "\"bids\":[[", okx_quote.bid_qty, sizeof(okx_quote.bid_qty), 1);
+        extract_array_field(msg, len, "\"asks\":[[", okx_quote.ask_qty, sizeof(okx_quote.ask_qty), 1);
+        extract_order_data(msg, len, "\"seqId\":", okx_quote.sequence, sizeof(okx_quote.sequence));
+
+        if (!extract_order_data(msg, len, "\"ts\":\"", okx_quote.timestamp, sizeof(okx_quote.timestamp))) {
+            get_timestamp(okx_quote.timestamp, sizeof(okx_quote.timestamp));
+            okx_quote.local_time = 1;
+        }
+
+        cryptofeed_emit_ticker(&okx_quote);
+    }
+}
+
+/* OKX trades push */
+static void handle_okx_trade(const char *msg, size_t len) {
+    TradeData okx_trade = {0};
+    strncpy(okx_trade.exchange, "OKX", sizeof(okx_trade.exchange) - 1);
+
+    if (extract_order_data(msg, len, "\"px\":\"", okx_trade.price, sizeof(okx_trade.price)) &&
+        extract_order_data(msg, len, "\"instId\":\"", okx_trade.currency, sizeof(okx_trade.currency))) {
+
+        if (!extract_order_data(msg, len, "\"ts\":\"", okx_trade.timestamp, sizeof(okx_trade.timestamp))) {
+            get_timestamp(okx_trade.timestamp, sizeof(okx_trade.timestamp));
+            okx_trade.local_time = 1;
+        }
+        extract_order_data(msg, len, "\"tradeId\":\"", okx_trade.trade_id, sizeof(okx_trade.trade_id));
+        extract_order_data(msg, len, "\"sz\":\"", okx_trade.size, sizeof(okx_trade.size));
+
+        /* "side" is the taker's side; "market_maker" is true when the buyer was the maker, as on Binance */
+        char side[8] = {0};
+        extract_order_data(msg, len, "\"side\":\"", side, sizeof(side));
+        if (strcmp(side, "buy") == 0) strcpy(okx_trade.market_maker, "false");
+        else if (strcmp(side, "sell") == 0) strcpy(okx_trade.market_maker, "true");
+
+        cryptofeed_emit_trade(&okx_trade);
+        // printf("[TRADE] %s | %s | Price: %s | Size: %s | Time: %s\n", okx_trade.exchange, okx_trade.currency, okx_trade.price, okx_trade.size, okx_trade.timestamp);
+    }
+}
+
+/* Subscribe one OKX connection: each instrument in its chunk gets its profile's quote channel plus "trades" */
+static int subscribe_okx_chunk(struct lws *wsi, int chunk_index) {
+    char filename[64];
+    snprintf(filename, sizeof(filename), "currency_text_files/okx_currency_chunk_%d.txt", chunk_index);
+
+    json_t *entries = load_json_array(filename);
+    if (!entries) return -1;
+
+    json_t *args = json_array();
+    size_t index;
+    json_t *entry;
+    json_array_foreach(entries, index, entry) {
+        const char *inst_id = json_string_value(json_object_get(entry, "instId"));
+        if (!inst_id) continue;
+
+        const char *quote = feed_quote_channel("okx", get_feed_profile("okx", inst_id));
+        if (quote)
+            json_array_append_new(args, json_pack("{s:s, s:s}", "channel", quote, "instId", inst_id));
+        json_array_append_new(args, json_pack("{s:s, s:s}", "channel", "trades", "instId", inst_id));
+    }
+    json_decref(entries);
+
+    json_t *request = json_pack("{s:s, s:o}", "op", "subscribe", "args", args);
+    char *subscribe_msg = json_dumps(request, JSON_COMPACT);
+    json_decref(request);
+    if (!subscribe_msg) {
+        fprintf(stderr, "[ERROR] Failed to serialize OKX subscription\n");
+        return -1;
+    }
+
+    // printf("[DEBUG] OKX Subscription Message:\n%s\n", subscribe_msg);
+    int result = send_ws_text(wsi, subscribe_msg, strlen(subscribe_msg));
+    free(subscribe_msg);
+    if (result == 0)
+        printf("[INFO] Sent subscription message to okx-websocket-%d\n", chunk_index);
+    return result;
+}
+
+const ExchangeAdapter okx_adapter = {
+    .display_name = "OKX",
+    .endpoint = { "okx", "ws.okx.com", 8443, "/ws/v5/public", "currency_text_files/okx_currency_ids.txt",
+                  100, 8, 3, 334, 1 },
+    .max_connections = 8,
+    .taker_fee_bps = 10,
+    .subscribe = subscribe_okx_chunk,
+    .on_message = adapter_route_message,
+    .classify = classify_okx_message,
+    .on_ticker = handle_okx_ticker,
+    .on_quote = handle_okx_quote,
+    .on_trade = handle_okx_trade,
+    .normalize_symbol = normalize_separated_symbol
+};
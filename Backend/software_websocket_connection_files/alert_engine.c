@@ -0,0 +1,436 @@
+/*
+ * Alert Engine
+ *
+ * Implements the rule-based alerts of `alert_engine.h`. A compiled
+ * `RuleSet` is immutable once built: the loader thread builds a new one
+ * and hands it over through `pending`, and only the service thread ever
+ * reads the active set, so evaluation takes no locks.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#include "alert_engine.h"
+#include "symbol_registry.h"
+#include "exchange_adapter.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <math.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+enum { METRIC_PRICE = 0, METRIC_USD, METRIC_SPREAD, METRIC_SIZE, ALERT_METRICS };
+enum { ALERT_ABOVE = 0, ALERT_BELOW };
+
+static const char *metric_names[ALERT_METRICS] = { "price", "usd", "spread", "size" };
+static const char *direction_names[2] = { "above", "below" };
+
+typedef struct {
+    int venue;                              // adapter index, -1 = any venue
+    char pair[MARKET_RECORD_SYMBOL_LEN];
+    int start[ALERT_METRICS][2];            // rule range per (metric, direction)
+    int end[ALERT_METRICS][2];
+} RuleGroup;
+
+typedef struct {
+    int count;
+    double *threshold;                      // ascending within each (group, metric, direction)
+    int *line;                              // rule id: its line in the rules file
+    int64_t *fired_ns;
+    int group_count;
+    RuleGroup *groups;
+    int *index;                             // (venue, pair) -> group + 1
+    int index_slots;                        // power of two
+    int generation;
+} RuleSet;
+
+typedef struct {
+    int venue;
+    char pair[MARKET_RECORD_SYMBOL_LEN];
+    int metric;
+    int direction;
+    double threshold;
+    int line;
+} ParsedRule;
+
+static RuleSet *rules = NULL;               // active set, service thread only
+static RuleSet *pending = NULL;             // built by the loader, taken by alert_engine_poll()
+static int loading = 0;
+static int generation = 0;
+
+static char rules_path[256];
+static struct timespec rules_mtime;
+static off_t rules_size = -1;
+
+/* Per registry id: groups bound under `bound_generation`, and the previous value of each metric */
+static int bound_generation[SYMBOL_REGISTRY_MAX];
+static int bound[SYMBOL_REGISTRY_MAX][2];
+static double previous[SYMBOL_REGISTRY_MAX][ALERT_METRICS];
+
+static FILE *sink = NULL;
+static int started = 0;
+static int64_t next_poll_ns = 0, next_report_ns = 0;
+static unsigned long long fired = 0, suppressed = 0;
+
+static int64_t realtime_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static uint32_t group_hash(int venue, const char *pair) {
+    uint32_t h = 2166136261u ^ (uint32_t)(venue + 1);
+    for (const char *p = pair; *p; p++) h = (h ^ (uint8_t)*p) * 16777619u;
+    return h;
+}
+
+static void free_rule_set(RuleSet *set) {
+    if (!set) return;
+    free(set->threshold);
+    free(set->line);
+    free(set->fired_ns);
+    free(set->groups);
+    free(set->index);
+    free(set);
+}
+
+static int venue_index(const char *exchange) {
+    const ExchangeAdapter *adapter = find_exchange_adapter(exchange);
+    for (int i = 0; adapter && i < exchange_adapter_count; i++)
+        if (exchange_adapters[i] == adapter) return i;
+    return -1;
+}
+
+/* "BTC-USD", "XBT/USD" or a venue spelling such as "btcusdt" -> "BTC-USD" / "BTC-USDT" */
+static int rule_pair(const char *exchange, const char *symbol, char *dest, size_t dest_size) {
+    if (strpbrk(symbol, "-/:_")) return normalize_separated_symbol(symbol, dest, dest_size);
+    if (strcmp(exchange, "*") != 0) return exchange_normalize_symbol(exchange, symbol, dest, dest_size);
+    return normalize_concatenated_symbol(symbol, dest, dest_size);
+}
+
+static int parse_metric(const char *name) {
+    for (int m = 0; m < ALERT_METRICS; m++)
+        if (strcasecmp(name, metric_names[m]) == 0) return m;
+    return -1;
+}
+
+static int compare_rules(const void *a, const void *b) {
+    const ParsedRule *x = a, *y = b;
+    int c = strcmp(x->pair, y->pair);
+    if (c) return c;
+    if (x->venue != y->venue) return x->venue < y->venue ? -1 : 1;
+    if (x->metric != y->metric) return x->metric - y->metric;
+    if (x->direction != y->direction) return x->direction - y->direction;
+    return (x->threshold > y->threshold) - (x->threshold < y->threshold);
+}
+
+/* Parse one rule line; returns 1 for a rule, 0 for a blank or comment line, -1 on a malformed line,
+ * -2 for "size below" */
+static int parse_rule(char *line, ParsedRule *rule) {
+    char *comment = strchr(line, '#');
+    if (comment) *comment = '\0';
+
+    char exchange[16], symbol[32], metric[16], direction[16], threshold[32];
+    int fields = sscanf(line, "%15s %31s %15s %15s %31s", exchange, symbol, metric, direction, threshold);
+    if (fields <= 0) return 0;
+    if (fields != 5) return -1;
+
+    char *end;
+    rule->threshold = strtod(threshold, &end);
+    rule->metric = parse_metric(metric);
+    rule->direction = strcasecmp(direction, "above") == 0 ? ALERT_ABOVE :
+                      strcasecmp(direction, "below") == 0 ? ALERT_BELOW : -1;
+    rule->venue = strcmp(exchange, "*") == 0 ? -1 : venue_index(exchange);
+    if (*end || !isfinite(rule->threshold) || rule->metric < 0 || rule->direction < 0 ||
+        (rule->venue < 0 && strcmp(exchange, "*") != 0))
+        return -1;
+    /* Each trade's size is compared with 0, never with the previous trade, so it can only cross upwards */
+    if (rule->metric == METRIC_SIZE && rule->direction == ALERT_BELOW) return -2;
+    return rule_pair(exchange, symbol, rule->pair, sizeof(rule->pair)) ? 1 : -1;
+}
+
+/* Sorted rules -> groups, threshold arrays and the (venue, pair) index */
+static RuleSet *build_rule_set(const ParsedRule *parsed, int count) {
+    RuleSet *set = calloc(1, sizeof(RuleSet));
+    if (!set) return NULL;
+
+    int groups = 0;
+    for (int i = 0; i < count; i++)
+        if (i == 0 || parsed[i].venue != parsed[i - 1].venue || strcmp(parsed[i].pair, parsed[i - 1].pair) != 0)
+            groups++;
+
+    set->index_slots = 16;
+    while (set->index_slots < 2 * groups) set->index_slots <<= 1;
+    set->threshold = malloc(sizeof(double) * (count ? count : 1));
+    set->line = malloc(sizeof(int) * (count ? count : 1));
+    set->fired_ns = calloc(count ? count : 1, sizeof(int64_t));
+    set->groups = calloc(groups ? groups : 1, sizeof(RuleGroup));
+    set->index = calloc(set->index_slots, sizeof(int));
+    if (!set->threshold || !set->line || !set->fired_ns || !set->groups || !set->index) {
+        free_rule_set(set);
+        return NULL;
+    }
+
+    RuleGroup *group = NULL;
+    for (int i = 0; i < count; i++) {
+        const ParsedRule *r = &parsed[i];
+        int new_range = !group || r->metric != parsed[i - 1].metric || r->direction != parsed[i - 1].direction;
+        if (!group || r->venue != group->venue || strcmp(r->pair, group->pair) != 0) {
+            new_range = 1;
+            group = &set->groups[set->group_count];
+            group->venue = r->venue;
+            snprintf(group->pair, sizeof(group->pair), "%s", r->pair);
+
+            uint32_t mask = set->index_slots - 1;
+            uint32_t slot = group_hash(r->venue, r->pair) & mask;
+            while (set->index[slot]) slot = (slot + 1) & mask;
+            set->index[slot] = ++set->group_count;
+        }
+        if (new_range) group->start[r->metric][r->direction] = i;
+        group->end[r->metric][r->direction] = i + 1;
+        set->threshold[i] = r->threshold;
+        set->line[i] = r->line;
+    }
+    set->count = count;
+    return set;
+}
+
+/* Read and compile a rules file; NULL if it cannot be read or has errors */
+static RuleSet *compile_rules(const char *path) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) return NULL;
+
+    ParsedRule *parsed = NULL;
+    int count = 0, capacity = 0, line_no = 0, failed = 0;
+    char line[256];
+    while (fgets(line, sizeof(line), fp)) {
+        line_no++;
+        if (count == capacity) {
+            if (capacity == ALERT_MAX_RULES) {
+                printf("[WARNING] %s: more than %d rules, ignoring the rest\n", path, ALERT_MAX_RULES);
+                break;
+            }
+            capacity = capacity ? capacity * 2 : 1024;
+            ParsedRule *grown = realloc(parsed, sizeof(ParsedRule) * capacity);
+            if (!grown) {
+                printf("[ERROR] Out of memory loading %s\n", path);
+                failed = 1;
+                break;
+            }
+            parsed = grown;
+        }
+
+        int result = parse_rule(line, &parsed[count]);
+        if (result == -2) {
+            printf("[ERROR] %s:%d: \"size below\" is not supported, size rules fire on single trades above a threshold\n",
+                   path, line_no);
+            failed = 1;
+            break;
+        }
+        if (result < 0) {
+            printf("[ERROR] %s:%d: expected \"<exchange|*> <symbol> <price|usd|spread|size> <above|below> <threshold>\"\n",
+                   path, line_no);
+            failed = 1;
+            break;
+        }
+        if (result > 0) parsed[count++].line = line_no;
+    }
+    fclose(fp);
+
+    RuleSet *set = NULL;
+    if (!failed) {
+        qsort(parsed, count, sizeof(ParsedRule), compare_rules);
+        set = build_rule_set(parsed, count);
+    }
+    free(parsed);
+    return set;
+}
+
+static void *loader_thread(void *arg) {
+    (void)arg;
+    RuleSet *set = compile_rules(rules_path);
+    if (!set) printf("[WARNING] Keeping the previous alert rules\n");
+    __atomic_store_n(&pending, set, __ATOMIC_RELEASE);
+    __atomic_store_n(&loading, 0, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+static void activate(RuleSet *set) {
+    free_rule_set(rules);
+    set->generation = ++generation;
+    rules = set;
+    printf("[INFO] Loaded %d alert rules in %d (venue, pair) groups from %s\n", set->count, set->group_count, rules_path);
+}
+
+/* Start a background reload when the file's mtime or size changed */
+static void check_rules_file() {
+    struct stat st;
+    if (stat(rules_path, &st) != 0) return;
+    if (st.st_size == rules_size && st.st_mtim.tv_sec == rules_mtime.tv_sec &&
+        st.st_mtim.tv_nsec == rules_mtime.tv_nsec)
+        return;
+
+    rules_mtime = st.st_mtim;
+    rules_size = st.st_size;
+    __atomic_store_n(&loading, 1, __ATOMIC_RELEASE);
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, loader_thread, NULL) != 0) {
+        printf("[ERROR] Failed to start the alert rules loader\n");
+        __atomic_store_n(&loading, 0, __ATOMIC_RELEASE);
+        return;
+    }
+    pthread_detach(thread);
+}
+
+static int group_for(const RuleSet *set, int venue, const char *pair) {
+    uint32_t mask = set->index_slots - 1;
+    for (uint32_t slot = group_hash(venue, pair) & mask; set->index[slot]; slot = (slot + 1) & mask) {
+        const RuleGroup *group = &set->groups[set->index[slot] - 1];
+        if (group->venue == venue && strcmp(group->pair, pair) == 0) return set->index[slot] - 1;
+    }
+    return -1;
+}
+
+/* First index in [lo, hi) whose threshold is >= value (strict = 0) or > value (strict = 1) */
+static int search(const double *threshold, int lo, int hi, double value, int strict) {
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (threshold[mid] < value || (strict && threshold[mid] == value)) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+static void fire(int rule, const RuleGroup *group, const MarketRecord *record, int metric, int direction, double value) {
+    int64_t now = record->recv_ns;
+    if (rules->fired_ns[rule] && now - rules->fired_ns[rule] < (int64_t)ALERT_COOLDOWN_MS * 1000000) {
+        suppressed++;
+        return;
+    }
+    rules->fired_ns[rule] = now;
+    fired++;
+
+    if (sink)
+        fprintf(sink, "{\"time_ms\":%lld,\"rule\":%d,\"exchange\":\"%s\",\"symbol\":\"%s\",\"pair\":\"%s\","
+                "\"metric\":\"%s\",\"condition\":\"%s\",\"threshold\":%.10g,\"value\":%.10g}\n",
+                (long long)(now / 1000000), rules->line[rule], record->exchange, record->symbol, group->pair,
+                metric_names[metric], direction_names[direction], rules->threshold[rule], value);
+}
+
+int alert_engine_start(const char *rules_file) {
+    snprintf(rules_path, sizeof(rules_path), "%s", rules_file ? rules_file : ALERT_RULES_FILE);
+    for (int id = 0; id < SYMBOL_REGISTRY_MAX; id++)
+        for (int m = 0; m < ALERT_METRICS; m++) previous[id][m] = NAN;
+    memset(bound_generation, 0, sizeof(bound_generation));
+
+    struct stat st;
+    if (stat(rules_path, &st) == 0) {
+        rules_mtime = st.st_mtim;
+        rules_size = st.st_size;
+        RuleSet *set = compile_rules(rules_path);
+        if (set) activate(set);
+        else printf("[WARNING] No alert rules active until %s is fixed\n", rules_path);
+    } else {
+        printf("[INFO] No %s found, alerts start when it appears\n", rules_path);
+    }
+
+    sink = fopen(ALERT_OUTPUT_FILE, "a");
+    if (!sink)
+        printf("[WARNING] Failed to open %s (%s), alerts are only counted\n", ALERT_OUTPUT_FILE, strerror(errno));
+    started = 1;
+    return 0;
+}
+
+void alert_engine_check(int id, const MarketRecord *record, double usd_price) {
+    if (!started || id < 0) return;
+
+    double value[ALERT_METRICS];
+    value[METRIC_PRICE] = record->price > 0 ? record->price : NAN;
+    value[METRIC_USD] = usd_price > 0 ? usd_price : NAN;
+    value[METRIC_SPREAD] = (record->bid > 0 && record->ask > 0) ?
+                           (record->ask - record->bid) / ((record->ask + record->bid) / 2) * 100.0 : NAN;
+    value[METRIC_SIZE] = (record->kind == MARKET_RECORD_TRADE && record->size > 0) ? record->size : NAN;
+
+    const RuleSet *set = rules;
+    if (set && bound_generation[id] != set->generation) {
+        const SymbolInfo *info = symbol_registry_info(id);
+        const char *pair = info->pair >= 0 ? symbol_registry_pair(info->pair)->name : NULL;
+        bound[id][0] = pair ? group_for(set, -1, pair) : -1;
+        bound[id][1] = (pair && info->venue >= 0) ? group_for(set, info->venue, pair) : -1;
+        bound_generation[id] = set->generation;
+    }
+
+    for (int m = 0; m < ALERT_METRICS; m++) {
+        double v = value[m];
+        if (isnan(v)) continue;
+        /* Each trade's size stands alone; the other metrics fire on crossing from the previous value */
+        double prev = m == METRIC_SIZE ? 0.0 : previous[id][m];
+        if (m != METRIC_SIZE) previous[id][m] = v;
+        if (!set || isnan(prev) || v == prev) continue;
+
+        for (int b = 0; b < 2; b++) {
+            if (bound[id][b] < 0) continue;
+            const RuleGroup *group = &set->groups[bound[id][b]];
+            if (v > prev) {
+                /* above: prev <= threshold < v */
+                int lo = group->start[m][ALERT_ABOVE], hi = group->end[m][ALERT_ABOVE];
+                int first = search(set->threshold, lo, hi, prev, 0);
+                int last = search(set->threshold, first, hi, v, 0);
+                for (int r = first; r < last; r++) fire(r, group, record, m, ALERT_ABOVE, v);
+            } else {
+                /* below: v < threshold <= prev */
+                int lo = group->start[m][ALERT_BELOW], hi = group->end[m][ALERT_BELOW];
+                int first = search(set->threshold, lo, hi, v, 1);
+                int last = search(set->threshold, first, hi, prev, 1);
+                for (int r = first; r < last; r++) fire(r, group, record, m, ALERT_BELOW, v);
+            }
+        }
+    }
+}
+
+static void report(int64_t now) {
+    printf("[STATS] alerts: %d rules, %llu fired, %llu held back by the cooldown over the last %d s\n",
+           rules ? rules->count : 0, fired, suppressed, ALERT_REPORT_MS / 1000);
+    fired = suppressed = 0;
+    next_report_ns = now + (int64_t)ALERT_REPORT_MS * 1000000;
+}
+
+void alert_engine_poll() {
+    if (!started) return;
+    int64_t now = realtime_ns();
+    if (now < next_poll_ns) return;
+    next_poll_ns = now + (int64_t)ALERT_RELOAD_MS * 1000000;
+
+    if (!__atomic_load_n(&loading, __ATOMIC_ACQUIRE)) {
+        RuleSet *set = __atomic_exchange_n(&pending, NULL, __ATOMIC_ACQ_REL);
+        if (set) activate(set);
+        check_rules_file();
+    }
+
+    if (sink) fflush(sink);
+    if (!next_report_ns) next_report_ns = now + (int64_t)ALERT_REPORT_MS * 1000000;
+    else if (now >= next_report_ns) report(now);
+}
+
+void alert_engine_stop() {
+    if (!started) return;
+    /* A reload still in flight owns `pending` until it clears `loading` */
+    while (__atomic_load_n(&loading, __ATOMIC_ACQUIRE)) {
+        struct timespec pause = { 0, 1000000 };
+        nanosleep(&pause, NULL);
+    }
+    free_rule_set(__atomic_exchange_n(&pending, NULL, __ATOMIC_ACQ_REL));
+
+    report(realtime_ns());
+    free_rule_set(rules);
+    rules = NULL;
+    if (sink) fclose(sink);
+    sink = NULL;
+    started = 0;
+}
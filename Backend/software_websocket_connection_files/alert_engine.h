@@ -0,0 +1,67 @@
+/*
+ * Alert Engine Header
+ *
+ * Declares the rule-based price alerts: rules such as "BTC-USD price
+ * above 70000 on any venue" or "spread above 1% on Kraken" are evaluated
+ * against every clean record, and each crossing is written to a local sink.
+ *
+ * Features:
+ *  - Rules are read from ALERT_RULES_FILE, one per line:
+ *        <exchange|*> <symbol> <metric> <above|below> <threshold>
+ *    Metrics: `price` (last price), `usd` (last price in USD through the
+ *    currency graph), `spread` (% of mid) and `size` (one trade's size).
+ *    Symbols are normalized ("XBT/USD" and "BTCUSDT" become "BTC-USD" and
+ *    "BTC-USDT"), so one "*" rule covers every venue listing the pair.
+ *  - Rules are compiled into groups per (venue or any, pair); within a
+ *    group, each (metric, direction) is a sorted threshold array. A
+ *    record's symbol id binds to at most two groups once per rule set.
+ *  - A tick binary-searches the thresholds between the previous and the
+ *    new value of each metric, so it only touches rules that were actually
+ *    crossed: O(log rules + fired). `above` fires when the value moves
+ *    from at or below the threshold to above it; `below` mirrors that.
+ *    `size` compares each trade on its own and only supports `above`.
+ *  - A rule fires at most once per ALERT_COOLDOWN_MS.
+ *  - Hot reload: the file's mtime is checked every ALERT_RELOAD_MS. A
+ *    changed file is parsed and compiled on a helper thread, and the new
+ *    rule set is swapped in on the service thread, so ingest never waits
+ *    for a parse. A file with errors keeps the previous rules.
+ *  - Alerts are appended to ALERT_OUTPUT_FILE, one JSON object per line.
+ *
+ * Dependencies:
+ *  - symbol_registry.h, exchange_adapter.h (symbol normalization),
+ *    market_record.h, pthreads.
+ *
+ * Usage:
+ *  - `cryptofeed.c` (or the supervisor's aggregator) calls
+ *    `alert_engine_check()` for each clean record and `alert_engine_poll()`
+ *    after every service pass. Service thread only, except the loader.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#ifndef ALERT_ENGINE_H
+#define ALERT_ENGINE_H
+
+#include "market_record.h"
+
+#define ALERT_RULES_FILE "alert_rules.conf"
+#define ALERT_OUTPUT_FILE "alerts_output_data.json"
+#define ALERT_MAX_RULES (1 << 21)
+#define ALERT_COOLDOWN_MS 10000             // minimum time between two firings of one rule
+#define ALERT_RELOAD_MS 1000                // rules file mtime check interval
+#define ALERT_REPORT_MS 60000
+
+/* Load `rules_file` (NULL = ALERT_RULES_FILE) and open the sink; a missing file means no rules until it appears */
+int alert_engine_start(const char *rules_file);
+
+/* Evaluate the rules of registry id `id` against a clean record; `usd_price` is its price in USD (0 = unknown) */
+void alert_engine_check(int id, const MarketRecord *record, double usd_price);
+
+/* Swap in reloaded rules, start a reload if the file changed, flush the sink and report */
+void alert_engine_poll();
+
+/* Report totals, close the sink and free the rules */
+void alert_engine_stop();
+
+#endif // ALERT_ENGINE_H
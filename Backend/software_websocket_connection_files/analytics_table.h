@@ -0,0 +1,193 @@
+/*
+ * Analytics Table Header
+ *
+ * Declares the shared-memory table of rolling trade analytics the collector
+ * publishes for co-located consumers, and a header-only reader API for them.
+ *
+ * Features:
+ *  - One 384-byte, cache-line-aligned slot per (exchange, symbol) holding
+ *    the last trade price and, for each window (1m, 5m, 15m, 1h): VWAP,
+ *    realized volatility, volume, trade count, average trade size,
+ *    buy/sell volume and imbalance, and the window's opening price.
+ *  - Same seqlock and hashing scheme as `quote_table.h`: the collector
+ *    never blocks, readers retry if they raced with an update.
+ *  - A slot is rewritten after every trade of its symbol and once a second
+ *    while its windows still hold trades, so idle symbols age out.
+ *
+ * Dependencies:
+ *  - POSIX shared memory (sys/mman.h, fcntl.h); GCC/Clang `__atomic` builtins.
+ *
+ * Usage:
+ *  - Written by the collector through `trade_analytics.c`.
+ *  - Consumers: include this header only, then
+ *        AnalyticsTableReader r;
+ *        if (analytics_table_attach(&r, ANALYTICS_TABLE_NAME) == 0) {
+ *            const AnalyticsSlot *slot = analytics_table_find(&r, "Binance", "BTCUSDT");
+ *            AnalyticsSnapshot s;
+ *            if (slot && analytics_table_read(slot, &s)) ... s.window[ANALYTICS_5M].vwap ...
+ *        }
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#ifndef ANALYTICS_TABLE_H
+#define ANALYTICS_TABLE_H
+
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define ANALYTICS_TABLE_NAME "/crypto_ws_analytics"    // appears as /dev/shm/crypto_ws_analytics
+#define ANALYTICS_TABLE_MAGIC 0x41575343u              // "CSWA"
+#define ANALYTICS_TABLE_VERSION 1
+#define ANALYTICS_TABLE_SLOTS 4096                     // power of two
+#define ANALYTICS_EXCHANGE_LEN 16
+#define ANALYTICS_SYMBOL_LEN 24
+
+#define ANALYTICS_TABLE_LIVE 1
+#define ANALYTICS_TABLE_CLOSED 2
+
+/* Rolling windows, shortest first; lengths are in the table header */
+enum { ANALYTICS_1M = 0, ANALYTICS_5M, ANALYTICS_15M, ANALYTICS_1H, ANALYTICS_WINDOWS };
+
+typedef struct __attribute__((aligned(64))) {
+    uint32_t magic;                 // written last, once the table is initialised
+    uint32_t version;
+    uint32_t slot_count;
+    uint32_t slot_size;
+    uint32_t state;                 // ANALYTICS_TABLE_LIVE / ANALYTICS_TABLE_CLOSED
+    uint32_t used;                  // slots claimed so far
+    int64_t created_ns;             // CLOCK_REALTIME
+    int64_t window_ms[ANALYTICS_WINDOWS];
+} AnalyticsTableHeader;
+
+/* Trades received in the last window_ms (on the collector's clock) */
+typedef struct {
+    double vwap;                    // sum(price * size) / sum(size)
+    double volatility;              // realized, % over the window: sqrt(sum of squared log returns)
+    double volume;
+    double avg_size;                // volume / trades
+    double buy_volume;              // taker buys
+    double sell_volume;             // taker sells
+    double imbalance;               // (buy - sell) / (buy + sell), 0 when no trade has a side
+    double open;                    // price of the first trade in the window
+    uint64_t trades;
+} AnalyticsWindow;
+
+typedef struct __attribute__((aligned(64))) {
+    uint32_t seq;                   // seqlock: odd while the collector is writing
+    uint32_t claimed;               // exchange/symbol set; never cleared
+    char exchange[ANALYTICS_EXCHANGE_LEN];
+    char symbol[ANALYTICS_SYMBOL_LEN];
+
+    double last_price;
+    int64_t update_ns;              // CLOCK_REALTIME when the collector wrote the slot
+    uint64_t updates;
+    AnalyticsWindow window[ANALYTICS_WINDOWS];
+} AnalyticsSlot;
+
+/* Consistent copy of one slot */
+typedef struct {
+    double last_price;
+    int64_t update_ns;
+    uint64_t updates;
+    AnalyticsWindow window[ANALYTICS_WINDOWS];
+} AnalyticsSnapshot;
+
+_Static_assert(sizeof(AnalyticsSlot) == 384, "AnalyticsSlot must stay six cache lines");
+
+#define ANALYTICS_TABLE_SIZE (sizeof(AnalyticsTableHeader) + (size_t)ANALYTICS_TABLE_SLOTS * sizeof(AnalyticsSlot))
+
+/* FNV-1a over "exchange\0symbol", shared by the writer and readers */
+static inline uint32_t analytics_table_hash(const char *exchange, const char *symbol) {
+    uint32_t h = 2166136261u;
+    for (const char *p = exchange; *p; p++) h = (h ^ (uint8_t)*p) * 16777619u;
+    h = (h ^ 0u) * 16777619u;
+    for (const char *p = symbol; *p; p++) h = (h ^ (uint8_t)*p) * 16777619u;
+    return h;
+}
+
+/* ----------------------------- Reader (header-only) ----------------------------- */
+
+typedef struct {
+    const AnalyticsTableHeader *header;
+    const AnalyticsSlot *slots;
+} AnalyticsTableReader;
+
+/* Map the table read-only; returns 0 on success, -1 if it does not exist or is not an analytics table */
+static inline int analytics_table_attach(AnalyticsTableReader *reader, const char *name) {
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < ANALYTICS_TABLE_SIZE) {
+        close(fd);
+        return -1;
+    }
+
+    void *map = mmap(NULL, ANALYTICS_TABLE_SIZE, PROT_READ, MAP_SHARED | MAP_POPULATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return -1;
+
+    const AnalyticsTableHeader *header = (const AnalyticsTableHeader *)map;
+    if (__atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) != ANALYTICS_TABLE_MAGIC ||
+        header->version != ANALYTICS_TABLE_VERSION || header->slot_size != sizeof(AnalyticsSlot)) {
+        munmap(map, ANALYTICS_TABLE_SIZE);
+        return -1;
+    }
+
+    reader->header = header;
+    reader->slots = (const AnalyticsSlot *)(header + 1);
+    return 0;
+}
+
+static inline void analytics_table_detach(AnalyticsTableReader *reader) {
+    if (reader->header) munmap((void *)reader->header, ANALYTICS_TABLE_SIZE);
+    reader->header = NULL;
+    reader->slots = NULL;
+}
+
+/* ANALYTICS_TABLE_LIVE while the collector runs, ANALYTICS_TABLE_CLOSED after it exits */
+static inline uint32_t analytics_table_state(const AnalyticsTableReader *reader) {
+    return __atomic_load_n(&reader->header->state, __ATOMIC_ACQUIRE);
+}
+
+/* Slot for (exchange, symbol), or NULL if the collector has not seen a trade for it yet */
+static inline const AnalyticsSlot *analytics_table_find(const AnalyticsTableReader *reader, const char *exchange, const char *symbol) {
+    uint32_t mask = reader->header->slot_count - 1;
+    uint32_t index = analytics_table_hash(exchange, symbol) & mask;
+
+    for (uint32_t probe = 0; probe <= mask; probe++) {
+        const AnalyticsSlot *slot = &reader->slots[(index + probe) & mask];
+        if (!__atomic_load_n(&slot->claimed, __ATOMIC_ACQUIRE)) return NULL;
+        if (strncmp(slot->exchange, exchange, ANALYTICS_EXCHANGE_LEN) == 0 &&
+            strncmp(slot->symbol, symbol, ANALYTICS_SYMBOL_LEN) == 0)
+            return slot;
+    }
+    return NULL;
+}
+
+/* Copy a consistent snapshot of `slot`; returns 0 if it has never been written */
+static inline int analytics_table_read(const AnalyticsSlot *slot, AnalyticsSnapshot *out) {
+    uint32_t before, after;
+    do {
+        before = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+        if (before & 1) continue;
+
+        out->last_price = slot->last_price;
+        out->update_ns = slot->update_ns;
+        out->updates = slot->updates;
+        memcpy(out->window, (const void *)slot->window, sizeof(out->window));
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        after = __atomic_load_n(&slot->seq, __ATOMIC_RELAXED);
+    } while ((before & 1) || before != after);
+
+    return out->updates != 0;
+}
+
+#endif // ANALYTICS_TABLE_H
@@ -0,0 +1,222 @@
+/*
+ * Arbitrage Detector
+ *
+ * Implements the fee-adjusted cross-venue dislocation detector from
+ * `arb_detector.h`. State is one `Dislocation` per normalized pair,
+ * indexed by pair id; venues and their latest quotes come from the
+ * symbol registry.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#include "arb_detector.h"
+#include "symbol_registry.h"
+#include "exchange_adapter.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include <time.h>
+
+typedef struct {
+    int active;
+    int buy;                        // symbol id of the venue to buy on (its ask)
+    int sell;                       // symbol id of the venue to sell on (its bid)
+    int64_t start_ns;
+    double ask;                     // prices when it opened
+    double bid;
+    double last_edge_bps;
+    double max_edge_bps;
+    uint64_t updates;
+} Dislocation;
+
+static Dislocation dislocations[SYMBOL_REGISTRY_PAIRS];
+static double taker_fee[MAX_EXCHANGE_ADAPTERS];     // fraction, by adapter index
+static int started = 0;
+static FILE *events = NULL;
+
+static unsigned long long opened = 0, closed = 0;
+static double closed_ms = 0.0, longest_ms = 0.0;
+static int64_t next_report_ns = 0;
+static int64_t next_poll_ns = 0;
+
+static int64_t realtime_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static double elapsed_ms(int64_t from_ns, int64_t to_ns) {
+    return (to_ns - from_ns) / 1e6;
+}
+
+static void open_dislocation(const PairInfo *pair, Dislocation *d, int buy, int sell, double edge, int64_t now) {
+    const SymbolInfo *b = symbol_registry_info(buy);
+    const SymbolInfo *s = symbol_registry_info(sell);
+
+    d->active = 1;
+    d->buy = buy;
+    d->sell = sell;
+    d->start_ns = now;
+    d->ask = b->quote.ask;
+    d->bid = s->quote.bid;
+    d->last_edge_bps = edge;
+    d->max_edge_bps = edge;
+    d->updates = 1;
+    opened++;
+
+    if (events)
+        fprintf(events, "{\"event\":\"open\",\"time_ms\":%lld,\"pair\":\"%s\",\"buy_exchange\":\"%s\",\"buy_symbol\":\"%s\","
+                "\"ask\":%.10g,\"sell_exchange\":\"%s\",\"sell_symbol\":\"%s\",\"bid\":%.10g,\"edge_bps\":%.2f}\n",
+                (long long)(now / 1000000), pair->name, b->exchange, b->symbol, d->ask,
+                s->exchange, s->symbol, d->bid, edge);
+}
+
+static void close_dislocation(const PairInfo *pair, Dislocation *d, int64_t now) {
+    double duration = elapsed_ms(d->start_ns, now);
+    closed++;
+    closed_ms += duration;
+    if (duration > longest_ms) longest_ms = duration;
+
+    if (events)
+        fprintf(events, "{\"event\":\"close\",\"time_ms\":%lld,\"pair\":\"%s\",\"buy_exchange\":\"%s\",\"sell_exchange\":\"%s\","
+                "\"duration_ms\":%.0f,\"max_edge_bps\":%.2f,\"last_edge_bps\":%.2f,\"updates\":%llu}\n",
+                (long long)(now / 1000000), pair->name, symbol_registry_info(d->buy)->exchange,
+                symbol_registry_info(d->sell)->exchange, duration, d->max_edge_bps, d->last_edge_bps,
+                (unsigned long long)d->updates);
+    d->active = 0;
+}
+
+static void report(int64_t now) {
+    int open = 0;
+    for (int p = 0; p < symbol_registry_pair_count(); p++) open += dislocations[p].active;
+
+    printf("[STATS] arbitrage: %d open, %llu opened, %llu closed (avg %.0f ms, longest %.0f ms) over the last %d s\n",
+           open, opened, closed, closed ? closed_ms / closed : 0.0, longest_ms, ARB_REPORT_MS / 1000);
+    opened = closed = 0;
+    closed_ms = longest_ms = 0.0;
+    next_report_ns = now + (int64_t)ARB_REPORT_MS * 1000000;
+    if (events) fflush(events);
+}
+
+/* Apply "exchange=bps[,exchange=bps...]" on top of the adapter fees */
+static int apply_fee_spec(const char *spec) {
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer), "%s", spec);
+
+    char *save = NULL;
+    for (char *item = strtok_r(buffer, ",", &save); item; item = strtok_r(NULL, ",", &save)) {
+        char *eq = strchr(item, '=');
+        if (eq) *eq = '\0';
+        const ExchangeAdapter *adapter = eq ? find_exchange_adapter(item) : NULL;
+        if (!adapter) {
+            printf("[ERROR] Invalid taker fee override \"%s\"\n", item);
+            return -1;
+        }
+        for (int i = 0; i < exchange_adapter_count; i++)
+            if (exchange_adapters[i] == adapter) taker_fee[i] = atof(eq + 1) / 10000.0;
+    }
+    return 0;
+}
+
+int arb_detector_start(const char *fee_spec) {
+    for (int i = 0; i < exchange_adapter_count; i++)
+        taker_fee[i] = exchange_adapters[i]->taker_fee_bps / 10000.0;
+    if (fee_spec && apply_fee_spec(fee_spec) != 0) return -1;
+
+    memset(dislocations, 0, sizeof(dislocations));
+    events = fopen(ARB_EVENTS_FILE, "a");
+    if (!events)
+        printf("[WARNING] Failed to open %s (%s), dislocations are only counted\n", ARB_EVENTS_FILE, strerror(errno));
+
+    started = 1;
+    next_report_ns = next_poll_ns = 0;
+    printf("[INFO] Arbitrage detector: dislocations above %.1f bps after taker fees\n", ARB_MIN_EDGE_BPS);
+    return 0;
+}
+
+void arb_detector_quote(int id, int64_t now) {
+    if (!started || id < 0) return;
+
+    int pair_id = symbol_registry_info(id)->pair;
+    if (pair_id < 0) return;
+    const PairInfo *pair = symbol_registry_pair(pair_id);
+    Dislocation *d = &dislocations[pair_id];
+    if (pair->venue_count < 2 && !d->active) return;
+
+    /* Best fee-adjusted bid and ask among the venues with a fresh quote */
+    int64_t stale_before = now - (int64_t)ARB_STALE_MS * 1000000;
+    int buy = -1, sell = -1;
+    double best_ask = INFINITY, best_bid = 0.0;
+    for (int i = 0; i < pair->venue_count; i++) {
+        const SymbolInfo *s = symbol_registry_info(pair->venues[i]);
+        const SymbolQuote *q = &s->quote;
+        if (q->quote_ns < stale_before || q->bid <= 0 || q->ask <= 0) continue;
+
+        double fee = s->venue >= 0 ? taker_fee[s->venue] : 0.0;
+        double net_bid = q->bid * (1.0 - fee);
+        double net_ask = q->ask * (1.0 + fee);
+        if (net_bid > best_bid) {
+            best_bid = net_bid;
+            sell = pair->venues[i];
+        }
+        if (net_ask < best_ask) {
+            best_ask = net_ask;
+            buy = pair->venues[i];
+        }
+    }
+
+    /* Both sides on one venue means that venue's own book is crossed, not a dislocation */
+    double edge = -INFINITY;
+    if (buy >= 0 && sell >= 0 && symbol_registry_info(buy)->venue != symbol_registry_info(sell)->venue)
+        edge = (best_bid / best_ask - 1.0) * 10000.0;
+
+    if (edge < ARB_MIN_EDGE_BPS) {
+        if (d->active) close_dislocation(pair, d, now);
+        return;
+    }
+
+    if (d->active && (d->buy != buy || d->sell != sell)) close_dislocation(pair, d, now);
+    if (!d->active) {
+        open_dislocation(pair, d, buy, sell, edge, now);
+        return;
+    }
+    d->updates++;
+    d->last_edge_bps = edge;
+    if (edge > d->max_edge_bps) d->max_edge_bps = edge;
+}
+
+void arb_detector_poll() {
+    if (!started) return;
+    int64_t now = realtime_ns();
+    if (now < next_poll_ns) return;
+    next_poll_ns = now + (int64_t)ARB_POLL_MS * 1000000;
+
+    /* Quotes only re-evaluate their own pair, so a pair whose venues all went quiet is closed here */
+    int64_t stale_before = now - (int64_t)ARB_STALE_MS * 1000000;
+    for (int p = 0; p < symbol_registry_pair_count(); p++) {
+        Dislocation *d = &dislocations[p];
+        if (d->active && (symbol_registry_info(d->buy)->quote.quote_ns < stale_before ||
+                          symbol_registry_info(d->sell)->quote.quote_ns < stale_before))
+            close_dislocation(symbol_registry_pair(p), d, now);
+    }
+
+    if (!next_report_ns) next_report_ns = now + (int64_t)ARB_REPORT_MS * 1000000;
+    else if (now >= next_report_ns) report(now);
+}
+
+void arb_detector_stop() {
+    if (!started) return;
+
+    int64_t now = realtime_ns();
+    for (int p = 0; p < symbol_registry_pair_count(); p++)
+        if (dislocations[p].active) close_dislocation(symbol_registry_pair(p), &dislocations[p], now);
+
+    report(now);
+    if (events) fclose(events);
+    events = NULL;
+    started = 0;
+}
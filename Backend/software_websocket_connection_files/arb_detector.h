@@ -0,0 +1,61 @@
+/*
+ * Arbitrage Detector Header
+ *
+ * Declares the cross-venue dislocation detector: for every normalized pair
+ * it watches the best bid and ask of each venue and reports when one
+ * venue's bid exceeds another's ask by more than both taker fees plus a
+ * threshold, and for how long.
+ *
+ * Features:
+ *  - Incremental: a quote update re-evaluates only the pair it belongs to,
+ *    reading the latest quote of each venue from the symbol registry
+ *    (`symbol_registry.h`). The cost is O(venues quoting the pair).
+ *  - Prices are fee-adjusted: bid * (1 - fee) on the sell venue against
+ *    ask * (1 + fee) on the buy venue, with each adapter's base-tier taker
+ *    fee (`ExchangeAdapter.taker_fee_bps`) unless overridden.
+ *  - Quotes older than ARB_STALE_MS are ignored, so a venue that stopped
+ *    updating cannot hold a dislocation open. A dislocation whose venues
+ *    all go quiet is closed by `arb_detector_poll()` every ARB_POLL_MS.
+ *  - One dislocation per pair is tracked from `open` to `close`. If the
+ *    best venue pair changes, the old one closes and a new one opens.
+ *    Close events carry the duration, the peak edge and the update count.
+ *  - Events are appended to ARB_EVENTS_FILE as one JSON object per line.
+ *
+ * Dependencies:
+ *  - symbol_registry.h, exchange_adapter.h.
+ *
+ * Usage:
+ *  - `cryptofeed.c` (or the supervisor's aggregator) calls
+ *    `arb_detector_quote()` after a clean bid/ask update and
+ *    `arb_detector_poll()` after every service pass. Service thread only.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#ifndef ARB_DETECTOR_H
+#define ARB_DETECTOR_H
+
+#include <stdint.h>
+
+#define ARB_MIN_EDGE_BPS 5.0                // net edge, after fees, that opens a dislocation
+#define ARB_STALE_MS 2000                   // quotes older than this are ignored
+#define ARB_EVENTS_FILE "arbitrage_output_data.json"
+#define ARB_POLL_MS 1000                    // how often quiet dislocations are checked for stale quotes
+#define ARB_REPORT_MS 60000
+
+/* Start the detector; `fee_spec` overrides taker fees, e.g. "binance=0,okx=8" (bps), NULL = adapter
+ * defaults. Returns 0, or -1 on an unknown exchange in the spec. */
+int arb_detector_start(const char *fee_spec);
+
+/* Re-evaluate the pair of registry id `id` after its bid/ask changed at `now_ns` (receive clock) */
+void arb_detector_quote(int id, int64_t now_ns);
+
+/* Close dislocations whose buy or sell quote went stale and report on their cadence; cheap to call after every
+ * service pass */
+void arb_detector_poll();
+
+/* Close open dislocations, report totals and close the event log */
+void arb_detector_stop();
+
+#endif // ARB_DETECTOR_H
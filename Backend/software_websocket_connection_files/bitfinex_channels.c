@@ -0,0 +1,108 @@
+/*
+ * Bitfinex Channel Routing
+ *
+ * Bitfinex data messages only carry a numeric channel ID (`[chanId, ...]`);
+ * the symbol is announced once in the subscribe ack. This module keeps the
+ * mapping for each connection in a dense array so the receive path can turn
+ * a channel ID into a symbol without hashing or searching.
+ *
+ * Features:
+ *  - The table covers `[base, base + capacity)`; the first ack sets `base`.
+ *  - IDs below `base` shift the table down, IDs above it grow it (doubling).
+ *  - Spans wider than `BITFINEX_MAX_ROUTE_SPAN` are refused and logged.
+ *
+ * Dependencies:
+ *  - Standard C libraries (stdio, stdlib, string).
+ *
+ * Usage:
+ *  - `exchange_websocket.c` resets a connection's table on ESTABLISHED, adds
+ *    entries from subscribe acks and looks them up for every data message.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#include "bitfinex_channels.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    BitfinexChannel *by_id;             // by_id[chan_id - base]
+    long base;
+    size_t capacity;
+    size_t used;                        // channels registered since the last reset
+} BitfinexRoutes;
+
+static BitfinexRoutes routes[BITFINEX_MAX_CONNECTIONS];
+
+void bitfinex_channels_reset(int connection) {
+    if (connection < 0 || connection >= BITFINEX_MAX_CONNECTIONS) return;
+    BitfinexRoutes *r = &routes[connection];
+    /* Keep the allocation: the next subscription round needs about the same span */
+    if (r->by_id) memset(r->by_id, 0, r->capacity * sizeof(*r->by_id));
+    r->used = 0;
+}
+
+/* Make [low, high] addressable, keeping existing entries; caller checks the span */
+static int ensure_range(BitfinexRoutes *r, long low, long high) {
+    size_t needed = (size_t)(high - low + 1);
+    size_t capacity = r->capacity ? r->capacity : 64;
+    while (capacity < needed) capacity *= 2;
+
+    if (capacity != r->capacity) {
+        BitfinexChannel *grown = realloc(r->by_id, capacity * sizeof(*grown));
+        if (!grown) {
+            fprintf(stderr, "[ERROR] Memory allocation failed for Bitfinex channel table\n");
+            return -1;
+        }
+        memset(grown + r->capacity, 0, (capacity - r->capacity) * sizeof(*grown));
+        r->by_id = grown;
+        r->capacity = capacity;
+    }
+
+    if (low < r->base) {
+        size_t shift = (size_t)(r->base - low);
+        memmove(r->by_id + shift, r->by_id, (r->capacity - shift) * sizeof(*r->by_id));
+        memset(r->by_id, 0, shift * sizeof(*r->by_id));
+        r->base = low;
+    }
+    return 0;
+}
+
+int bitfinex_channels_add(int connection, long chan_id, BitfinexChannelType type, const char *symbol, size_t symbol_len) {
+    if (connection < 0 || connection >= BITFINEX_MAX_CONNECTIONS || chan_id < 0) return -1;
+    BitfinexRoutes *r = &routes[connection];
+
+    if (r->used == 0) r->base = chan_id;
+
+    long low = chan_id < r->base ? chan_id : r->base;
+    long high = chan_id;
+    if (r->capacity > 0 && r->base + (long)r->capacity - 1 > high)
+        high = r->base + (long)r->capacity - 1;
+
+    if (high - low + 1 > BITFINEX_MAX_ROUTE_SPAN) {
+        fprintf(stderr, "[ERROR] Bitfinex channel %ld is too far from %ld to route\n", chan_id, r->base);
+        return -1;
+    }
+    if (ensure_range(r, low, high) != 0) return -1;
+
+    BitfinexChannel *channel = &r->by_id[chan_id - r->base];
+    if (channel->type == BITFINEX_CHANNEL_NONE) r->used++;
+    channel->type = type;
+    if (symbol_len >= sizeof(channel->symbol)) symbol_len = sizeof(channel->symbol) - 1;
+    memcpy(channel->symbol, symbol, symbol_len);
+    channel->symbol[symbol_len] = '\0';
+    return 0;
+}
+
+const BitfinexChannel *bitfinex_channels_lookup(int connection, long chan_id) {
+    if (connection < 0 || connection >= BITFINEX_MAX_CONNECTIONS) return NULL;
+    const BitfinexRoutes *r = &routes[connection];
+
+    long index = chan_id - r->base;
+    if (index < 0 || (size_t)index >= r->capacity) return NULL;
+    const BitfinexChannel *channel = &r->by_id[index];
+    return channel->type != BITFINEX_CHANNEL_NONE ? channel : NULL;
+}
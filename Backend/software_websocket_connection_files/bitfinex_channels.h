@@ -0,0 +1,53 @@
+/*
+ * Bitfinex Channel Routing Header
+ *
+ * Declares the per-connection table that maps Bitfinex channel IDs to the
+ * symbol and channel they were subscribed for.
+ *
+ * Features:
+ *  - One dense table per Bitfinex connection, indexed by `chanId - base`,
+ *    so routing a data message is a single array lookup.
+ *  - Filled from `{"event":"subscribed",...}` acks and cleared whenever the
+ *    connection is re-established (channel IDs are per connection).
+ *  - Grows on demand; no allocation on the data path.
+ *
+ * Dependencies:
+ *  - Standard C library (stddef.h).
+ *
+ * Usage:
+ *  - Implemented in `bitfinex_channels.c`.
+ *  - Used by the Bitfinex handlers in `exchange_websocket.c`.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#ifndef BITFINEX_CHANNELS_H
+#define BITFINEX_CHANNELS_H
+
+#include <stddef.h>
+
+#define BITFINEX_MAX_CONNECTIONS 20     // matches the bitfinex-websocket-N protocols
+#define BITFINEX_MAX_ROUTE_SPAN 65536   // widest chanId range tracked per connection
+
+typedef enum {
+    BITFINEX_CHANNEL_NONE = 0,
+    BITFINEX_CHANNEL_TICKER,
+    BITFINEX_CHANNEL_TRADES
+} BitfinexChannelType;
+
+typedef struct {
+    BitfinexChannelType type;
+    char symbol[24];                    // pair without the leading 't', e.g. "BTCUSD"
+} BitfinexChannel;
+
+/* Forget every channel of one connection (called when it is re-established) */
+void bitfinex_channels_reset(int connection);
+
+/* Record a subscribe ack; returns 0 on success, -1 if the ID cannot be tracked */
+int bitfinex_channels_add(int connection, long chan_id, BitfinexChannelType type, const char *symbol, size_t symbol_len);
+
+/* Channel registered for `chan_id`, or NULL if unknown */
+const BitfinexChannel *bitfinex_channels_lookup(int connection, long chan_id);
+
+#endif // BITFINEX_CHANNELS_H
@@ -0,0 +1,253 @@
+/*
+ * Composite Index
+ *
+ * Implements the per-asset composite USD index of `composite_index.h`.
+ * Contributor state is indexed by registry symbol id and index state by
+ * registry asset id; both are fixed arrays, so an update allocates nothing.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#include "composite_index.h"
+#include "symbol_registry.h"
+#include "currency_graph.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include <time.h>
+
+typedef struct {
+    double usd;                     // latest price in USD, 0 = none yet
+    double volume;                  // decayed USD notional as of volume_ns
+    int64_t volume_ns;
+    int64_t price_ns;
+    int asset;                      // asset id it contributes to, -1 = none
+    int joined;                     // asset resolved
+} Contributor;
+
+typedef struct {
+    int count;
+    int members[COMPOSITE_MAX_VENUES];      // symbol ids, sorted by USD price
+    double value;                           // 0 = no fresh contributor
+    int used;
+    int trimmed;
+    int64_t value_ns;
+} AssetIndex;
+
+static Contributor contributors[SYMBOL_REGISTRY_MAX];
+static AssetIndex indexes[SYMBOL_REGISTRY_ASSETS];
+static int usd_asset = -1;
+static int started = 0;
+
+static int64_t next_publish_ns = 0, next_report_ns = 0;
+static unsigned long long updates = 0, trims = 0, publishes = 0;
+
+static int64_t realtime_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static double decay(int64_t elapsed_ns) {
+    return exp2(-(double)elapsed_ns / ((double)COMPOSITE_HALF_LIFE_MS * 1000000.0));
+}
+
+/* Attach a symbol to the index of its base asset on first sight */
+static void join(int id) {
+    Contributor *c = &contributors[id];
+    c->joined = 1;
+    c->asset = -1;
+
+    int pair = symbol_registry_info(id)->pair;
+    if (pair < 0) return;
+    int base = symbol_registry_pair(pair)->base_id;
+    if (usd_asset < 0) usd_asset = symbol_registry_asset_id(CURRENCY_GRAPH_ROOT);
+    if (base < 0 || base == usd_asset) return;
+
+    AssetIndex *index = &indexes[base];
+    if (index->count == COMPOSITE_MAX_VENUES) return;
+    /* Unpriced members sort first and are skipped as stale */
+    memmove(&index->members[1], &index->members[0], index->count * sizeof(int));
+    index->members[0] = id;
+    index->count++;
+    c->asset = base;
+}
+
+/* Move the member at `pos` to its place after its price changed */
+static void reposition(AssetIndex *index, int pos) {
+    int *m = index->members;
+    int id = m[pos];
+    double usd = contributors[id].usd;
+
+    while (pos > 0 && contributors[m[pos - 1]].usd > usd) {
+        m[pos] = m[pos - 1];
+        pos--;
+    }
+    while (pos + 1 < index->count && contributors[m[pos + 1]].usd < usd) {
+        m[pos] = m[pos + 1];
+        pos++;
+    }
+    m[pos] = id;
+}
+
+/* Weighted median of the members with weight > 0, walking them in price order */
+static double weighted_median(const AssetIndex *index, const double *weight, double total) {
+    double sum = 0.0;
+    for (int i = 0; i < index->count; i++) {
+        if (weight[i] <= 0) continue;
+        sum += weight[i];
+        if (sum >= total / 2) return contributors[index->members[i]].usd;
+    }
+    return 0.0;
+}
+
+/* Sum of the weights; if every fresh member has zero volume, weigh them equally */
+static double normalize_weights(const AssetIndex *index, const int *fresh, double *weight) {
+    double total = 0.0;
+    for (int i = 0; i < index->count; i++) total += fresh[i] ? weight[i] : 0.0;
+    if (total > 0) {
+        for (int i = 0; i < index->count; i++) if (!fresh[i]) weight[i] = 0.0;
+        return total;
+    }
+    for (int i = 0; i < index->count; i++) {
+        weight[i] = fresh[i] ? 1.0 : 0.0;
+        total += weight[i];
+    }
+    return total;
+}
+
+static void recompute(AssetIndex *index, int64_t now) {
+    double weight[COMPOSITE_MAX_VENUES] = {0};
+    int fresh[COMPOSITE_MAX_VENUES] = {0};
+    int64_t stale_before = now - (int64_t)COMPOSITE_STALE_MS * 1000000;
+
+    for (int i = 0; i < index->count; i++) {
+        const Contributor *c = &contributors[index->members[i]];
+        fresh[i] = c->usd > 0 && c->price_ns >= stale_before;
+    }
+
+    /* Trim around the plain median of the fresh venues, so one venue's volume cannot pull the band to itself */
+    double center = weighted_median(index, weight, normalize_weights(index, fresh, weight));
+    int trimmed = 0, used = 0;
+    double band = center * COMPOSITE_TRIM_BPS / 10000.0;
+    for (int i = 0; i < index->count; i++) {
+        const Contributor *c = &contributors[index->members[i]];
+        if (!fresh[i]) continue;
+        if (fabs(c->usd - center) > band) {
+            fresh[i] = 0;
+            trimmed++;
+            continue;
+        }
+        weight[i] = c->volume * decay(now - c->volume_ns);
+        used++;
+    }
+    double value = used ? weighted_median(index, weight, normalize_weights(index, fresh, weight)) : 0.0;
+
+    index->value = value;
+    index->used = used;
+    index->trimmed = trimmed;
+    index->value_ns = now;
+    trims += trimmed;
+}
+
+void composite_index_start() {
+    memset(contributors, 0, sizeof(contributors));
+    memset(indexes, 0, sizeof(indexes));
+    usd_asset = -1;
+    updates = trims = publishes = 0;
+    next_publish_ns = next_report_ns = 0;
+    started = 1;
+}
+
+void composite_index_update(int id, const MarketRecord *record) {
+    if (!started) return;
+    Contributor *c = &contributors[id];
+    if (!c->joined) join(id);
+    if (c->asset < 0) return;
+
+    int64_t now = record->recv_ns;
+    double usd = currency_graph_usd(id, symbol_quote_price(&symbol_registry_info(id)->quote));
+    if (usd <= 0) return;
+
+    if (record->kind == MARKET_RECORD_TRADE && record->size > 0) {
+        c->volume = c->volume * decay(now - c->volume_ns) + record->size * usd;
+        c->volume_ns = now;
+    }
+
+    AssetIndex *index = &indexes[c->asset];
+    c->usd = usd;
+    c->price_ns = now;
+    for (int i = 0; i < index->count; i++) {
+        if (index->members[i] != id) continue;
+        reposition(index, i);
+        break;
+    }
+    recompute(index, now);
+    updates++;
+}
+
+double composite_index_price(const char *asset) {
+    int id = symbol_registry_asset_id(asset);
+    return id >= 0 ? indexes[id].value : 0.0;
+}
+
+/* Rewrite the snapshot through a temporary file, so readers see either the old or the new one */
+static void publish(int64_t now) {
+    char tmp_name[256];
+    snprintf(tmp_name, sizeof(tmp_name), "%s.tmp", COMPOSITE_INDEX_FILE);
+    FILE *fp = fopen(tmp_name, "w");
+    if (!fp) {
+        printf("[ERROR] Failed to write %s: %s\n", tmp_name, strerror(errno));
+        return;
+    }
+
+    int64_t stale_before = now - (int64_t)COMPOSITE_STALE_MS * 1000000;
+    int first = 1;
+    fprintf(fp, "{\"time_ms\":%lld,\"quote\":\"%s\",\"index\":[", (long long)(now / 1000000), CURRENCY_GRAPH_ROOT);
+    for (int a = 0; a < symbol_registry_asset_count(); a++) {
+        const AssetIndex *index = &indexes[a];
+        if (index->value <= 0 || index->value_ns < stale_before) continue;
+        fprintf(fp, "%s\n{\"asset\":\"%s\",\"price\":%.10g,\"venues\":%d,\"trimmed\":%d,\"age_ms\":%lld}",
+                first ? "" : ",", symbol_registry_asset(a), index->value, index->used, index->trimmed,
+                (long long)((now - index->value_ns) / 1000000));
+        first = 0;
+    }
+    fputs("]}\n", fp);
+
+    if (fclose(fp) != 0 || rename(tmp_name, COMPOSITE_INDEX_FILE) != 0)
+        printf("[ERROR] Failed to publish %s: %s\n", COMPOSITE_INDEX_FILE, strerror(errno));
+    publishes++;
+}
+
+static void report(int64_t now) {
+    int assets = 0;
+    for (int a = 0; a < symbol_registry_asset_count(); a++) assets += indexes[a].value > 0;
+
+    printf("[STATS] composite index: %d assets, %llu updates, %llu trimmed contributors, %llu publishes\n",
+           assets, updates, trims, publishes);
+    updates = trims = publishes = 0;
+    next_report_ns = now + (int64_t)COMPOSITE_REPORT_MS * 1000000;
+}
+
+void composite_index_poll() {
+    if (!started) return;
+    int64_t now = realtime_ns();
+    if (now < next_publish_ns) return;
+    next_publish_ns = now + (int64_t)COMPOSITE_PUBLISH_MS * 1000000;
+
+    /* Every tick, not only when an index moved: ages stay current and assets that went stale drop out */
+    publish(now);
+    if (!next_report_ns) next_report_ns = now + (int64_t)COMPOSITE_REPORT_MS * 1000000;
+    else if (now >= next_report_ns) report(now);
+}
+
+void composite_index_stop() {
+    if (!started) return;
+    int64_t now = realtime_ns();
+    publish(now);
+    report(now);
+    started = 0;
+}
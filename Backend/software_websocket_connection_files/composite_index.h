@@ -0,0 +1,68 @@
+/*
+ * Composite Index Header
+ *
+ * Declares the per-asset composite reference price: one USD index per
+ * base asset ("BTC", "ETH", ...) built from every venue symbol that
+ * trades it, against any quote asset.
+ *
+ * Features:
+ *  - Each contributor is a venue symbol (Binance BTCUSDT, Kraken XBT/USD,
+ *    ...). Its price is its mid or last price (`symbol_registry.h`),
+ *    converted to USD by the currency graph (`currency_graph.h`).
+ *  - The index is the volume-weighted median of the contributor prices.
+ *    Weights are traded USD notional with a COMPOSITE_HALF_LIFE_MS
+ *    exponential decay; until any contributor has traded, they are equal.
+ *  - Contributors that have not updated for COMPOSITE_STALE_MS are left
+ *    out. Contributors more than COMPOSITE_TRIM_BPS from the plain
+ *    (unweighted) median are trimmed before the weighted median is taken,
+ *    so one high-volume venue cannot drag the band with it.
+ *  - Incremental: contributors of an asset are kept sorted by price, so a
+ *    tick moves one contributor into place and recomputes its asset in
+ *    O(contributors).
+ *  - Published every COMPOSITE_PUBLISH_MS by rewriting COMPOSITE_INDEX_FILE
+ *    (written to a temporary file and renamed, so readers never see half a
+ *    file), whether or not an index moved, so ages stay current and assets
+ *    older than COMPOSITE_STALE_MS drop out.
+ *
+ * Dependencies:
+ *  - symbol_registry.h, currency_graph.h, market_record.h.
+ *
+ * Usage:
+ *  - `cryptofeed.c` (or the supervisor's aggregator) calls
+ *    `composite_index_update()` after the currency graph for each clean
+ *    record and `composite_index_poll()` after every service pass.
+ *    Service thread only.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#ifndef COMPOSITE_INDEX_H
+#define COMPOSITE_INDEX_H
+
+#include "market_record.h"
+
+#define COMPOSITE_INDEX_FILE "index_output_data.json"
+#define COMPOSITE_MAX_VENUES 32                 // contributing venue symbols per asset
+#define COMPOSITE_STALE_MS 10000                // contributors older than this are left out
+#define COMPOSITE_TRIM_BPS 100.0                // distance from the median beyond which a contributor is trimmed
+#define COMPOSITE_HALF_LIFE_MS 300000           // decay of the volume weights
+#define COMPOSITE_PUBLISH_MS 1000
+#define COMPOSITE_REPORT_MS 60000
+
+/* Reset the indexes */
+void composite_index_start();
+
+/* Re-price the contributor of registry id `id` from its latest quote and recompute its asset */
+void composite_index_update(int id, const MarketRecord *record);
+
+/* Latest index of `asset` ("BTC") in USD, 0 if it has none */
+double composite_index_price(const char *asset);
+
+/* Publish the snapshot file on its cadence and report; cheap to call after every service pass */
+void composite_index_poll();
+
+/* Publish once more and report totals */
+void composite_index_stop();
+
+#endif // COMPOSITE_INDEX_H
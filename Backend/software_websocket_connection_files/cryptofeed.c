@@ -0,0 +1,494 @@
+/*
+ * Crypto Feed Library
+ *
+ * Implements the `CryptoFeed` context from `cryptofeed.h`: owns the lws
+ * context and the optional outputs, and fans every parsed record out to
+ * them and to the registered callbacks.
+ *
+ * Features:
+ *  - Creates the lws context (TLS session cache when available) that the
+ *    connection orchestrator and reconnect logic run on.
+ *  - Opens only the outputs the config enables; a record is converted to a
+ *    `MarketRecord` once and shared by the tick ring and callbacks.
+ *  - `cryptofeed_stop()` only sets a flag and wakes the service loop, so it
+ *    can be called from other threads.
+ *  - Every record passes the price filter (`price_filter.c`) first; outliers
+ *    are flagged, or in quarantine mode kept out of every output.
+ *  - Clean records update the latest quote of their registry id
+ *    (`symbol_registry.c`); bid/ask updates then re-evaluate the
+ *    cross-venue arbitrage detector (`arb_detector.c`) for that pair.
+ *  - The same updates move the USD cross-rate graph (`currency_graph.c`);
+ *    every priced record is converted to USD for the quote table and
+ *    `cryptofeed_usd_price()`, and feed the per-asset composite index
+ *    (`composite_index.c`).
+ *  - Trades whose venue does not say who took liquidity get their aggressor
+ *    from the prevailing quote of the same venue symbol (`trade_classifier.c`),
+ *    which also fills `market_maker` in the logs.
+ *  - Clean records are then checked against the alert rules
+ *    (`alert_engine.c`), which reload whenever the rules file changes.
+ *  - Trades feed the rolling analytics stage (`trade_analytics.c`), which
+ *    is polled after every service pass to age out quiet symbols.
+ *  - Low-latency mode pins the service and DNS threads and turns every
+ *    service call into a non-blocking pass that is timed for the jitter report.
+ *  - kTLS mode asks OpenSSL to hand the session keys to the kernel after each
+ *    handshake, so record decryption leaves the service thread; it is
+ *    skipped with a warning when the kernel or OpenSSL cannot do it.
+ *
+ * Dependencies:
+ *  - libwebsockets, plus every engine module (`exchange_*.c`, publishers,
+ *    `utils.c`).
+ *
+ * Usage:
+ *  - Archived with the engine into `libcryptofeed.a`; `main.c` is a thin host.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#include "cryptofeed.h"
+#include "cryptofeed_internal.h"
+#include "exchange_connect.h"
+#include "dns_cache.h"
+#include "sys_stats.h"
+#include "feed_profiles.h"
+#include "quote_publisher.h"
+#include "tick_publisher.h"
+#include "trade_analytics.h"
+#include "price_filter.h"
+#include "symbol_registry.h"
+#include "arb_detector.h"
+#include "currency_graph.h"
+#include "composite_index.h"
+#include "alert_engine.h"
+#include "trade_classifier.h"
+#include "utils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <libwebsockets.h>
+
+#if defined(LWS_WITH_TLS) && !defined(LWS_WITH_MBEDTLS)
+#include <openssl/ssl.h>
+#endif
+
+#define LOW_LATENCY_BUSY_POLL_US 50     // default SO_BUSY_POLL in low-latency mode
+
+/* Client TLS session cache (only used when lws is built with LWS_WITH_TLS_SESSIONS) */
+#define TLS_SESSION_TIMEOUT_SEC 3600
+#define TLS_SESSION_CACHE_MAX 64
+
+typedef struct {
+    cryptofeed_record_cb cb[CRYPTOFEED_MAX_CALLBACKS];
+    void *user[CRYPTOFEED_MAX_CALLBACKS];
+    int count;
+} CallbackList;
+
+struct CryptoFeed {
+    CryptoFeedConfig config;
+    CallbackList ticker;
+    CallbackList book;
+    CallbackList trade;
+    int started;
+    volatile sig_atomic_t stopping;
+};
+
+/* lws context shared with `exchange_connect.c`; engine state is process-wide, so one feed at a time */
+struct lws_context *context = NULL;
+static CryptoFeed *active_feed = NULL;
+
+void cryptofeed_default_config(CryptoFeedConfig *config) {
+    config->feed_profiles_file = NULL;
+    config->log_json = 1;
+    config->log_bson = 1;
+    config->quote_table = 1;
+    config->tick_ring = 1;
+    config->tick_ring_name = NULL;
+    config->analytics = 1;
+    config->price_filter = PRICE_FILTER_FLAG;
+    config->arbitrage = 1;
+    config->taker_fees = NULL;
+    config->usd_pricing = 1;
+    config->composite_index = 1;
+    config->alerts = 1;
+    config->classify_trades = 1;
+    config->alert_rules_file = NULL;
+    config->exchanges = NULL;
+    config->shard_index = 0;
+    config->shard_count = 1;
+    config->low_latency = 0;
+    config->service_cpu = -1;
+    config->housekeeping_cpu = -1;
+    config->busy_poll_us = 0;
+    config->ktls = 0;
+}
+
+int cryptofeed_config_low_latency(CryptoFeedConfig *config, const char *spec) {
+    int service_cpu = -1, housekeeping_cpu = -1, busy_poll_us = LOW_LATENCY_BUSY_POLL_US;
+    char buffer[128];
+    snprintf(buffer, sizeof(buffer), "%s", spec);
+
+    char *save = NULL;
+    for (char *item = strtok_r(buffer, ",", &save); item; item = strtok_r(NULL, ",", &save)) {
+        char *eq = strchr(item, '=');
+        if (strcmp(item, "on") == 0) continue;
+        if (!eq) {
+            printf("[ERROR] Invalid low-latency option \"%s\"\n", item);
+            return -1;
+        }
+        *eq = '\0';
+        int value = atoi(eq + 1);
+        if (strcmp(item, "service") == 0) service_cpu = value;
+        else if (strcmp(item, "housekeeping") == 0) housekeeping_cpu = value;
+        else if (strcmp(item, "busy_poll") == 0) busy_poll_us = value;
+        else {
+            printf("[ERROR] Unknown low-latency option \"%s\"\n", item);
+            return -1;
+        }
+    }
+
+    config->low_latency = 1;
+    config->service_cpu = service_cpu;
+    config->housekeeping_cpu = housekeeping_cpu;
+    config->busy_poll_us = busy_poll_us;
+    return 0;
+}
+
+/* Ask OpenSSL to install the session keys into the kernel after each handshake, when both sides support it */
+static void request_ktls(struct lws_context_creation_info *info) {
+#if defined(LWS_WITH_TLS) && !defined(LWS_WITH_MBEDTLS) && defined(SSL_OP_ENABLE_KTLS)
+    if (!kernel_tls_available()) {
+        printf("[WARNING] kTLS requested but the kernel tls module is not loaded (modprobe tls), decrypting in user space\n");
+        return;
+    }
+    info->ssl_client_options_set |= SSL_OP_ENABLE_KTLS;
+    set_ktls_requested(1);
+    printf("[INFO] kTLS requested: inbound records will be decrypted by the kernel where the cipher allows\n");
+#else
+    (void)info;
+    printf("[WARNING] kTLS requested but this OpenSSL / libwebsockets build has no kTLS support, decrypting in user space\n");
+#endif
+}
+
+int cryptofeed_config_price_filter(CryptoFeedConfig *config, const char *mode) {
+    int parsed = price_filter_parse_mode(mode);
+    if (parsed < 0) {
+        printf("[ERROR] Unknown price filter mode \"%s\" (off, flag or quarantine)\n", mode);
+        return -1;
+    }
+    config->price_filter = parsed;
+    return 0;
+}
+
+static int open_json_logs() {
+    ticker_data_file = fopen("ticker_output_data.json", "a");
+    if (!ticker_data_file) {
+        printf("[ERROR] Failed to open ticker log file\n");
+        return -1;
+    }
+
+    trades_data_file = fopen("trades_output_data.json", "a");
+    if (!trades_data_file) {
+        printf("[ERROR] Failed to open trades log file\n");
+        fclose(ticker_data_file);
+        ticker_data_file = NULL;
+        return -1;
+    }
+
+    // Reload recent entries from the previous session
+    init_json_buffers();
+    return 0;
+}
+
+static void close_json_logs() {
+    if (!ticker_data_file) return;
+    flush_buffer_to_file("ticker_output_data.json", ticker_buffer);
+    flush_buffer_to_file("trades_output_data.json", trades_buffer);
+    fclose(ticker_data_file);
+    fclose(trades_data_file);
+    ticker_data_file = NULL;
+    trades_data_file = NULL;
+}
+
+CryptoFeed *cryptofeed_create(const CryptoFeedConfig *config) {
+    if (active_feed) {
+        printf("[ERROR] A CryptoFeed already exists in this process\n");
+        return NULL;
+    }
+
+    CryptoFeed *feed = calloc(1, sizeof(*feed));
+    if (!feed) {
+        printf("[ERROR] Memory allocation failed for CryptoFeed\n");
+        return NULL;
+    }
+    if (config)
+        feed->config = *config;
+    else
+        cryptofeed_default_config(&feed->config);
+
+    /* One protocol per adapter connection; the context keeps pointing at this table */
+    if (register_exchange_protocols(feed->config.exchanges) <= 0) {
+        printf("[ERROR] No exchange adapters registered%s%s\n",
+               feed->config.exchanges ? " for " : "", feed->config.exchanges ? feed->config.exchanges : "");
+        free(feed);
+        return NULL;
+    }
+
+    struct lws_context_creation_info context_info;
+    memset(&context_info, 0, sizeof(context_info));
+    context_info.port = CONTEXT_PORT_NO_LISTEN;
+    context_info.protocols = protocols;
+    context_info.extensions = ws_extensions;
+    context_info.options = LWS_SERVER_OPTION_DO_SSL_GLOBAL_INIT;
+#if defined(LWS_WITH_TLS_SESSIONS)
+    // Cache TLS sessions per host so reconnects resume instead of doing a full handshake
+    context_info.tls_session_timeout = TLS_SESSION_TIMEOUT_SEC;
+    context_info.tls_session_cache_max = TLS_SESSION_CACHE_MAX;
+#else
+    printf("[WARNING] libwebsockets was built without LWS_WITH_TLS_SESSIONS: every reconnect does a full TLS handshake\n");
+#endif
+    if (feed->config.ktls) request_ktls(&context_info);
+
+    context = lws_create_context(&context_info);
+    if (!context) {
+        printf("[ERROR] Failed to create WebSocket context\n");
+        free(feed);
+        return NULL;
+    }
+
+    if (feed->config.log_json && open_json_logs() != 0) {
+        lws_context_destroy(context);
+        context = NULL;
+        free(feed);
+        return NULL;
+    }
+
+    // Per-symbol feed profiles decide which quote channel each subscription uses
+    const char *profiles = feed->config.feed_profiles_file ? feed->config.feed_profiles_file : FEED_PROFILES_FILE;
+    if (load_feed_profiles(profiles) < 0) {
+        printf("[ERROR] Failed to load feed profiles\n");
+        close_json_logs();
+        lws_context_destroy(context);
+        context = NULL;
+        free(feed);
+        return NULL;
+    }
+
+    // Shared-memory outputs for local consumers; the feed still runs without them.
+    // A stage that fails to start is switched off, so destroy only stops what this feed started.
+    if (feed->config.quote_table && quote_publisher_start(QUOTE_TABLE_NAME) != 0) {
+        printf("[WARNING] Shared-memory quote table disabled\n");
+        feed->config.quote_table = 0;
+    }
+    const char *ring_name = feed->config.tick_ring_name ? feed->config.tick_ring_name : TICK_RING_NAME;
+    if (feed->config.tick_ring && tick_publisher_start(ring_name) != 0) {
+        printf("[WARNING] Shared-memory tick ring disabled\n");
+        feed->config.tick_ring = 0;
+    }
+    if (feed->config.price_filter && price_filter_start(feed->config.price_filter) != 0) {
+        printf("[WARNING] Price filter disabled\n");
+        feed->config.price_filter = PRICE_FILTER_OFF;
+    }
+    if (feed->config.arbitrage && arb_detector_start(feed->config.taker_fees) != 0) {
+        printf("[WARNING] Arbitrage detector disabled\n");
+        feed->config.arbitrage = 0;
+    }
+    if (feed->config.usd_pricing) currency_graph_start();
+    feed->config.composite_index = feed->config.composite_index && feed->config.usd_pricing;
+    if (feed->config.composite_index) composite_index_start();
+    if (feed->config.alerts && alert_engine_start(feed->config.alert_rules_file) != 0) {
+        printf("[WARNING] Alerts disabled\n");
+        feed->config.alerts = 0;
+    }
+    if (feed->config.classify_trades) trade_classifier_start();
+    if (feed->config.analytics && trade_analytics_start(ANALYTICS_TABLE_NAME, ANALYTICS_OUTPUT_DIR) != 0) {
+        printf("[WARNING] Trade analytics disabled\n");
+        feed->config.analytics = 0;
+    }
+
+    active_feed = feed;
+    return feed;
+}
+
+static int add_callback(CallbackList *list, cryptofeed_record_cb cb, void *user) {
+    if (!cb || list->count == CRYPTOFEED_MAX_CALLBACKS) return -1;
+    list->cb[list->count] = cb;
+    list->user[list->count] = user;
+    list->count++;
+    return 0;
+}
+
+int cryptofeed_on_ticker(CryptoFeed *feed, cryptofeed_record_cb cb, void *user) {
+    return add_callback(&feed->ticker, cb, user);
+}
+
+int cryptofeed_on_book(CryptoFeed *feed, cryptofeed_record_cb cb, void *user) {
+    return add_callback(&feed->book, cb, user);
+}
+
+int cryptofeed_on_trade(CryptoFeed *feed, cryptofeed_record_cb cb, void *user) {
+    return add_callback(&feed->trade, cb, user);
+}
+
+int cryptofeed_start(CryptoFeed *feed) {
+    if (feed->started) return 0;
+
+    if (feed->config.low_latency) {
+        if (feed->config.service_cpu >= 0 && pin_current_thread(feed->config.service_cpu) != 0)
+            printf("[WARNING] Failed to pin the service thread to CPU %d\n", feed->config.service_cpu);
+        dns_cache_set_cpu(feed->config.housekeeping_cpu);
+        enable_low_latency_mode(feed->config.busy_poll_us);
+        printf("[INFO] Low-latency mode: service thread on CPU %d, DNS thread on CPU %d, busy poll %d us\n",
+               feed->config.service_cpu, feed->config.housekeeping_cpu, feed->config.busy_poll_us);
+    }
+
+    // Register connections; the orchestrator opens them from inside the event loop
+    // and also runs the connection health checks
+    start_exchange_connections(feed->config.shard_index, feed->config.shard_count);
+    feed->started = 1;
+    return 0;
+}
+
+int cryptofeed_service(CryptoFeed *feed, int timeout_ms) {
+    if (feed->stopping) return -1;
+
+    /* A negative timeout makes lws poll without waiting */
+    int result = lws_service(context, feed->config.low_latency ? -1 : timeout_ms);
+    if (feed->config.low_latency) record_service_pass();
+
+    /* Periodic stage work, shared by both modes */
+    if (feed->config.analytics) trade_analytics_poll();
+    if (feed->config.arbitrage) arb_detector_poll();
+    if (feed->config.usd_pricing) currency_graph_poll();
+    if (feed->config.composite_index) composite_index_poll();
+    if (feed->config.alerts) alert_engine_poll();
+    return result < 0 ? -1 : 0;
+}
+
+int cryptofeed_run(CryptoFeed *feed) {
+    cryptofeed_start(feed);
+
+    // Event loop: Handles incoming WebSocket messages and reconnections
+    while (cryptofeed_service(feed, 10) == 0) {}
+
+    return feed->stopping ? 0 : -1;
+}
+
+void cryptofeed_stop(CryptoFeed *feed) {
+    feed->stopping = 1;
+    if (context) lws_cancel_service(context);
+}
+
+void cryptofeed_destroy(CryptoFeed *feed) {
+    if (!feed) return;
+
+    /* Only stop what this feed started: a supervised collector inherits the aggregator's
+     * publishers and detectors through fork() and must leave them alone */
+    if (feed->config.log_json) close_json_logs();
+    if (feed->config.quote_table) quote_publisher_stop();
+    if (feed->config.tick_ring) tick_publisher_stop();
+    if (feed->config.analytics) trade_analytics_stop();
+    if (feed->config.price_filter) price_filter_stop();
+    if (feed->config.arbitrage) arb_detector_stop();
+    if (feed->config.alerts) alert_engine_stop();
+    if (feed->config.classify_trades) trade_classifier_stop();
+    if (feed->config.composite_index) composite_index_stop();
+    if (feed->config.usd_pricing) currency_graph_stop();
+    lws_context_destroy(context);
+    context = NULL;
+
+    if (active_feed == feed) active_feed = NULL;
+    free(feed);
+}
+
+static void dispatch(const CallbackList *list, const MarketRecord *record) {
+    for (int i = 0; i < list->count; i++)
+        list->cb[i](record, list->user[i]);
+}
+
+/* Run the price filter and feed the record to the clean-record stages, pricing it in USD (0 = unknown);
+ * returns 1 if the record is an outlier that must not reach any output */
+static int screen_record(const CryptoFeed *feed, MarketRecord *record, double *usd_price) {
+    int id = symbol_registry_id(record->exchange, record->symbol);
+    int outlier = feed->config.price_filter != PRICE_FILTER_OFF && price_filter_check(record, id);
+    if (outlier && feed->config.price_filter == PRICE_FILTER_QUARANTINE) {
+        price_filter_quarantine(record);
+        return 1;
+    }
+    if (id >= 0) *usd_price = cryptofeed_run_clean_stages(&feed->config, id, record, outlier);
+    return 0;
+}
+
+double cryptofeed_run_clean_stages(const CryptoFeedConfig *config, int id, MarketRecord *record, int outlier) {
+    if (!outlier) {
+        if (config->classify_trades && record->kind == MARKET_RECORD_TRADE) trade_classifier_classify(id, record);
+        symbol_registry_update(id, record);
+        if (config->arbitrage && (record->bid > 0 || record->ask > 0)) arb_detector_quote(id, record->recv_ns);
+        if (config->usd_pricing) currency_graph_update(id, record->recv_ns);
+        if (config->composite_index) composite_index_update(id, record);
+    }
+    double usd_price = (config->usd_pricing && record->price > 0) ? currency_graph_usd(id, record->price) : 0.0;
+    if (!outlier && config->alerts) alert_engine_check(id, record, usd_price);
+    return usd_price;
+}
+
+double cryptofeed_usd_price(const MarketRecord *record) {
+    CryptoFeed *feed = active_feed;
+    if (!feed || !feed->config.usd_pricing || record->price <= 0) return 0.0;
+    int id = symbol_registry_id(record->exchange, record->symbol);
+    return id >= 0 ? currency_graph_usd(id, record->price) : 0.0;
+}
+
+void cryptofeed_emit_ticker(TickerData *ticker) {
+    CryptoFeed *feed = active_feed;
+    if (!feed) return;
+
+    MarketRecord record;
+    double usd_price = 0.0;
+    int have_record = (feed->config.tick_ring || feed->config.price_filter || feed->config.arbitrage ||
+                       feed->config.usd_pricing || feed->config.alerts || feed->ticker.count || feed->book.count) &&
+                      market_record_from_ticker(ticker, &record);
+    if (have_record && screen_record(feed, &record, &usd_price)) return;
+
+    if (feed->config.quote_table) quote_publisher_ticker(ticker, usd_price);
+
+    if (have_record) {
+        if (feed->config.tick_ring) tick_publisher_write(&record);
+        dispatch(record.kind == MARKET_RECORD_QUOTE ? &feed->book : &feed->ticker, &record);
+    }
+
+    if (feed->config.log_json) log_ticker_price(ticker);
+    if (feed->config.log_bson) write_ticker_to_bson(ticker);
+}
+
+void cryptofeed_emit_trade(TradeData *trade) {
+    CryptoFeed *feed = active_feed;
+    if (!feed) return;
+
+    MarketRecord record;
+    double usd_price = 0.0;
+    int have_record = (feed->config.tick_ring || feed->config.analytics || feed->config.price_filter ||
+                       feed->config.arbitrage || feed->config.usd_pricing || feed->config.alerts ||
+                       feed->config.classify_trades || feed->trade.count) &&
+                      market_record_from_trade(trade, &record);
+    if (have_record && screen_record(feed, &record, &usd_price)) return;
+
+    /* Same convention as the venues that report it: "true" when the buyer was the maker */
+    if (have_record && !trade->market_maker[0] && record.side != MARKET_SIDE_UNKNOWN)
+        snprintf(trade->market_maker, sizeof(trade->market_maker), "%s",
+                 record.side == MARKET_SIDE_SELL ? "true" : "false");
+
+    if (feed->config.quote_table) quote_publisher_trade(trade, usd_price);
+
+    if (have_record) {
+        if (feed->config.tick_ring) tick_publisher_write(&record);
+        if (feed->config.analytics) trade_analytics_record(&record);
+        dispatch(&feed->trade, &record);
+    }
+
+    if (feed->config.log_json)
+        log_trade_price(trade->timestamp, trade->exchange, trade->currency,
+                        trade->price, trade->size, trade->trade_id, trade->market_maker);
+    if (feed->config.log_bson) write_trade_to_bson(trade);
+}
@@ -0,0 +1,134 @@
+/*
+ * Crypto Feed Library Header
+ *
+ * Public API of `libcryptofeed`, the connection, parse and normalize engine
+ * behind `crypto_ws`, for applications that want market data in-process
+ * instead of through files or shared memory.
+ *
+ * Features:
+ *  - `CryptoFeed`: explicit context owning the lws context, outputs and
+ *    registered callbacks.
+ *  - Typed callbacks for tickers, top-of-book quotes and trades, each
+ *    receiving a `MarketRecord` (`market_record.h`). They run on the thread
+ *    that services the feed, right after the message is parsed; the record
+ *    is only valid for the duration of the call.
+ *  - Every built-in output (JSON/BSON logs, shared-memory quote table and
+ *    tick ring, rolling trade analytics, arbitrage detector) can be
+ *    switched off, so an
+ *    embedding app pays only for the parse and its own callbacks.
+ *  - Either hand the thread to `cryptofeed_run()` or call
+ *    `cryptofeed_service()` from an existing loop.
+ *  - Optional low-latency mode: the service thread is pinned and spins on
+ *    non-blocking passes instead of sleeping in poll(), sockets busy-poll,
+ *    and the 60 s statistics add a service-loop jitter line.
+ *  - A median/MAD price filter flags bad ticks (`MARKET_FLAG_OUTLIER`) or
+ *    keeps them out of every output and callback.
+ *  - Optional kTLS: inbound TLS records are decrypted by the kernel instead
+ *    of on the service thread, falling back to user space per connection.
+ *
+ * Limitations:
+ *  - One feed per process: the connection registry, retry state and
+ *    symbol tables are process-wide.
+ *  - Symbol lists are read from `currency_text_files/` relative to the
+ *    working directory (written by `fetch_currency_id`).
+ *
+ * Dependencies:
+ *  - market_record.h. Link with `libcryptofeed.a` and the libraries listed
+ *    in the makefile's `LIBS`.
+ *
+ * Usage:
+ *        CryptoFeedConfig config;
+ *        cryptofeed_default_config(&config);
+ *        config.log_json = config.log_bson = 0;
+ *        CryptoFeed *feed = cryptofeed_create(&config);
+ *        cryptofeed_on_trade(feed, my_trade_handler, my_state);
+ *        cryptofeed_run(feed);                  // until cryptofeed_stop()
+ *        cryptofeed_destroy(feed);
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#ifndef CRYPTOFEED_H
+#define CRYPTOFEED_H
+
+#include "market_record.h"
+
+#define CRYPTOFEED_MAX_CALLBACKS 8      // per record kind
+
+typedef struct CryptoFeed CryptoFeed;
+
+/* Called on the service thread for every parsed record of the registered kind */
+typedef void (*cryptofeed_record_cb)(const MarketRecord *record, void *user);
+
+typedef struct {
+    const char *feed_profiles_file; // NULL = FEED_PROFILES_FILE
+    int log_json;                   // ticker_output_data.json / trades_output_data.json
+    int log_bson;                   // bson_output/
+    int quote_table;                // /dev/shm latest-quote table
+    int tick_ring;                  // /dev/shm tick ring
+    const char *tick_ring_name;     // NULL = TICK_RING_NAME
+    int analytics;                  // rolling VWAP/volatility/flow: /dev/shm table and analytics_output/ snapshots
+    int price_filter;               // PriceFilterMode: 0 = off, 1 = flag outliers (default), 2 = quarantine them
+    int arbitrage;                  // cross-venue dislocation detector: arbitrage_output_data.json
+    const char *taker_fees;         // arbitrage fee overrides in bps, e.g. "binance=0,okx=8"; NULL = adapter defaults
+    int usd_pricing;                // currency graph: USD price of every tick (quote table, cryptofeed_usd_price)
+    int composite_index;            // per-asset USD index: index_output_data.json; needs usd_pricing
+    int alerts;                     // rule-based alerts: alerts_output_data.json
+    const char *alert_rules_file;   // NULL = ALERT_RULES_FILE, reloaded when it changes
+    int classify_trades;            // infer the aggressor (side / market_maker) of trades the venue leaves unlabelled
+
+    /* Collect a subset, e.g. one shard of a supervised collector (`supervisor.h`) */
+    const char *exchanges;          // comma-separated adapter names ("binance,okx"), NULL = all
+    int shard_index;                // open only chunks with chunk % shard_count == shard_index
+    int shard_count;                // 1 = every chunk
+
+    /* Low-latency mode: burns one core to cut wake-up latency (see `cryptofeed_config_low_latency`) */
+    int low_latency;                // 0 = sleep in poll() between events (default)
+    int service_cpu;                // core for the thread that calls cryptofeed_start(), -1 = not pinned
+    int housekeeping_cpu;           // core for the DNS resolver thread, -1 = not pinned
+    int busy_poll_us;               // SO_BUSY_POLL on each connection, 0 = off
+
+    int ktls;                       // ask OpenSSL for kernel TLS offload (needs the `tls` module), 0 = off
+} CryptoFeedConfig;
+
+/* Every output enabled, as `crypto_ws` runs */
+void cryptofeed_default_config(CryptoFeedConfig *config);
+
+/* Enable low-latency mode from a spec such as "on" or "service=3,housekeeping=0,busy_poll=50";
+ * returns 0, or -1 on an unknown key (config left unchanged) */
+int cryptofeed_config_low_latency(CryptoFeedConfig *config, const char *spec);
+
+/* Set the price filter from "off", "flag" or "quarantine"; returns 0, or -1 if unknown (config left unchanged) */
+int cryptofeed_config_price_filter(CryptoFeedConfig *config, const char *mode);
+
+/* Create the feed; NULL on error or if a feed already exists in this process */
+CryptoFeed *cryptofeed_create(const CryptoFeedConfig *config);
+
+/* Register callbacks; returns 0, or -1 once CRYPTOFEED_MAX_CALLBACKS are registered for that kind */
+int cryptofeed_on_ticker(CryptoFeed *feed, cryptofeed_record_cb cb, void *user);
+int cryptofeed_on_book(CryptoFeed *feed, cryptofeed_record_cb cb, void *user);
+int cryptofeed_on_trade(CryptoFeed *feed, cryptofeed_record_cb cb, void *user);
+
+/* Price of a record in USD through the currency graph; 0 if its quote asset has no path to USD yet.
+ * Call from a callback (service thread). */
+double cryptofeed_usd_price(const MarketRecord *record);
+
+/* Open the exchange connections (rate-limited, from inside the service loop).
+ * In low-latency mode, call it from the thread that will service the feed: that thread is pinned here. */
+int cryptofeed_start(CryptoFeed *feed);
+
+/* Service the feed for up to `timeout_ms`; returns -1 once it is stopped or failed.
+ * In low-latency mode the timeout is ignored and every call returns without waiting. */
+int cryptofeed_service(CryptoFeed *feed, int timeout_ms);
+
+/* Start and service the feed until `cryptofeed_stop()`; returns 0 on a clean stop */
+int cryptofeed_run(CryptoFeed *feed);
+
+/* Ask `cryptofeed_run()` / `cryptofeed_service()` to return; safe from any thread or a signal handler */
+void cryptofeed_stop(CryptoFeed *feed);
+
+/* Flush and close outputs and free the feed */
+void cryptofeed_destroy(CryptoFeed *feed);
+
+#endif // CRYPTOFEED_H
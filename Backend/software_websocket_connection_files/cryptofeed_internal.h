@@ -0,0 +1,34 @@
+/*
+ * Crypto Feed Internal Header
+ *
+ * Hooks between the parse engine and the `CryptoFeed` context; not part of
+ * the public `cryptofeed.h` API.
+ *
+ * Usage:
+ *  - Implemented in `cryptofeed.c`.
+ *  - Called by the exchange handlers in `exchange_websocket.c` for every
+ *    parsed ticker, quote and trade.
+ *  - `cryptofeed_run_clean_stages()` is also called by the supervisor's
+ *    aggregator (`supervisor.c`), so both paths run the same stages.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#ifndef CRYPTOFEED_INTERNAL_H
+#define CRYPTOFEED_INTERNAL_H
+
+#include "exchange_websocket.h"
+#include "cryptofeed.h"
+#include "market_record.h"
+
+/* Fan a parsed ticker / top-of-book quote or trade out to the enabled outputs and callbacks */
+void cryptofeed_emit_ticker(TickerData *ticker);
+void cryptofeed_emit_trade(TradeData *trade);
+
+/* Feed a screened record of registry id `id` to the stages enabled in `config`: trade classifier, symbol
+ * registry, arbitrage detector, currency graph, composite index and alerts. Outliers only get their USD
+ * price. Returns the record's USD price (0 = unknown). */
+double cryptofeed_run_clean_stages(const CryptoFeedConfig *config, int id, MarketRecord *record, int outlier);
+
+#endif // CRYPTOFEED_INTERNAL_H
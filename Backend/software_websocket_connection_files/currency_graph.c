@@ -0,0 +1,227 @@
+/*
+ * Currency Graph
+ *
+ * Implements the USD cross-rate graph of `currency_graph.h`. Edges are
+ * registry pairs (indexed by pair id), nodes are registry assets (indexed
+ * by asset id); adjacency is an intrusive list over the two ends of each
+ * pair, so nothing is allocated after start.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#include "currency_graph.h"
+#include "symbol_registry.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct {
+    double rate;                    // quote units per base unit
+    int64_t rate_ns;
+    int live;                       // part of the graph (has a fresh rate)
+} Edge;
+
+typedef struct {
+    double usd;                     // USD per unit, 0 = no path
+    int parent;                     // pair id of the edge towards USD, -1 for the root or no path
+    int hops;                       // conversions to USD, -1 = no path
+} AssetPath;
+
+static Edge edges[SYMBOL_REGISTRY_PAIRS];
+static AssetPath paths[SYMBOL_REGISTRY_ASSETS];
+
+/* Adjacency: entry 2 * pair is the base end of a pair, 2 * pair + 1 its quote end */
+static int adj_head[SYMBOL_REGISTRY_ASSETS];
+static int adj_next[2 * SYMBOL_REGISTRY_PAIRS];
+static int linked_pairs = 0;
+
+static int work[SYMBOL_REGISTRY_ASSETS];    // BFS queue / DFS stack
+static int root = -1;
+static int64_t next_sweep_ns = 0, next_report_ns = 0;
+static unsigned long long rebuilds = 0, repriced = 0;
+
+static int64_t realtime_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/* The asset at the other end of adjacency entry `entry` */
+static int other_end(int entry) {
+    const PairInfo *pair = symbol_registry_pair(entry >> 1);
+    return (entry & 1) ? pair->base_id : pair->quote_id;
+}
+
+/* USD value of `child`, reached from `from` (priced) over `pair` */
+static double convert(int pair, int child, double from_usd) {
+    const PairInfo *p = symbol_registry_pair(pair);
+    return child == p->base_id ? edges[pair].rate * from_usd : from_usd / edges[pair].rate;
+}
+
+/* Among equally short paths, prefer the edge more venues quote */
+static int better_edge(int pair, int current) {
+    int a = symbol_registry_pair(pair)->venue_count, b = symbol_registry_pair(current)->venue_count;
+    return a > b || (a == b && pair < current);
+}
+
+/* Whether live edge `pair` would give `to` a shorter path than it has through `from`, or an equally short one
+ * over a better edge */
+static int improves(int pair, int from, int to) {
+    if (paths[from].hops < 0 || paths[from].hops == CURRENCY_GRAPH_MAX_HOPS) return 0;
+    int hops = paths[from].hops + 1;
+    return paths[to].hops < 0 || hops < paths[to].hops || (hops == paths[to].hops && better_edge(pair, paths[to].parent));
+}
+
+/* Add pairs the registry created since the last call to the adjacency lists */
+static void link_new_pairs() {
+    int count = symbol_registry_pair_count();
+    for (; linked_pairs < count; linked_pairs++) {
+        const PairInfo *pair = symbol_registry_pair(linked_pairs);
+        if (pair->base_id < 0 || pair->quote_id < 0 || pair->base_id == pair->quote_id) continue;
+        adj_next[2 * linked_pairs] = adj_head[pair->base_id];
+        adj_head[pair->base_id] = 2 * linked_pairs;
+        adj_next[2 * linked_pairs + 1] = adj_head[pair->quote_id];
+        adj_head[pair->quote_id] = 2 * linked_pairs + 1;
+    }
+}
+
+/* Breadth-first search from USD over live edges: shortest paths, ties to the better edge */
+static void rebuild() {
+    for (int a = 0; a < SYMBOL_REGISTRY_ASSETS; a++) paths[a] = (AssetPath){0.0, -1, -1};
+    rebuilds++;
+
+    root = symbol_registry_asset_id(CURRENCY_GRAPH_ROOT);
+    if (root < 0) return;
+    paths[root].usd = 1.0;
+    paths[root].hops = 0;
+
+    int head = 0, tail = 0;
+    work[tail++] = root;
+    while (head < tail) {
+        int u = work[head++];
+        if (paths[u].hops == CURRENCY_GRAPH_MAX_HOPS) continue;
+
+        for (int entry = adj_head[u]; entry >= 0; entry = adj_next[entry]) {
+            int pair = entry >> 1;
+            if (!edges[pair].live) continue;
+            int v = other_end(entry);
+
+            /* Nodes one level down are expanded only after this whole level, so re-parenting is safe */
+            if (paths[v].hops < 0) {
+                work[tail++] = v;
+            } else if (paths[v].hops != paths[u].hops + 1 || !better_edge(pair, paths[v].parent)) {
+                continue;
+            }
+            paths[v].hops = paths[u].hops + 1;
+            paths[v].parent = pair;
+            paths[v].usd = convert(pair, v, paths[u].usd);
+        }
+    }
+}
+
+/* Re-price everything below `asset` in the tree after its own price changed */
+static void propagate(int asset) {
+    int top = 0;
+    work[top++] = asset;
+    while (top > 0) {
+        int u = work[--top];
+        for (int entry = adj_head[u]; entry >= 0; entry = adj_next[entry]) {
+            int v = other_end(entry);
+            if (paths[v].parent != (entry >> 1) || v == root) continue;
+            paths[v].usd = convert(entry >> 1, v, paths[u].usd);
+            work[top++] = v;
+            repriced++;
+        }
+    }
+}
+
+void currency_graph_start() {
+    memset(edges, 0, sizeof(edges));
+    for (int a = 0; a < SYMBOL_REGISTRY_ASSETS; a++) {
+        adj_head[a] = -1;
+        paths[a] = (AssetPath){0.0, -1, -1};
+    }
+    linked_pairs = 0;
+    root = -1;
+    rebuilds = repriced = 0;
+    next_sweep_ns = next_report_ns = 0;
+}
+
+void currency_graph_update(int id, int64_t now) {
+    int pair = symbol_registry_info(id)->pair;
+    if (pair < 0) return;
+    if (pair >= linked_pairs) link_new_pairs();
+
+    double rate = symbol_quote_price(&symbol_registry_info(id)->quote);
+    if (rate <= 0) return;
+
+    Edge *e = &edges[pair];
+    e->rate = rate;
+    e->rate_ns = now;
+    const PairInfo *p = symbol_registry_pair(pair);
+    if (p->base_id < 0 || p->quote_id < 0 || p->base_id == p->quote_id) return;
+    if (!e->live) {
+        /* A revived edge joins the tree only if it shortens a path; otherwise the tree stands as it is */
+        e->live = 1;
+        if (root < 0 || improves(pair, p->base_id, p->quote_id) || improves(pair, p->quote_id, p->base_id)) rebuild();
+        return;
+    }
+
+    /* Only a tree edge moves prices: re-price its child end and the subtree below it */
+    int child = paths[p->base_id].parent == pair ? p->base_id : paths[p->quote_id].parent == pair ? p->quote_id : -1;
+    if (child < 0) return;
+    int from = child == p->base_id ? p->quote_id : p->base_id;
+    paths[child].usd = convert(pair, child, paths[from].usd);
+    repriced++;
+    propagate(child);
+}
+
+double currency_graph_usd(int id, double price) {
+    int pair = symbol_registry_info(id)->pair;
+    if (pair < 0) return 0.0;
+    int quote = symbol_registry_pair(pair)->quote_id;
+    return quote >= 0 ? price * paths[quote].usd : 0.0;
+}
+
+double currency_graph_asset_usd(const char *asset) {
+    int id = symbol_registry_asset_id(asset);
+    return id >= 0 ? paths[id].usd : 0.0;
+}
+
+static void report(int64_t now) {
+    int assets = symbol_registry_asset_count(), priced = 0, live = 0;
+    for (int a = 0; a < assets; a++) priced += paths[a].hops >= 0;
+    for (int p = 0; p < linked_pairs; p++) live += edges[p].live;
+
+    printf("[STATS] currency graph: %d of %d assets priced in USD over %d live pairs, %llu rebuilds, %llu re-priced\n",
+           priced, assets, live, rebuilds, repriced);
+    rebuilds = repriced = 0;
+    next_report_ns = now + (int64_t)CURRENCY_GRAPH_REPORT_MS * 1000000;
+}
+
+void currency_graph_poll() {
+    int64_t now = realtime_ns();
+    if (now < next_sweep_ns) return;
+    next_sweep_ns = now + (int64_t)CURRENCY_GRAPH_SWEEP_MS * 1000000;
+
+    /* Stale non-tree edges just leave the graph; a stale tree edge needs new paths */
+    int64_t stale_before = now - (int64_t)CURRENCY_GRAPH_STALE_MS * 1000000;
+    int dirty = 0;
+    for (int p = 0; p < linked_pairs; p++) {
+        if (!edges[p].live || edges[p].rate_ns >= stale_before) continue;
+        edges[p].live = 0;
+        const PairInfo *pair = symbol_registry_pair(p);
+        if (paths[pair->base_id].parent == p || paths[pair->quote_id].parent == p) dirty = 1;
+    }
+    if (dirty) rebuild();
+
+    if (!next_report_ns) next_report_ns = now + (int64_t)CURRENCY_GRAPH_REPORT_MS * 1000000;
+    else if (now >= next_report_ns) report(now);
+}
+
+void currency_graph_stop() {
+    if (next_report_ns) report(realtime_ns());
+    next_report_ns = 0;
+}
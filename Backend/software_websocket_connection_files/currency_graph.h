@@ -0,0 +1,64 @@
+/*
+ * Currency Graph Header
+ *
+ * Declares the cross-rate graph that turns any price into USD: assets are
+ * nodes, every normalized pair quoted by any venue is an edge carrying its
+ * latest rate, and each asset is priced along its best path to USD.
+ *
+ * Features:
+ *  - Rates come from the symbol registry (`symbol_registry.h`): the mid of
+ *    the venue that updated the pair last, or its last price when it has
+ *    no fresher bid/ask. USDT, USDC, EUR, ... are priced through their own
+ *    pairs, not assumed to be USD.
+ *  - The best path is the one with the fewest conversions (at most
+ *    CURRENCY_GRAPH_MAX_HOPS); among equally short paths the edge quoted
+ *    by more venues wins. The paths form a tree rooted at USD.
+ *  - Incremental: a rate change on a tree edge re-prices only the subtree
+ *    below it; a rate change on any other edge costs nothing. The tree is
+ *    rebuilt (one BFS) only when an edge appears or comes back from stale
+ *    and gives an asset a shorter or better path, or when a tree edge has
+ *    not updated for CURRENCY_GRAPH_STALE_MS and is dropped.
+ *
+ * Dependencies:
+ *  - symbol_registry.h.
+ *
+ * Usage:
+ *  - `cryptofeed.c` (or the supervisor's aggregator) calls
+ *    `currency_graph_update()` after each clean registry update and
+ *    `currency_graph_usd()` to price the record; `currency_graph_poll()`
+ *    runs after every service pass. Service thread only.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#ifndef CURRENCY_GRAPH_H
+#define CURRENCY_GRAPH_H
+
+#include <stdint.h>
+
+#define CURRENCY_GRAPH_ROOT "USD"
+#define CURRENCY_GRAPH_MAX_HOPS 4               // longest conversion path used
+#define CURRENCY_GRAPH_STALE_MS 60000           // rates older than this are dropped from the graph
+#define CURRENCY_GRAPH_SWEEP_MS 1000            // staleness check interval
+#define CURRENCY_GRAPH_REPORT_MS 60000
+
+/* Reset the graph */
+void currency_graph_start();
+
+/* Take the latest rate of registry id `id` (already updated) into its pair's edge at `now_ns` */
+void currency_graph_update(int id, int64_t now_ns);
+
+/* `price`, quoted in the quote asset of registry id `id`, in USD; 0 if that asset has no path to USD */
+double currency_graph_usd(int id, double price);
+
+/* USD value of one unit of `asset` ("ETH"), 0 if it has no path to USD */
+double currency_graph_asset_usd(const char *asset);
+
+/* Drop stale edges and report; cheap to call after every service pass */
+void currency_graph_poll();
+
+/* Report totals */
+void currency_graph_stop();
+
+#endif // CURRENCY_GRAPH_H
@@ -0,0 +1,233 @@
+/*
+ * DNS Cache
+ *
+ * Keeps resolved addresses for the exchange hosts so that reconnects go
+ * straight to TCP/TLS. A background thread owns all `getaddrinfo()` calls;
+ * the service thread only copies the cached answer under a mutex.
+ *
+ * Features:
+ *  - Up to `DNS_CACHE_MAX_ADDRS` addresses per host, one of them preferred.
+ *    Sticking to one address keeps TLS sessions resumable, since the lws
+ *    session cache is keyed per peer.
+ *  - Refresh at 80% of the TTL, keeping the previous answer on failure.
+ *  - Rotation to the next address after a connection error.
+ *  - Static pins from `CRYPTO_WS_RESOLVE` for testing against local servers.
+ *  - The resolver thread can be kept off the service thread's core
+ *    (low-latency mode).
+ *
+ * Dependencies:
+ *  - POSIX libraries (netdb, arpa/inet, pthread).
+ *
+ * Usage:
+ *  - `exchange_connect.c` registers the enabled hosts, starts the resolver
+ *    and looks addresses up when opening connections.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#include "dns_cache.h"
+#include "sys_stats.h"
+#include "utils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <netdb.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#define DNS_REFRESH_POLL_SEC 1
+#define DNS_RETRY_AFTER_FAILURE_MS 5000
+
+typedef struct {
+    char host[128];
+    char addrs[DNS_CACHE_MAX_ADDRS][INET6_ADDRSTRLEN];
+    int num_addrs;
+    int preferred;
+    int pinned;                     // set from CRYPTO_WS_RESOLVE, never refreshed
+    long long refresh_at_ms;
+} DnsCacheEntry;
+
+static DnsCacheEntry dns_entries[DNS_CACHE_MAX_HOSTS];
+static int num_dns_entries = 0;
+static pthread_mutex_t dns_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t dns_thread;
+static int dns_thread_started = 0;
+static int dns_thread_cpu = -1;
+
+/* Caller holds dns_lock */
+static DnsCacheEntry *find_entry(const char *host) {
+    for (int i = 0; i < num_dns_entries; i++) {
+        if (strcmp(dns_entries[i].host, host) == 0)
+            return &dns_entries[i];
+    }
+    return NULL;
+}
+
+/* Caller holds dns_lock */
+static DnsCacheEntry *add_entry(const char *host) {
+    DnsCacheEntry *entry = find_entry(host);
+    if (entry) return entry;
+    if (num_dns_entries >= DNS_CACHE_MAX_HOSTS) {
+        fprintf(stderr, "[ERROR] DNS cache full, not caching %s\n", host);
+        return NULL;
+    }
+
+    entry = &dns_entries[num_dns_entries++];
+    memset(entry, 0, sizeof(*entry));
+    strncpy(entry->host, host, sizeof(entry->host) - 1);
+    return entry;
+}
+
+void dns_cache_register(const char *host) {
+    pthread_mutex_lock(&dns_lock);
+    add_entry(host);
+    pthread_mutex_unlock(&dns_lock);
+}
+
+/* Parse CRYPTO_WS_RESOLVE="host=address,host=address" into pinned entries */
+static void apply_resolve_overrides() {
+    const char *spec = getenv("CRYPTO_WS_RESOLVE");
+    if (!spec || !*spec) return;
+
+    char *copy = strdup(spec);
+    if (!copy) return;
+
+    char *saveptr = NULL;
+    for (char *item = strtok_r(copy, ",", &saveptr); item; item = strtok_r(NULL, ",", &saveptr)) {
+        char *eq = strchr(item, '=');
+        if (!eq) {
+            fprintf(stderr, "[ERROR] Ignoring CRYPTO_WS_RESOLVE entry '%s' (expected host=address)\n", item);
+            continue;
+        }
+        *eq = '\0';
+
+        pthread_mutex_lock(&dns_lock);
+        DnsCacheEntry *entry = add_entry(item);
+        if (entry) {
+            strncpy(entry->addrs[0], eq + 1, sizeof(entry->addrs[0]) - 1);
+            entry->num_addrs = 1;
+            entry->preferred = 0;
+            entry->pinned = 1;
+        }
+        pthread_mutex_unlock(&dns_lock);
+        printf("[INFO] DNS pinned %s -> %s\n", item, eq + 1);
+    }
+    free(copy);
+}
+
+/* Resolve one host outside the lock and publish the answer */
+static void refresh_entry(const char *host) {
+    struct addrinfo hints = {0};
+    struct addrinfo *res = NULL;
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    char addrs[DNS_CACHE_MAX_ADDRS][INET6_ADDRSTRLEN];
+    int num_addrs = 0;
+
+    int rc = getaddrinfo(host, NULL, &hints, &res);
+    if (rc == 0) {
+        for (struct addrinfo *ai = res; ai && num_addrs < DNS_CACHE_MAX_ADDRS; ai = ai->ai_next) {
+            const void *src = NULL;
+            if (ai->ai_family == AF_INET)
+                src = &((struct sockaddr_in *)ai->ai_addr)->sin_addr;
+            else if (ai->ai_family == AF_INET6)
+                src = &((struct sockaddr_in6 *)ai->ai_addr)->sin6_addr;
+            if (!src || !inet_ntop(ai->ai_family, src, addrs[num_addrs], INET6_ADDRSTRLEN))
+                continue;
+
+            int duplicate = 0;
+            for (int i = 0; i < num_addrs; i++)
+                if (strcmp(addrs[i], addrs[num_addrs]) == 0) duplicate = 1;
+            if (!duplicate) num_addrs++;
+        }
+        freeaddrinfo(res);
+    }
+
+    long long now = get_monotonic_ms();
+    pthread_mutex_lock(&dns_lock);
+    DnsCacheEntry *entry = find_entry(host);
+    if (entry && !entry->pinned) {
+        if (num_addrs > 0) {
+            /* Keep the current preferred address if it is still in the answer */
+            int preferred = 0;
+            if (entry->num_addrs > 0) {
+                for (int i = 0; i < num_addrs; i++)
+                    if (strcmp(addrs[i], entry->addrs[entry->preferred]) == 0) preferred = i;
+            }
+            memcpy(entry->addrs, addrs, sizeof(addrs));
+            entry->num_addrs = num_addrs;
+            entry->preferred = preferred;
+            entry->refresh_at_ms = now + DNS_CACHE_TTL_SEC * 800LL;
+        } else {
+            fprintf(stderr, "[WARNING] DNS lookup for %s failed: %s\n", host, gai_strerror(rc));
+            entry->refresh_at_ms = now + DNS_RETRY_AFTER_FAILURE_MS;
+        }
+    }
+    pthread_mutex_unlock(&dns_lock);
+}
+
+static void *dns_refresh_thread(void *arg) {
+    (void)arg;
+    if (dns_thread_cpu >= 0 && pin_current_thread(dns_thread_cpu) != 0)
+        fprintf(stderr, "[WARNING] Failed to pin DNS cache thread to CPU %d\n", dns_thread_cpu);
+    while (1) {
+        char due[DNS_CACHE_MAX_HOSTS][128];
+        int num_due = 0;
+        long long now = get_monotonic_ms();
+
+        pthread_mutex_lock(&dns_lock);
+        for (int i = 0; i < num_dns_entries; i++) {
+            if (!dns_entries[i].pinned && now >= dns_entries[i].refresh_at_ms)
+                memcpy(due[num_due++], dns_entries[i].host, sizeof(due[0]));
+        }
+        pthread_mutex_unlock(&dns_lock);
+
+        for (int i = 0; i < num_due; i++)
+            refresh_entry(due[i]);
+
+        sleep(DNS_REFRESH_POLL_SEC);
+    }
+    return NULL;
+}
+
+void dns_cache_set_cpu(int cpu) {
+    dns_thread_cpu = cpu;
+}
+
+void dns_cache_start() {
+    if (dns_thread_started) return;
+    apply_resolve_overrides();
+
+    if (pthread_create(&dns_thread, NULL, dns_refresh_thread, NULL) != 0) {
+        fprintf(stderr, "[ERROR] Failed to start DNS cache thread, falling back to per-connect lookups\n");
+        return;
+    }
+    pthread_detach(dns_thread);
+    dns_thread_started = 1;
+}
+
+int dns_cache_lookup(const char *host, char *dest, size_t dest_size) {
+    int found = 0;
+    pthread_mutex_lock(&dns_lock);
+    DnsCacheEntry *entry = find_entry(host);
+    if (entry && entry->num_addrs > 0) {
+        strncpy(dest, entry->addrs[entry->preferred], dest_size - 1);
+        dest[dest_size - 1] = '\0';
+        found = 1;
+    }
+    pthread_mutex_unlock(&dns_lock);
+    return found;
+}
+
+void dns_cache_report_failure(const char *host) {
+    pthread_mutex_lock(&dns_lock);
+    DnsCacheEntry *entry = find_entry(host);
+    if (entry && entry->num_addrs > 1)
+        entry->preferred = (entry->preferred + 1) % entry->num_addrs;
+    pthread_mutex_unlock(&dns_lock);
+}
@@ -0,0 +1,50 @@
+/*
+ * DNS Cache Header
+ *
+ * Declares a small per-host cache of resolved addresses used when opening
+ * exchange connections, so reconnects skip the DNS lookup.
+ *
+ * Features:
+ *  - Hosts are registered once and resolved in the background.
+ *  - Entries are refreshed before their TTL runs out; the last good answer
+ *    is kept if a refresh fails.
+ *  - Lookups never block the event loop.
+ *  - `CRYPTO_WS_RESOLVE` pins hosts to fixed addresses (e.g. a local mock
+ *    TLS server), in the form "host=address[,host=address...]".
+ *
+ * Dependencies:
+ *  - Standard C / POSIX libraries (stddef.h).
+ *
+ * Usage:
+ *  - Implemented in `dns_cache.c`.
+ *  - Used by `exchange_connect.c` and `exchange_websocket.c`.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#ifndef DNS_CACHE_H
+#define DNS_CACHE_H
+
+#include <stddef.h>
+
+#define DNS_CACHE_TTL_SEC 300           // how long a resolved address is trusted
+#define DNS_CACHE_MAX_HOSTS 16
+#define DNS_CACHE_MAX_ADDRS 4
+
+/* Add a host to the cache; it is resolved by the background thread */
+void dns_cache_register(const char *host);
+
+/* Keep the resolver thread on `cpu` (-1 = anywhere); call before dns_cache_start() */
+void dns_cache_set_cpu(int cpu);
+
+/* Start the background resolver (applies `CRYPTO_WS_RESOLVE` first) */
+void dns_cache_start();
+
+/* Copy the cached address for `host` into `dest`; returns 0 if nothing is cached yet */
+int dns_cache_lookup(const char *host, char *dest, size_t dest_size);
+
+/* Move `host` on to its next cached address after a failed connect */
+void dns_cache_report_failure(const char *host);
+
+#endif // DNS_CACHE_H
@@ -0,0 +1,243 @@
+/*
+ * Exchange Adapter Registry
+ *
+ * Lists the exchange adapters the collector connects to and holds the pieces
+ * they share: the default receive path, symbol file loading, text frame
+ * sends and the symbol normalizers.
+ *
+ * Features:
+ *  - `exchange_adapters[]` decides which venues run and in which order their
+ *    connections are registered; comment a line out to disable a venue.
+ *  - `adapter_route_message()` classifies a frame from its first bytes and
+ *    hands it to the adapter's ticker / quote / trade parser or heartbeat.
+ *  - Symbols such as "XBT/USD", "btcusdt" or "tBTC:UST" normalize to
+ *    "BTC-USD" / "BTC-USDT" so venues can be compared.
+ *
+ * Dependencies:
+ *  - libwebsockets: Outgoing text frames.
+ *  - jansson: Symbol files are JSON arrays.
+ *  - Standard C libraries (stdio, stdlib, string, ctype).
+ *
+ * Usage:
+ *  - Registry read by `exchange_websocket.c` (protocols) and
+ *    `exchange_connect.c` (connection slots).
+ *  - Helpers called from the `adapter_*.c` modules.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#include "exchange_adapter.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+
+/* Venues in connection order */
+const ExchangeAdapter *const exchange_adapters[] = {
+    &binance_adapter,
+    &coinbase_adapter,
+    &kraken_adapter,
+    &bitfinex_adapter,
+    &huobi_adapter,
+    &okx_adapter
+};
+const int exchange_adapter_count = (int)(sizeof(exchange_adapters) / sizeof(exchange_adapters[0]));
+
+/* Quote assets recognised at the end of concatenated symbols, longest first so "TUSD" beats "USD" */
+static const char *quote_assets[] = {
+    "FDUSD", "USDT", "USDC", "BUSD", "TUSD", "USDD", "HUSD", "EURT",
+    "USD", "EUR", "GBP", "TRY", "JPY", "AUD", "BRL", "DAI", "BTC", "ETH", "BNB", "TRX"
+};
+
+/* Asset codes that differ between venues */
+static const struct { const char *alias; const char *asset; } asset_aliases[] = {
+    { "XBT", "BTC" },
+    { "XDG", "DOGE" }
+};
+
+const ExchangeAdapter *find_exchange_adapter(const char *name) {
+    if (!name) return NULL;
+    for (int i = 0; i < exchange_adapter_count; i++) {
+        const ExchangeAdapter *adapter = exchange_adapters[i];
+        if (strcmp(adapter->endpoint.exchange, name) == 0 || strcmp(adapter->display_name, name) == 0)
+            return adapter;
+    }
+    return NULL;
+}
+
+int exchange_in_list(const char *list, const char *exchange) {
+    size_t n = strlen(exchange);
+    for (const char *p = list; (p = strstr(p, exchange)) != NULL; p += n) {
+        int starts = (p == list || p[-1] == ',');
+        int ends = (p[n] == '\0' || p[n] == ',');
+        if (starts && ends) return 1;
+    }
+    return 0;
+}
+
+int exchange_normalize_symbol(const char *exchange, const char *symbol, char *dest, size_t dest_size) {
+    const ExchangeAdapter *adapter = find_exchange_adapter(exchange);
+    if (!adapter || !adapter->normalize_symbol || !symbol) return 0;
+    return adapter->normalize_symbol(symbol, dest, dest_size);
+}
+
+int adapter_route_message(ConnectionSlot *slot, struct lws *wsi, const char *msg, size_t len) {
+    const ExchangeAdapter *adapter = slot->adapter;
+
+    switch (adapter->classify(msg, len)) {
+        case MSG_TICKER:
+            adapter->on_ticker(msg, len);
+            break;
+        case MSG_QUOTE:
+            if (adapter->on_quote) adapter->on_quote(msg, len);
+            break;
+        case MSG_TRADE:
+            adapter->on_trade(msg, len);
+            break;
+        case MSG_PING:
+            if (adapter->heartbeat) return adapter->heartbeat(wsi, msg, len);
+            break;
+        case MSG_ERROR:
+            log_exchange_error(slot->protocol, msg, len);
+            break;
+        default:
+            break;
+    }
+    return 0;
+}
+
+/* Read a file holding a JSON array of symbols; NULL on any error */
+json_t *load_json_array(const char *filename) {
+    FILE *fp = fopen(filename, "r");
+    if (!fp) {
+        fprintf(stderr, "[ERROR] Could not open %s\n", filename);
+        return NULL;
+    }
+
+    json_error_t error;
+    json_t *array = json_loadf(fp, 0, &error);
+    fclose(fp);
+
+    if (!array || !json_is_array(array)) {
+        fprintf(stderr, "[ERROR] Failed to parse JSON array in %s: %s\n", filename, array ? "not an array" : error.text);
+        if (array) json_decref(array);
+        return NULL;
+    }
+    return array;
+}
+
+/* Send one text frame; `msg` does not need LWS_PRE headroom */
+int send_ws_text(struct lws *wsi, const char *msg, size_t msg_len) {
+    unsigned char *buf = malloc(LWS_PRE + msg_len);
+    if (!buf) {
+        fprintf(stderr, "[ERROR] Memory allocation failed for outgoing message\n");
+        return -1;
+    }
+    memcpy(buf + LWS_PRE, msg, msg_len);
+    int sent = lws_write(wsi, buf + LWS_PRE, msg_len, LWS_WRITE_TEXT);
+    free(buf);
+    return sent < 0 ? -1 : 0;
+}
+
+/* Queue one text frame on the connection's slot for the next LWS_CALLBACK_CLIENT_WRITEABLE. Multi-frame
+ * subscriptions use it so each frame goes out when the socket can take it, one per callback, instead of
+ * back-to-back writes in the ESTABLISHED callback. Each frame is stored as its length, LWS_PRE headroom and
+ * the payload. */
+int queue_ws_text(struct lws *wsi, const char *msg, size_t msg_len) {
+    const struct lws_protocols *protocol = lws_get_protocol(wsi);
+    ConnectionSlot *slot = protocol ? (ConnectionSlot *)protocol->user : NULL;
+    if (!slot) return send_ws_text(wsi, msg, msg_len);
+
+    size_t frame = sizeof(size_t) + LWS_PRE + msg_len;
+    if (slot->tx_queue_len + frame > slot->tx_queue_cap) {
+        size_t cap = slot->tx_queue_cap ? slot->tx_queue_cap : 16384;
+        while (cap < slot->tx_queue_len + frame) cap *= 2;
+        char *grown = realloc(slot->tx_queue, cap);
+        if (!grown) {
+            fprintf(stderr, "[ERROR] Memory allocation failed for outgoing message\n");
+            return -1;
+        }
+        slot->tx_queue = grown;
+        slot->tx_queue_cap = cap;
+    }
+
+    char *p = slot->tx_queue + slot->tx_queue_len;
+    memcpy(p, &msg_len, sizeof(msg_len));
+    memcpy(p + sizeof(size_t) + LWS_PRE, msg, msg_len);
+    slot->tx_queue_len += frame;
+    lws_callback_on_writable(wsi);
+    return 0;
+}
+
+/* Send the oldest queued frame from the writeable callback and ask for another while frames remain */
+int send_queued_ws_text(ConnectionSlot *slot, struct lws *wsi) {
+    if (slot->tx_queue_head >= slot->tx_queue_len) return 0;
+
+    char *p = slot->tx_queue + slot->tx_queue_head;
+    size_t msg_len;
+    memcpy(&msg_len, p, sizeof(msg_len));
+    slot->tx_queue_head += sizeof(size_t) + LWS_PRE + msg_len;
+    if (lws_write(wsi, (unsigned char *)p + sizeof(size_t) + LWS_PRE, msg_len, LWS_WRITE_TEXT) < 0) return -1;
+
+    if (slot->tx_queue_head < slot->tx_queue_len) lws_callback_on_writable(wsi);
+    else slot->tx_queue_head = slot->tx_queue_len = 0;
+    return 0;
+}
+
+/* Log a request rejected by an exchange; the payload is not NUL-terminated */
+void log_exchange_error(const char *protocol, const char *msg, size_t len) {
+    int shown = (len > 256) ? 256 : (int)len;
+    printf("[ERROR] %s rejected a request: %.*s\n", protocol, shown, msg);
+}
+
+/* Upper-case one asset code into dest, applying aliases; returns the length written or -1 */
+static int write_asset(const char *asset, size_t asset_len, char *dest, size_t dest_size) {
+    char code[16];
+    if (asset_len == 0 || asset_len >= sizeof(code)) return -1;
+    for (size_t i = 0; i < asset_len; i++)
+        code[i] = (char)toupper((unsigned char)asset[i]);
+    code[asset_len] = '\0';
+
+    const char *name = code;
+    for (size_t i = 0; i < sizeof(asset_aliases) / sizeof(asset_aliases[0]); i++) {
+        if (strcmp(code, asset_aliases[i].alias) == 0) {
+            name = asset_aliases[i].asset;
+            break;
+        }
+    }
+
+    size_t n = strlen(name);
+    if (n >= dest_size) return -1;
+    memcpy(dest, name, n + 1);
+    return (int)n;
+}
+
+/* Join base and quote as "BASE-QUOTE" */
+static int write_pair(const char *base, size_t base_len, const char *quote, size_t quote_len,
+                      char *dest, size_t dest_size) {
+    int n = write_asset(base, base_len, dest, dest_size);
+    if (n < 0 || (size_t)n + 1 >= dest_size) return 0;
+    dest[n++] = '-';
+    return write_asset(quote, quote_len, dest + n, dest_size - n) >= 0;
+}
+
+/* "BTC-USD", "XBT/USD", "BTC:UST", "btc_usdt" */
+int normalize_separated_symbol(const char *symbol, char *dest, size_t dest_size) {
+    const char *sep = strpbrk(symbol, "-/:_");
+    if (!sep || sep == symbol || sep[1] == '\0') return 0;
+    return write_pair(symbol, sep - symbol, sep + 1, strlen(sep + 1), dest, dest_size);
+}
+
+/* "BTCUSDT", "ethbtc": split off a known quote asset */
+int normalize_concatenated_symbol(const char *symbol, char *dest, size_t dest_size) {
+    size_t len = strlen(symbol);
+    for (size_t i = 0; i < sizeof(quote_assets) / sizeof(quote_assets[0]); i++) {
+        size_t q = strlen(quote_assets[i]);
+        if (len > q && strcasecmp(symbol + len - q, quote_assets[i]) == 0)
+            return write_pair(symbol, len - q, symbol + len - q, q, dest, dest_size);
+    }
+    return 0;
+}
@@ -0,0 +1,110 @@
+/*
+ * Exchange Adapter Header
+ *
+ * Declares the interface every exchange implements and the registry the core
+ * dispatches through. The WebSocket callback, the connection orchestrator and
+ * the reconnect logic never branch on exchange names; they call the adapter
+ * stored in the connection slot.
+ *
+ * Features:
+ *  - `ExchangeAdapter`: endpoint and bring-up limits, subscribe builder,
+ *    message classifier, parsers, heartbeat reply and symbol normalizer.
+ *  - `exchange_adapters[]`: the registered venues, one entry per module.
+ *  - Helpers shared by the adapter modules (JSON symbol files, text frames,
+ *    error logging, the default classify-and-route receive path).
+ *
+ * Adding a venue:
+ *  - Write `adapter_<venue>.c` defining a `const ExchangeAdapter`.
+ *  - Declare it below and list it in `exchange_adapters[]` (`exchange_adapter.c`).
+ *  - Add its object to `LIB_OBJS` in the makefile and its REST fetcher to
+ *    `symbol_fetchers[]` in `fetch_currency_id.c`.
+ *
+ * Dependencies:
+ *  - libwebsockets: Connection handles passed to subscribe and heartbeat.
+ *  - jansson: Symbol files are JSON arrays.
+ *
+ * Usage:
+ *  - Implemented in `exchange_adapter.c` and the `adapter_*.c` modules.
+ *  - Used by `exchange_websocket.c`, `exchange_connect.c` and `cryptofeed.c`.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#ifndef EXCHANGE_ADAPTER_H
+#define EXCHANGE_ADAPTER_H
+
+#include "exchange_connect.h"
+#include "message_classifier.h"
+
+#include <stddef.h>
+#include <jansson.h>
+#include <libwebsockets.h>
+
+#define MAX_EXCHANGE_ADAPTERS 16
+
+/* Parser for one kind of market data message; publishes through `cryptofeed_emit_*` */
+typedef void (*AdapterParser)(const char *msg, size_t len);
+
+typedef struct ExchangeAdapter {
+    const char *display_name;       // exchange name carried by records, e.g. "Binance"
+    ExchangeEndpoint endpoint;      // protocol prefix, address, chunking and bring-up limits
+    int max_connections;            // protocols registered: "<prefix>-websocket" if 1, else "<prefix>-websocket-<n>"
+    double taker_fee_bps;           // base-tier spot taker fee, used to fee-adjust cross-venue prices
+
+    /* Send (or `queue_ws_text`) the subscription for connection `chunk_index` right after the handshake;
+     * -1 closes it */
+    int (*subscribe)(struct lws *wsi, int chunk_index);
+
+    /* Handle one received frame; most venues use `adapter_route_message` */
+    int (*on_message)(ConnectionSlot *slot, struct lws *wsi, const char *msg, size_t len);
+
+    /* Used by `adapter_route_message` */
+    MessageKind (*classify)(const char *msg, size_t len);
+    AdapterParser on_ticker;
+    AdapterParser on_quote;         // NULL if the venue has no top-of-book channel
+    AdapterParser on_trade;
+
+    /* Answer an application-level ping (MSG_PING); NULL if the venue never sends one */
+    int (*heartbeat)(struct lws *wsi, const char *msg, size_t len);
+
+    /* Rewrite a venue symbol as upper-case "BASE-QUOTE"; returns 0 if it cannot be split */
+    int (*normalize_symbol)(const char *symbol, char *dest, size_t dest_size);
+} ExchangeAdapter;
+
+/* Registered venues (adapter_*.c) */
+extern const ExchangeAdapter binance_adapter;
+extern const ExchangeAdapter coinbase_adapter;
+extern const ExchangeAdapter kraken_adapter;
+extern const ExchangeAdapter huobi_adapter;
+extern const ExchangeAdapter okx_adapter;
+extern const ExchangeAdapter bitfinex_adapter;
+
+/* Registry in connection order; `exchange_adapter_count` entries */
+extern const ExchangeAdapter *const exchange_adapters[];
+extern const int exchange_adapter_count;
+
+/* Find an adapter by protocol prefix ("okx") or record name ("OKX"); NULL if unknown */
+const ExchangeAdapter *find_exchange_adapter(const char *name);
+
+/* Whether protocol prefix `exchange` appears in a comma-separated list such as "binance,okx" */
+int exchange_in_list(const char *list, const char *exchange);
+
+/* Normalize a record's symbol through its exchange's adapter; returns 0 if it cannot */
+int exchange_normalize_symbol(const char *exchange, const char *symbol, char *dest, size_t dest_size);
+
+/* Default receive path: classify, answer pings, route market data to the parsers */
+int adapter_route_message(ConnectionSlot *slot, struct lws *wsi, const char *msg, size_t len);
+
+/* Shared helpers for adapter modules */
+json_t *load_json_array(const char *filename);
+int send_ws_text(struct lws *wsi, const char *msg, size_t msg_len);
+int queue_ws_text(struct lws *wsi, const char *msg, size_t msg_len);
+int send_queued_ws_text(ConnectionSlot *slot, struct lws *wsi);
+void log_exchange_error(const char *protocol, const char *msg, size_t len);
+
+/* Normalizer building blocks */
+int normalize_separated_symbol(const char *symbol, char *dest, size_t dest_size);
+int normalize_concatenated_symbol(const char *symbol, char *dest, size_t dest_size);
+
+#endif // EXCHANGE_ADAPTER_H
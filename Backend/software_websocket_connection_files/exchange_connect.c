@@ -1,206 +1,508 @@
-/*
- * Exchange Connection
- * 
- * This module is responsible for establishing WebSocket connections to various 
- * cryptocurrency exchanges. It provides individual functions for connecting to 
- * each supported exchange.
- * 
- * Features:
- *  - Initializes WebSocket connections for real-time market data.
- *  - Supports multiple cryptocurrency exchanges.
- *  - Uses libwebsockets to establish secure connections.
- * 
- * Dependencies:
- *  - libwebsockets: Handles WebSocket communication.
- *  - Standard C libraries (stdio, stdlib, string).
- * 
- * Usage:
- *  - Used by `main.c` to establish WebSocket connections.
- *  - Called by `exchange_reconnect.c` to reconnect upon failure.
- * 
- * Created: 3/11/2025
- * Updated: 5/12/2025
- */
-
-#include "exchange_connect.h"
-#include "exchange_websocket.h"
-#include "utils.h"
-#include <libwebsockets.h>
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <pthread.h>
-
-/* Global context reference from main.c */
-extern struct lws_context *context;
-
-
-/* Thread function to connect to each exchange */
-void* connect_to_exchange_thread(void* exchange_name) {
-    const char* exchange = (const char*) exchange_name;
-
-    if (strcmp(exchange, "binance") == 0) {
-        int total_symbols_binance = count_symbols_in_file("currency_text_files/binance_currency_ids_trades.txt");
-        int num_chunks_binance = (total_symbols_binance + 99) / 100;
-        for (int i = 0; i < num_chunks_binance; i++) {
-            connect_to_binance(i);
-            usleep(50000);
-        }   
-    } else if (strcmp(exchange, "coinbase") == 0) {
-        connect_to_coinbase();
-        usleep(50000);
-    } else if (strcmp(exchange, "kraken") == 0) {
-        connect_to_kraken();
-        usleep(50000);
-    } else if (strcmp(exchange, "huobi") == 0) {
-        int total_symbols_huobi = count_symbols_in_file("currency_text_files/huobi_currency_ids.txt");
-        int num_chunks_huobi = (total_symbols_huobi + 99) / 100;
-        for (int i = 0; i < num_chunks_huobi; i++) {
-            connect_to_huobi(i);
-            usleep(50000);
-        }    
-    } else if (strcmp(exchange, "okx") == 0) {
-        int total_symbols_okx = count_symbols_in_file("currency_text_files/okx_currency_ids.txt");
-        int num_chunks_okx = (total_symbols_okx + 99) / 100;
-        for (int i = 0; i < num_chunks_okx; i++) {
-            connect_to_okx(i);
-            usleep(50000);
-        }    
-    }
-
-    return NULL;
-}
-
-/* Function to start connections to all exchanges in parallel */
-void start_exchange_connections() {
-    pthread_t threads[5];  // Assuming 5 exchanges
-    const char* exchanges[] = {"binance", "coinbase", "kraken", "huobi", "okx"};
-
-    // Loop through all exchanges and create a new thread for each one
-    for (int i = 0; i < 5; i++) {
-        if (pthread_create(&threads[i], NULL, connect_to_exchange_thread, (void*)exchanges[i]) != 0) {
-            printf("[ERROR] Failed to create thread for %s\n", exchanges[i]);
-        }
-    }
-
-    // Wait for all threads to complete
-    for (int i = 0; i < 5; i++) {
-        pthread_join(threads[i], NULL);
-    }
-}
-
-
-void connect_to_binance(int index) {
-    struct lws_client_connect_info ccinfo = {0};
-    ccinfo.context = context;
-    ccinfo.address = "stream.binance.us";
-    ccinfo.port = 9443;
-    ccinfo.path = "/ws";
-    ccinfo.host = "stream.binance.us";
-    ccinfo.origin = "stream.binance.us";
-
-    static char protocol_name[32];
-    snprintf(protocol_name, sizeof(protocol_name), "binance-websocket-%d", index);
-    ccinfo.protocol = protocol_name;
-
-    ccinfo.ssl_connection = LCCSCF_USE_SSL;
-
-    if (!lws_client_connect_via_info(&ccinfo))
-        printf("[ERROR] Failed to connect to Binance WebSocket server\n");
-    else
-        printf("[INFO] Connecting to Binance WebSocket...\n");
-}
-
-void connect_to_coinbase() {
-    struct lws_client_connect_info ccinfo = {0};
-    ccinfo.context = context;
-    ccinfo.address = "ws-feed.exchange.coinbase.com";
-    ccinfo.port = 443;
-    ccinfo.path = "/";
-    ccinfo.host = "ws-feed.exchange.coinbase.com";
-    ccinfo.origin = "ws-feed.exchange.coinbase.com";
-    ccinfo.protocol = "coinbase-websocket";
-    ccinfo.ssl_connection = LCCSCF_USE_SSL;
-
-    if (!lws_client_connect_via_info(&ccinfo))
-        printf("[ERROR] Failed to connect to Coinbase WebSocket server\n");
-    else
-        printf("[INFO] Connecting to Coinbase WebSocket...\n");
-}
-
-void connect_to_kraken() {
-    struct lws_client_connect_info ccinfo = {0};
-    ccinfo.context = context;
-    ccinfo.address = "ws.kraken.com";
-    ccinfo.port = 443;
-    ccinfo.path = "/";
-    ccinfo.host = "ws.kraken.com";
-    ccinfo.origin = "ws.kraken.com";
-    ccinfo.protocol = "kraken-websocket";
-    ccinfo.ssl_connection = LCCSCF_USE_SSL;
-
-    if (!lws_client_connect_via_info(&ccinfo))
-        printf("[ERROR] Failed to connect to Kraken WebSocket server\n");
-    else
-        printf("[INFO] Connecting to Kraken WebSocket...\n");
-}
-
-void connect_to_bitfinex() {
-    struct lws_client_connect_info ccinfo = {0};
-    ccinfo.context = context;
-    ccinfo.address = "api-pub.bitfinex.com";
-    ccinfo.port = 443;
-    ccinfo.path = "/ws/2";
-    ccinfo.host = "api-pub.bitfinex.com";
-    ccinfo.origin = "api-pub.bitfinex.com";
-    ccinfo.protocol = "bitfinex-websocket";
-    ccinfo.ssl_connection = LCCSCF_USE_SSL;
-
-    if (!lws_client_connect_via_info(&ccinfo))
-        printf("[ERROR] Failed to connect to Bitfinex WebSocket server\n");
-    else
-        printf("[INFO] Connecting to Bitfinex WebSocket...\n");
-}
-
-void connect_to_huobi(int index) {
-    struct lws_client_connect_info ccinfo = {0};
-    ccinfo.context = context;
-    ccinfo.address = "api.huobi.pro";
-    ccinfo.port = 443;
-    ccinfo.path = "/ws";
-    ccinfo.host = "api.huobi.pro";
-    ccinfo.origin = "api.huobi.pro";
-    
-    static char protocol_name[32];
-    snprintf(protocol_name, sizeof(protocol_name), "huobi-websocket-%d", index);
-    ccinfo.protocol = protocol_name;
-
-    ccinfo.ssl_connection = LCCSCF_USE_SSL;
-
-    if (!lws_client_connect_via_info(&ccinfo))
-        printf("[ERROR] Failed to connect to Huobi WebSocket [%s]\n", protocol_name);
-    else
-        printf("[INFO] Connecting to Huobi WebSocket [%s]...\n", protocol_name);
-}
-
-void connect_to_okx(int index) {
-    struct lws_client_connect_info ccinfo = {0};
-    ccinfo.context = context;
-    ccinfo.address = "ws.okx.com";
-    ccinfo.port = 8443;
-    ccinfo.path = "/ws/v5/public";
-    ccinfo.host = "ws.okx.com";
-    ccinfo.origin = "ws.okx.com";
-
-    static char protocol_name[32];
-    snprintf(protocol_name, sizeof(protocol_name), "okx-websocket-%d", index);
-    ccinfo.protocol = protocol_name;
-
-
-    ccinfo.ssl_connection = LCCSCF_USE_SSL;
-
-    if (!lws_client_connect_via_info(&ccinfo))
-        printf("[ERROR] Failed to connect to OKX WebSocket server\n");
-    else
-        printf("[INFO] Connecting to OKX WebSocket...\n");
-}
+/*
+ * Exchange Connection
+ *
+ * This module is responsible for establishing WebSocket connections to various
+ * cryptocurrency exchanges. It keeps a registry with one slot per connection
+ * and an orchestrator that runs inside the libwebsockets event loop to open
+ * them.
+ *
+ * Features:
+ *  - Registry of connection slots built from `protocols[]`, each bound to
+ *    its exchange adapter and sized from the symbol files so only the
+ *    chunks that are needed get opened.
+ *  - Per-exchange caps on handshakes in flight and a token bucket on new
+ *    connections, so TLS handshakes run in parallel without tripping the
+ *    exchanges' connection rate limits.
+ *  - Per-connection state tracking (pending, connecting, established,
+ *    subscribed, backoff) with non-blocking retry scheduling.
+ *  - Runs entirely on the service thread through an lws timer, so no two
+ *    threads ever touch the shared lws context.
+ *  - Connects to addresses from the DNS cache and logs handshake time and
+ *    TLS session resumption per connection.
+ *  - Per-exchange permessage-deflate offer (`CRYPTO_WS_DEFLATE`) and
+ *    periodic statistics on compression ratio and service-thread CPU.
+ *  - When kTLS is requested, records which connections the kernel decrypts
+ *    and reports the ones that fell back to user-space decryption.
+ *
+ * Dependencies:
+ *  - libwebsockets: Handles WebSocket communication and the timer wheel.
+ *  - OpenSSL: Reports whether a TLS session was resumed and whether kTLS
+ *    receive offload is active (when lws uses it).
+ *  - Standard C libraries (stdio, stdlib, string).
+ *
+ * Usage:
+ *  - `start_exchange_connections()` is called once by `cryptofeed_start()`,
+ *    with the shard of the chunks this process owns (0 of 1 = all).
+ *  - `exchange_websocket.c` reports state changes, `exchange_reconnect.c`
+ *    queues retries through `defer_exchange_connection()`.
+ *
+ * Created: 3/11/2025
+ * Updated: 10/17/2026
+ */
+
+#include "exchange_connect.h"
+#include "exchange_websocket.h"
+#include "exchange_adapter.h"
+#include "exchange_reconnect.h"
+#include "dns_cache.h"
+#include "sys_stats.h"
+#include "utils.h"
+#include <libwebsockets.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <arpa/inet.h>
+
+#if defined(LWS_WITH_TLS) && !defined(LWS_WITH_MBEDTLS)
+#include <openssl/ssl.h>
+#endif
+
+#define ORCHESTRATOR_TICK_MS 10         // tick while connections are waiting to open
+#define ORCHESTRATOR_IDLE_MS 1000       // tick once everything is open
+#define STATS_INTERVAL_MS 60000         // connection statistics report period
+
+/* Global context reference from cryptofeed.c */
+extern struct lws_context *context;
+
+/* Token bucket and in-flight counter per endpoint */
+typedef struct {
+    int tokens;
+    long long last_refill_ms;
+    int connecting;
+    int ktls_fallback_logged;
+} EndpointState;
+
+ConnectionSlot connection_slots[MAX_EXCHANGES];
+static int num_slots = 0;
+static EndpointState endpoint_state[MAX_EXCHANGE_ADAPTERS];
+
+static lws_sorted_usec_list_t orchestrator_sul;
+static long long bring_up_start_ms = 0;
+static int bring_up_reported = 0;
+static long long last_health_check_ms = 0;
+static long long last_stats_ms = 0;
+static double last_stats_cpu_ms = 0.0;
+
+/* Low-latency mode: gaps between service passes, log-linear buckets (4 per power of two) */
+#define JITTER_BUCKETS 256
+static int low_latency = 0;
+static int busy_poll_us = 0;
+static int busy_poll_warned = 0;
+static int ktls_requested = 0;
+static unsigned long long jitter_hist[JITTER_BUCKETS];
+static unsigned long long jitter_passes = 0;
+static long long jitter_max_ns = 0;
+static long long last_pass_ns = 0;
+static long last_involuntary = 0;
+
+static int endpoint_index(const ExchangeEndpoint *endpoint) {
+    for (int e = 0; e < exchange_adapter_count; e++)
+        if (&exchange_adapters[e]->endpoint == endpoint) return e;
+    return 0;
+}
+
+const char *connection_state_name(ConnectionState state) {
+    switch (state) {
+        case CONN_DISABLED:    return "disabled";
+        case CONN_PENDING:     return "pending";
+        case CONN_CONNECTING:  return "connecting";
+        case CONN_ESTABLISHED: return "established";
+        case CONN_SUBSCRIBED:  return "subscribed";
+        case CONN_BACKOFF:     return "backoff";
+    }
+    return "unknown";
+}
+
+static void set_state(ConnectionSlot *slot, ConnectionState state) {
+    EndpointState *es = &endpoint_state[endpoint_index(slot->endpoint)];
+
+    if (slot->state == CONN_CONNECTING && state != CONN_CONNECTING && es->connecting > 0)
+        es->connecting--;
+    else if (slot->state != CONN_CONNECTING && state == CONN_CONNECTING)
+        es->connecting++;
+
+    slot->state = state;
+    slot->state_since_ms = get_monotonic_ms();
+}
+
+/* Match a protocol name such as "huobi-websocket-12" against the adapter registry */
+static const ExchangeAdapter *find_adapter(const char *protocol, int *chunk_index) {
+    for (int i = 0; i < exchange_adapter_count; i++) {
+        const char *exchange = exchange_adapters[i]->endpoint.exchange;
+        size_t n = strlen(exchange);
+        if (strncmp(protocol, exchange, n) != 0 || strncmp(protocol + n, "-websocket", 10) != 0)
+            continue;
+
+        const char *suffix = protocol + n + 10;
+        if (*suffix == '\0') {
+            *chunk_index = 0;
+            return exchange_adapters[i];
+        }
+        if (*suffix == '-') {
+            *chunk_index = atoi(suffix + 1);
+            return exchange_adapters[i];
+        }
+    }
+    return NULL;
+}
+
+/* Whether to offer permessage-deflate; CRYPTO_WS_DEFLATE ("all", "none" or "binance,okx") overrides the table */
+static int deflate_enabled(const ExchangeEndpoint *endpoint) {
+    const char *spec = getenv("CRYPTO_WS_DEFLATE");
+    if (!spec) return endpoint->deflate;
+    if (strcmp(spec, "all") == 0) return 1;
+    if (strcmp(spec, "none") == 0) return 0;
+    return exchange_in_list(spec, endpoint->exchange);
+}
+
+/* Number of connections an exchange needs */
+static int required_chunks(const ExchangeEndpoint *endpoint) {
+    if (!endpoint->symbols_file) return 1;
+
+    int total_symbols = count_symbols_in_file(endpoint->symbols_file);
+    if (total_symbols <= 0) return 0;
+    return (total_symbols + endpoint->symbols_per_chunk - 1) / endpoint->symbols_per_chunk;
+}
+
+ConnectionSlot *get_connection_slot(const char *protocol) {
+    int index = get_exchange_index(protocol);
+    if (index < 0 || index >= num_slots) return NULL;
+    return &connection_slots[index];
+}
+
+/* Start a non-blocking handshake for one slot */
+static int open_exchange_connection(ConnectionSlot *slot) {
+    const ExchangeEndpoint *endpoint = slot->endpoint;
+
+    /* Connect to the cached address; host/SNI/certificate checks still use the hostname */
+    char resolved[INET6_ADDRSTRLEN];
+    int cached = dns_cache_lookup(endpoint->address, resolved, sizeof(resolved));
+
+    struct lws_client_connect_info ccinfo = {0};
+    ccinfo.context = context;
+    ccinfo.address = cached ? resolved : endpoint->address;
+    ccinfo.port = endpoint->port;
+    ccinfo.path = endpoint->path;
+    ccinfo.host = endpoint->address;
+    ccinfo.origin = endpoint->address;
+    ccinfo.protocol = slot->protocol;
+    ccinfo.ssl_connection = LCCSCF_USE_SSL;
+    ccinfo.pwsi = &slot->wsi;
+
+    set_state(slot, CONN_CONNECTING);
+    if (!lws_client_connect_via_info(&ccinfo)) {
+        printf("[ERROR] Failed to connect to %s WebSocket server\n", slot->protocol);
+        return -1;
+    }
+
+    printf("[INFO] Connecting to %s WebSocket%s%s...\n", slot->protocol,
+           cached ? " at " : "", cached ? resolved : "");
+    return 0;
+}
+
+static void refill_tokens(const ExchangeEndpoint *endpoint, EndpointState *es, long long now) {
+    if (es->tokens >= endpoint->connect_burst) {
+        es->last_refill_ms = now;
+        return;
+    }
+    long long elapsed = now - es->last_refill_ms;
+    if (elapsed < endpoint->connect_refill_ms) return;
+
+    long long earned = elapsed / endpoint->connect_refill_ms;
+    es->tokens += (int)earned;
+    if (es->tokens > endpoint->connect_burst) es->tokens = endpoint->connect_burst;
+    es->last_refill_ms += earned * endpoint->connect_refill_ms;
+}
+
+static long long monotonic_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static int jitter_bucket(long long ns) {
+    if (ns < 4) return ns < 0 ? 0 : (int)ns;
+    int msb = 63 - __builtin_clzll((unsigned long long)ns);
+    int bucket = 4 + (msb - 2) * 4 + (int)((ns >> (msb - 2)) & 3);
+    return bucket < JITTER_BUCKETS ? bucket : JITTER_BUCKETS - 1;
+}
+
+/* Lower bound of a bucket in ns */
+static long long jitter_bucket_floor(int bucket) {
+    if (bucket < 4) return bucket;
+    int msb = (bucket - 4) / 4 + 2;
+    return (long long)(4 + (bucket - 4) % 4) << (msb - 2);
+}
+
+static double jitter_percentile_us(double fraction) {
+    unsigned long long target = (unsigned long long)(jitter_passes * fraction);
+    unsigned long long seen = 0;
+    for (int b = 0; b < JITTER_BUCKETS; b++) {
+        seen += jitter_hist[b];
+        if (seen > target) return jitter_bucket_floor(b) / 1000.0;
+    }
+    return jitter_max_ns / 1000.0;
+}
+
+void enable_low_latency_mode(int usec) {
+    low_latency = 1;
+    busy_poll_us = usec;
+}
+
+void set_ktls_requested(int requested) {
+    ktls_requested = requested;
+}
+
+void record_service_pass() {
+    long long now = monotonic_ns();
+    if (last_pass_ns) {
+        long long gap = now - last_pass_ns;
+        jitter_hist[jitter_bucket(gap)]++;
+        jitter_passes++;
+        if (gap > jitter_max_ns) jitter_max_ns = gap;
+    }
+    last_pass_ns = now;
+}
+
+/* Service loop gaps since the last report: how long incoming data could have waited for the thread */
+static void report_service_jitter() {
+    long involuntary = get_thread_involuntary_switches();
+    if (jitter_passes > 0)
+        printf("[STATS] service loop: %llu passes, gap p50 %.1f us, p99 %.1f us, p99.99 %.1f us, max %.1f us, %ld preemptions\n",
+               jitter_passes, jitter_percentile_us(0.50), jitter_percentile_us(0.99), jitter_percentile_us(0.9999),
+               jitter_max_ns / 1000.0, involuntary >= 0 ? involuntary - last_involuntary : -1);
+
+    memset(jitter_hist, 0, sizeof(jitter_hist));
+    jitter_passes = 0;
+    jitter_max_ns = 0;
+    last_involuntary = involuntary;
+}
+
+/* Log per-exchange compression ratio and the service thread's CPU share */
+static void report_connection_stats(long long now) {
+    double cpu_ms = get_thread_cpu_ms();
+    double wall_ms = (double)(now - last_stats_ms);
+
+    for (int e = 0; e < exchange_adapter_count; e++) {
+        unsigned long long messages = 0, payload = 0;
+        long long wire = 0;
+        int open = 0, deflate = 0, negotiated = 0, ktls = 0, wire_known = 1;
+
+        for (int i = 0; i < num_slots; i++) {
+            ConnectionSlot *slot = &connection_slots[i];
+            if (slot->endpoint != &exchange_adapters[e]->endpoint || slot->state != CONN_SUBSCRIBED) continue;
+            open++;
+            deflate += slot->deflate;
+            negotiated += slot->deflate_negotiated;
+            ktls += slot->ktls_rx;
+            messages += slot->rx_messages;
+            payload += slot->rx_payload_bytes;
+
+            long long rx = get_socket_rx_bytes(slot->fd);
+            if (rx < 0) wire_known = 0;
+            else wire += rx - slot->rx_wire_base;
+        }
+        if (!open) continue;
+
+        if (wire_known && payload > 0)
+            printf("[STATS] %s: %d conns, deflate %d/%d negotiated, %llu msgs, payload %.1f KB, wire %.1f KB, ratio %.2f",
+                   exchange_adapters[e]->endpoint.exchange, open, negotiated, deflate, messages,
+                   payload / 1024.0, wire / 1024.0, (double)wire / payload);
+        else
+            printf("[STATS] %s: %d conns, deflate %d/%d negotiated, %llu msgs, payload %.1f KB",
+                   exchange_adapters[e]->endpoint.exchange, open, negotiated, deflate, messages, payload / 1024.0);
+        if (ktls_requested) printf(", kTLS %d/%d", ktls, open);
+        printf("\n");
+    }
+
+    if (wall_ms > 0)
+        printf("[STATS] service thread CPU %.1f%% over the last %.0f s\n",
+               100.0 * (cpu_ms - last_stats_cpu_ms) / wall_ms, wall_ms / 1000.0);
+    if (low_latency) report_service_jitter();
+
+    last_stats_ms = now;
+    last_stats_cpu_ms = cpu_ms;
+}
+
+/* One orchestrator pass: open whatever the caps allow, report bring-up time */
+static int service_exchange_connections(long long now) {
+    int waiting = 0;
+    int enabled = 0;
+    int subscribed = 0;
+
+    for (int e = 0; e < exchange_adapter_count; e++)
+        refill_tokens(&exchange_adapters[e]->endpoint, &endpoint_state[e], now);
+
+    for (int i = 0; i < num_slots; i++) {
+        ConnectionSlot *slot = &connection_slots[i];
+        if (slot->state == CONN_DISABLED) continue;
+        enabled++;
+        if (slot->state == CONN_SUBSCRIBED) subscribed++;
+
+        if (slot->state != CONN_PENDING && slot->state != CONN_BACKOFF) continue;
+        waiting++;
+        if (now < slot->next_attempt_ms) continue;
+
+        const ExchangeEndpoint *endpoint = slot->endpoint;
+        EndpointState *es = &endpoint_state[endpoint_index(endpoint)];
+        if (es->connecting >= endpoint->max_connecting || es->tokens <= 0) continue;
+
+        es->tokens--;
+        /* A synchronous failure may already have been reported through the callback */
+        if (open_exchange_connection(slot) != 0 && slot->state == CONN_CONNECTING)
+            schedule_reconnect(slot->protocol);
+    }
+
+    if (!bring_up_reported && enabled > 0 && subscribed == enabled) {
+        printf("[INFO] All %d connections subscribed in %lld ms\n", enabled, now - bring_up_start_ms);
+        bring_up_reported = 1;
+    }
+
+    return waiting;
+}
+
+static void orchestrator_tick(lws_sorted_usec_list_t *sul) {
+    (void)sul;
+    long long now = get_monotonic_ms();
+
+    int waiting = service_exchange_connections(now);
+
+    if (now - last_health_check_ms >= HEALTH_CHECK_INTERVAL * 1000LL) {
+        check_exchange_health();
+        last_health_check_ms = now;
+    }
+
+    if (now - last_stats_ms >= STATS_INTERVAL_MS)
+        report_connection_stats(now);
+
+    int next_ms = waiting ? ORCHESTRATOR_TICK_MS : ORCHESTRATOR_IDLE_MS;
+    lws_sul_schedule(context, 0, &orchestrator_sul, orchestrator_tick, (lws_usec_t)next_ms * LWS_US_PER_MS);
+}
+
+/* Build the registry from `protocols[]` and arm the orchestrator */
+void start_exchange_connections(int shard_index, int shard_count) {
+    long long now = get_monotonic_ms();
+    int chunks[MAX_EXCHANGE_ADAPTERS];
+
+    for (int e = 0; e < exchange_adapter_count; e++) {
+        chunks[e] = required_chunks(&exchange_adapters[e]->endpoint);
+        endpoint_state[e].tokens = exchange_adapters[e]->endpoint.connect_burst;
+        endpoint_state[e].last_refill_ms = now;
+        endpoint_state[e].connecting = 0;
+    }
+
+    num_slots = 0;
+    int pending = 0;
+    for (int i = 0; protocols[i].name && i < MAX_EXCHANGES; i++) {
+        ConnectionSlot *slot = &connection_slots[i];
+        free(slot->rx_partial);         // left by an earlier feed
+        free(slot->tx_queue);
+        memset(slot, 0, sizeof(*slot));
+        slot->protocol = protocols[i].name;
+        slot->adapter = find_adapter(slot->protocol, &slot->chunk_index);
+        slot->fd = -1;
+        num_slots = i + 1;
+
+        if (!slot->adapter) {
+            printf("[ERROR] No adapter registered for %s\n", slot->protocol);
+            continue;
+        }
+        slot->endpoint = &slot->adapter->endpoint;
+        slot->deflate = deflate_enabled(slot->endpoint);
+
+        /* A sharded collector only opens every shard_count-th chunk of each exchange */
+        int needed = chunks[endpoint_index(slot->endpoint)];
+        int in_shard = shard_count <= 1 || slot->chunk_index % shard_count == shard_index;
+        if (slot->chunk_index < needed && in_shard) {
+            slot->state = CONN_PENDING;
+            slot->state_since_ms = now;
+            pending++;
+        }
+    }
+
+    for (int e = 0; e < exchange_adapter_count; e++)
+        if (chunks[e] > 0) dns_cache_register(exchange_adapters[e]->endpoint.address);
+    dns_cache_start();
+
+    for (int e = 0; e < exchange_adapter_count; e++) {
+        int available = 0;
+        for (int i = 0; i < num_slots; i++)
+            if (connection_slots[i].endpoint == &exchange_adapters[e]->endpoint) available++;
+        if (chunks[e] > available)
+            printf("[WARNING] %s needs %d connections but only %d protocols are registered\n",
+                   exchange_adapters[e]->endpoint.exchange, chunks[e], available);
+    }
+
+    printf("[INFO] Opening %d exchange connections\n", pending);
+    bring_up_start_ms = now;
+    bring_up_reported = 0;
+    last_health_check_ms = now;
+    last_stats_ms = now;
+    last_stats_cpu_ms = get_thread_cpu_ms();
+    last_involuntary = get_thread_involuntary_switches();
+
+    /* First pass runs immediately so the initial burst goes out before the first poll */
+    service_exchange_connections(now);
+    lws_sul_schedule(context, 0, &orchestrator_sul, orchestrator_tick, (lws_usec_t)ORCHESTRATOR_TICK_MS * LWS_US_PER_MS);
+}
+
+void mark_connection_established(ConnectionSlot *slot, struct lws *wsi) {
+    if (!slot) return;
+    slot->wsi = wsi;
+    slot->fd = lws_get_socket_fd(wsi);
+    slot->rx_wire_base = get_socket_rx_bytes(slot->fd);
+    if (slot->rx_wire_base < 0) slot->rx_wire_base = 0;
+    slot->rx_messages = 0;
+    slot->rx_payload_bytes = 0;
+    slot->rx_partial_len = 0;           // a message cut off with the previous connection is gone
+    slot->rx_partial_dropped = 0;
+    slot->tx_queue_head = slot->tx_queue_len = 0;
+    slot->ktls_rx = 0;
+
+    if (busy_poll_us > 0 && set_socket_busy_poll(slot->fd, busy_poll_us) != 0 && !busy_poll_warned) {
+        printf("[WARNING] SO_BUSY_POLL unavailable (needs CAP_NET_ADMIN above net.core.busy_read), continuing without it\n");
+        busy_poll_warned = 1;
+    }
+
+    /* The response headers are still attached while the ESTABLISHED callback runs */
+    char extensions[128];
+    slot->deflate_negotiated = lws_hdr_copy(wsi, extensions, sizeof(extensions), WSI_TOKEN_EXTENSIONS) > 0 &&
+                               strstr(extensions, "permessage-deflate") != NULL;
+
+    long long handshake_ms = get_monotonic_ms() - slot->state_since_ms;
+    const char *tls = "";
+
+#if defined(LWS_WITH_TLS) && !defined(LWS_WITH_MBEDTLS)
+    SSL *ssl = slot->wsi ? lws_get_ssl(slot->wsi) : NULL;
+    if (ssl) tls = SSL_session_reused(ssl) ? " (TLS session resumed)" : " (full TLS handshake)";
+#if defined(SSL_OP_ENABLE_KTLS) && defined(BIO_get_ktls_recv)
+    /* OpenSSL installs the receive keys once the handshake finishes; the cipher decides whether it can */
+    slot->ktls_rx = ssl && BIO_get_ktls_recv(SSL_get_rbio(ssl));
+    EndpointState *es = &endpoint_state[endpoint_index(slot->endpoint)];
+    if (ktls_requested && ssl && !slot->ktls_rx && !es->ktls_fallback_logged) {
+        printf("[INFO] %s: kTLS not active on %s %s, decrypting in user space\n",
+               slot->endpoint->exchange, SSL_get_version(ssl), SSL_get_cipher_name(ssl));
+        es->ktls_fallback_logged = 1;
+    }
+#endif
+#endif
+
+    if (slot->state == CONN_CONNECTING)
+        printf("[INFO] %s handshake completed in %lld ms%s%s%s\n", slot->protocol, handshake_ms, tls,
+               slot->deflate_negotiated ? ", permessage-deflate" : "", slot->ktls_rx ? ", kTLS" : "");
+    set_state(slot, CONN_ESTABLISHED);
+}
+
+void mark_connection_subscribed(ConnectionSlot *slot) {
+    if (!slot) return;
+    set_state(slot, CONN_SUBSCRIBED);
+}
+
+void defer_exchange_connection(ConnectionSlot *slot, int delay_ms) {
+    if (!slot || slot->state == CONN_DISABLED) return;
+    slot->wsi = NULL;
+    slot->fd = -1;
+    slot->next_attempt_ms = get_monotonic_ms() + delay_ms;
+    set_state(slot, CONN_BACKOFF);
+}
@@ -1,36 +1,128 @@
-/*
- * Exchange Connect Header
- * 
- * This header file declares functions for establishing WebSocket connections 
- * to multiple cryptocurrency exchanges.
- * 
- * Functionality:
- *  - Provides function prototypes for initiating WebSocket connections 
- *    for supported exchanges.
- * 
- * Dependencies:
- *  - libwebsockets: Handles WebSocket connections.
- * 
- * Usage:
- *  - Included in `exchange_connect.c` for implementation.
- *  - Included in `main.c` and `exchange_reconnect.c` for connection handling.
- * 
- * Created: 3/11/2025
- * Updated: 5/12/2025
- */
-
-#ifndef EXCHANGE_CONNECT_H
-#define EXCHANGE_CONNECT_H
-
-#include <libwebsockets.h>
-
-/* Function prototypes for establishing WebSocket connections */
-void connect_to_binance();
-void connect_to_coinbase();
-void connect_to_kraken();
-void connect_to_bitfinex();
-void connect_to_huobi();
-void connect_to_okx();
-void start_exchange_connections();
-
-#endif // EXCHANGE_CONNECT_H
+/*
+ * Exchange Connect Header
+ *
+ * This header file declares the connection registry and the in-loop
+ * orchestrator used to open WebSocket connections to multiple cryptocurrency
+ * exchanges.
+ *
+ * Functionality:
+ *  - `ExchangeEndpoint`: Per-exchange endpoint, bring-up rate limits and
+ *    whether permessage-deflate is offered by default (set by each adapter).
+ *  - `ConnectionSlot`: Per-connection state and receive counters, one slot
+ *    per `protocols[]` entry.
+ *  - Orchestrator entry points used by `cryptofeed.c`, the WebSocket callback
+ *    and the reconnect logic.
+ *
+ * Dependencies:
+ *  - libwebsockets: Handles WebSocket connections.
+ *
+ * Usage:
+ *  - Included in `exchange_connect.c` for implementation.
+ *  - Included in `cryptofeed.c`, `exchange_websocket.c` and `exchange_reconnect.c`.
+ *
+ * Created: 3/11/2025
+ * Updated: 10/17/2026
+ */
+
+#ifndef EXCHANGE_CONNECT_H
+#define EXCHANGE_CONNECT_H
+
+#include <libwebsockets.h>
+
+struct ExchangeAdapter;
+
+/* Lifecycle of a single exchange connection */
+typedef enum {
+    CONN_DISABLED = 0,      // slot not used (no symbols for this chunk)
+    CONN_PENDING,           // waiting for the orchestrator to open it
+    CONN_CONNECTING,        // DNS/TCP/TLS/WebSocket handshake in flight
+    CONN_ESTABLISHED,       // handshake done, subscription not yet sent
+    CONN_SUBSCRIBED,        // subscription sent, data flowing
+    CONN_BACKOFF            // closed or failed, waiting for its retry time
+} ConnectionState;
+
+/* Endpoint and bring-up limits shared by all connections of one exchange (part of its adapter) */
+typedef struct {
+    const char *exchange;           // protocol prefix, e.g. "binance"
+    const char *address;
+    int port;
+    const char *path;
+    const char *symbols_file;       // symbol list used to size chunks (NULL = single connection)
+    int symbols_per_chunk;
+    int max_connecting;             // handshakes allowed in flight at once
+    int connect_burst;              // token bucket size for new connections
+    int connect_refill_ms;          // one token is added back every refill_ms
+    int deflate;                    // offer permessage-deflate unless overridden by CRYPTO_WS_DEFLATE
+} ExchangeEndpoint;
+
+/* State of one connection, indexed the same way as `protocols[]` and `retry_counts[]` */
+typedef struct {
+    const char *protocol;           // points at the `protocols[]` name (static storage)
+    const struct ExchangeAdapter *adapter;
+    const ExchangeEndpoint *endpoint;   // &adapter->endpoint
+    int chunk_index;
+    ConnectionState state;
+    struct lws *wsi;
+    long long next_attempt_ms;      // earliest time the orchestrator may (re)open it
+    long long state_since_ms;
+
+    int deflate;                    // permessage-deflate offered on this connection
+    int deflate_negotiated;         // server accepted it
+    int fd;                         // socket of the current connection, -1 when closed
+    int ktls_rx;                    // kernel decrypts inbound records (kTLS) on this connection
+    long long rx_wire_base;         // socket bytes already received when established
+    unsigned long long rx_messages;         // since the connection was established
+    unsigned long long rx_payload_bytes;    // decompressed payload handed to the callback
+
+    char *rx_partial;               // fragments of the message being received, parsed once it is complete
+    size_t rx_partial_len;
+    size_t rx_partial_cap;
+    int rx_partial_dropped;         // the current message outgrew WS_MAX_MESSAGE_SIZE, skip to its end
+
+    char *tx_queue;                 // frames waiting for a writeable callback (`queue_ws_text`)
+    size_t tx_queue_head;           // offset of the next frame to send
+    size_t tx_queue_len;
+    size_t tx_queue_cap;
+} ConnectionSlot;
+
+/* Global connection registry (defined in exchange_connect.c) */
+extern ConnectionSlot connection_slots[];
+
+/* Build the registry and arm the in-loop orchestrator; only chunks with
+ * chunk_index % shard_count == shard_index are opened (shard_count <= 1 opens all) */
+void start_exchange_connections(int shard_index, int shard_count);
+
+/* Look up the slot owning a protocol name */
+ConnectionSlot *get_connection_slot(const char *protocol);
+
+/* Position of a slot, shared with `protocols[]`, `retry_counts[]` and `last_message_time[]` */
+static inline int connection_slot_index(const ConnectionSlot *slot) {
+    return (int)(slot - connection_slots);
+}
+
+/* State transitions reported by the WebSocket callback */
+void mark_connection_established(ConnectionSlot *slot, struct lws *wsi);
+void mark_connection_subscribed(ConnectionSlot *slot);
+
+/* Queue a slot to be reopened by the orchestrator after `delay_ms` */
+void defer_exchange_connection(ConnectionSlot *slot, int delay_ms);
+
+/* Count one received message of `len` decompressed bytes */
+static inline void record_connection_rx(ConnectionSlot *slot, size_t len) {
+    slot->rx_messages++;
+    slot->rx_payload_bytes += len;
+}
+
+/* Low-latency mode: SO_BUSY_POLL on every new connection (0 = off) and a service-loop jitter report */
+void enable_low_latency_mode(int busy_poll_us);
+
+/* Called after every non-blocking service pass in low-latency mode; feeds the jitter report */
+void record_service_pass();
+
+/* kTLS was asked of OpenSSL: log connections that still decrypt in user space and count kTLS in the stats */
+void set_ktls_requested(int requested);
+
+/* Human-readable name for a connection state */
+const char *connection_state_name(ConnectionState state);
+
+#endif // EXCHANGE_CONNECT_H
@@ -1,49 +1,53 @@
-/*
- * Exchange Reconnect Header
- * 
- * Declares structures and functions for managing reconnections to WebSocket 
- * endpoints for cryptocurrency exchanges after timeouts or failures.
- * 
- * Features:
- *  - Tracks retry attempts and message timestamps per exchange.
- *  - Supports scheduled reconnection with incremental backoff.
- *  - Launches a health monitor thread to check connection status.
- * 
- * Dependencies:
- *  - Standard C libraries (time.h).
- * 
- * Usage:
- *  - Included by `exchange_reconnect.c` and used in `exchange_websocket.c`.
- * 
- * Created: 3/11/2025
- * Updated: 5/4/2025
- */
-
-#include <time.h>
-
-#ifndef EXCHANGE_RECONNECT_H
-#define EXCHANGE_RECONNECT_H
-
-/* Maximum number of supported exchanges */
-#define MAX_EXCHANGES 37
-
-/* Structure to store retry count per exchange */
-typedef struct {
-    const char *exchange;
-    int retry_count;
-} ExchangeRetry;
-
-/* Declare retry_counts as a global variable */
-extern ExchangeRetry retry_counts[MAX_EXCHANGES];
-
-/* Track last message time */
-extern time_t last_message_time[MAX_EXCHANGES];
-
-/* Function prototypes */
-int get_exchange_index(const char *exchange);
-void schedule_reconnect(const char *exchange);
-
-/* Global WebSocket context */
-void start_health_monitor();
-
-#endif // EXCHANGE_RECONNECT_H
+/*
+ * Exchange Reconnect Header
+ * 
+ * Declares structures and functions for managing reconnections to WebSocket 
+ * endpoints for cryptocurrency exchanges after timeouts or failures.
+ * 
+ * Features:
+ *  - Tracks retry attempts and message timestamps per exchange.
+ *  - Supports scheduled reconnection with incremental backoff.
+ *  - Provides the no-data health check run by the connection orchestrator.
+ * 
+ * Dependencies:
+ *  - Standard C libraries (time.h).
+ * 
+ * Usage:
+ *  - Included by `exchange_reconnect.c` and used in `exchange_websocket.c`
+ *    and `exchange_connect.c`.
+ * 
+ * Created: 3/11/2025
+ * Updated: 10/17/2026
+ */
+
+#include <time.h>
+
+#ifndef EXCHANGE_RECONNECT_H
+#define EXCHANGE_RECONNECT_H
+
+/* Maximum number of exchange connections (sum of the adapters' `max_connections`) */
+#define MAX_EXCHANGES 64
+
+#define NO_DATA_TIMEOUT 60              // seconds without data before reconnect
+#define HEALTH_CHECK_INTERVAL 30        // interval between health checks (seconds)
+
+/* Structure to store retry count per exchange */
+typedef struct {
+    const char *exchange;
+    int retry_count;
+} ExchangeRetry;
+
+/* Declare retry_counts as a global variable */
+extern ExchangeRetry retry_counts[MAX_EXCHANGES];
+
+/* Track last message time */
+extern time_t last_message_time[MAX_EXCHANGES];
+
+/* Function prototypes */
+int get_exchange_index(const char *exchange);
+void schedule_reconnect(const char *exchange);
+
+/* Close connections that have gone quiet so they are reopened */
+void check_exchange_health();
+
+#endif // EXCHANGE_RECONNECT_H
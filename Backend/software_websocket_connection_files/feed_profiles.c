@@ -0,0 +1,142 @@
+/*
+ * Feed Profiles
+ *
+ * Maps each subscribed symbol to a feed profile and each profile to the
+ * lightest channel an exchange offers for it:
+ *
+ *              full ticker   mini ticker   top of book
+ *   binance    ticker        miniTicker    bookTicker
+ *   coinbase   ticker        ticker        ticker
+ *   kraken     ticker        ticker        spread
+ *   okx        tickers       tickers       bbo-tbt
+ *   huobi      ticker        ticker        bbo
+ *   bitfinex   ticker        ticker        ticker
+ *
+ * Coinbase and Bitfinex tickers already carry the best bid/ask and are the
+ * lightest channels those exchanges offer. Every profile except
+ * `trades_only` keeps the trade channel.
+ *
+ * Rules are matched by specificity: exchange + symbol, then exchange + "*",
+ * then "*" + symbol, then "* *". Symbols without a rule use the full ticker.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#include "feed_profiles.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+
+typedef struct {
+    char exchange[16];
+    char symbol[32];
+    FeedProfile profile;
+} FeedRule;
+
+static FeedRule rules[FEED_PROFILES_MAX_RULES];
+static int rule_count = 0;
+
+static const char *profile_names[] = { "full_ticker", "mini_ticker", "top_of_book", "trades_only" };
+
+/* Quote channel per exchange, indexed by profile (FEED_TRADES_ONLY has none) */
+static const struct {
+    const char *exchange;
+    const char *channel[3];
+} quote_channels[] = {
+    { "binance",  { "ticker",  "miniTicker", "bookTicker" } },
+    { "coinbase", { "ticker",  "ticker",     "ticker" } },
+    { "kraken",   { "ticker",  "ticker",     "spread" } },
+    { "okx",      { "tickers", "tickers",    "bbo-tbt" } },
+    { "huobi",    { "ticker",  "ticker",     "bbo" } },
+    { "bitfinex", { "ticker",  "ticker",     "ticker" } },
+};
+
+static int parse_profile(const char *name, FeedProfile *profile) {
+    for (int i = 0; i < (int)(sizeof(profile_names) / sizeof(profile_names[0])); i++) {
+        if (strcasecmp(name, profile_names[i]) == 0) {
+            *profile = (FeedProfile)i;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int load_feed_profiles(const char *filename) {
+    FILE *fp = fopen(filename, "r");
+    if (!fp) {
+        printf("[INFO] No %s found, subscribing full tickers\n", filename);
+        return 0;
+    }
+
+    rule_count = 0;
+    char line[256];
+    int line_no = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        line_no++;
+        char *comment = strchr(line, '#');
+        if (comment) *comment = '\0';
+
+        char exchange[16], symbol[32], profile_name[32];
+        int fields = sscanf(line, "%15s %31s %31s", exchange, symbol, profile_name);
+        if (fields <= 0) continue;
+
+        FeedProfile profile;
+        if (fields != 3 || !parse_profile(profile_name, &profile)) {
+            printf("[ERROR] %s:%d: expected \"<exchange> <symbol> <profile>\"\n", filename, line_no);
+            fclose(fp);
+            return -1;
+        }
+        if (rule_count == FEED_PROFILES_MAX_RULES) {
+            printf("[WARNING] %s: more than %d rules, ignoring the rest\n", filename, FEED_PROFILES_MAX_RULES);
+            break;
+        }
+
+        FeedRule *rule = &rules[rule_count++];
+        strcpy(rule->exchange, exchange);
+        strcpy(rule->symbol, symbol);
+        rule->profile = profile;
+    }
+
+    fclose(fp);
+    printf("[INFO] Loaded %d feed profile rules from %s\n", rule_count, filename);
+    return rule_count;
+}
+
+FeedProfile get_feed_profile(const char *exchange, const char *symbol) {
+    /* 3 = exchange + symbol, 2 = exchange + "*", 1 = "*" + symbol, 0 = "* *" */
+    int best = -1;
+    FeedProfile profile = FEED_FULL_TICKER;
+
+    for (int i = 0; i < rule_count; i++) {
+        const FeedRule *rule = &rules[i];
+        int any_exchange = strcmp(rule->exchange, "*") == 0;
+        int any_symbol = strcmp(rule->symbol, "*") == 0;
+
+        if (!any_exchange && strcasecmp(rule->exchange, exchange) != 0) continue;
+        if (!any_symbol && strcasecmp(rule->symbol, symbol) != 0) continue;
+
+        int score = (any_exchange ? 0 : 2) + (any_symbol ? 0 : 1);
+        if (score > best) {
+            best = score;
+            profile = rule->profile;
+        }
+    }
+    return profile;
+}
+
+const char *feed_quote_channel(const char *exchange, FeedProfile profile) {
+    if (profile == FEED_TRADES_ONLY) return NULL;
+
+    for (size_t i = 0; i < sizeof(quote_channels) / sizeof(quote_channels[0]); i++) {
+        if (strcmp(quote_channels[i].exchange, exchange) == 0)
+            return quote_channels[i].channel[profile];
+    }
+    return NULL;
+}
+
+const char *feed_profile_name(FeedProfile profile) {
+    if (profile < FEED_FULL_TICKER || profile > FEED_TRADES_ONLY) return "unknown";
+    return profile_names[profile];
+}
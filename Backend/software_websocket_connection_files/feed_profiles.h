@@ -0,0 +1,52 @@
+/*
+ * Feed Profiles Header
+ *
+ * Declares per-symbol feed profiles, which choose the lightest channel each
+ * exchange offers for the quote data a symbol actually needs.
+ *
+ * Features:
+ *  - `FEED_FULL_TICKER`: 24h rolling ticker + trades (default).
+ *  - `FEED_MINI_TICKER`: last price / OHLC / volume without the book + trades.
+ *  - `FEED_TOP_OF_BOOK`: best bid/ask only + trades.
+ *  - `FEED_TRADES_ONLY`: trades, no quote channel.
+ *  - Profiles are read from `feed_profiles.conf` as
+ *    "<exchange|*> <symbol|*> <profile>" lines; the most specific rule wins.
+ *
+ * Dependencies:
+ *  - Standard C library (stdio.h, string.h, strings.h).
+ *
+ * Usage:
+ *  - Implemented in `feed_profiles.c`.
+ *  - Loaded by `main.c`, queried by the subscription builders in
+ *    `exchange_websocket.c`.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#ifndef FEED_PROFILES_H
+#define FEED_PROFILES_H
+
+#define FEED_PROFILES_FILE "feed_profiles.conf"
+#define FEED_PROFILES_MAX_RULES 256
+
+typedef enum {
+    FEED_FULL_TICKER = 0,
+    FEED_MINI_TICKER,
+    FEED_TOP_OF_BOOK,
+    FEED_TRADES_ONLY
+} FeedProfile;
+
+/* Read profile rules from `filename`; returns the number of rules, 0 if the file is absent, -1 on error */
+int load_feed_profiles(const char *filename);
+
+/* Profile for one symbol, as spelled by the exchange (case-insensitive) */
+FeedProfile get_feed_profile(const char *exchange, const char *symbol);
+
+/* Quote channel carrying `profile` on `exchange`, or NULL when no quote channel is wanted */
+const char *feed_quote_channel(const char *exchange, FeedProfile profile);
+
+/* Human-readable name for a profile */
+const char *feed_profile_name(FeedProfile profile);
+
+#endif // FEED_PROFILES_H
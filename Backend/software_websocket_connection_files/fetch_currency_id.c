@@ -7,8 +7,10 @@
  * Features:
  *  - Fetches product data via REST API endpoints.
  *  - Writes formatted symbol lists to JSON-style .txt files.
- *  - Outputs chunked or full listings depending on exchange (e.g., Huobi).
+ *  - Outputs chunked or full listings depending on exchange (e.g., Huobi, Bitfinex).
  *  - Handles both ticker and trade subscription formats (e.g., OKX, Binance).
+ *  - One fetcher per exchange adapter; `./fetch_currency_id okx huobi`
+ *    refreshes only the named exchanges.
  * 
  * Dependencies:
  *  - libcurl: HTTP client for API requests.
@@ -25,7 +27,7 @@
  *  - Writes all exchange product ID files to `currency_text_files/`.
  * 
  * Created: 4/29/2025
- * Updated: 5/8/2025
+ * Updated: 10/17/2026
  */
 
  #include <stdio.h>
@@ -687,19 +689,154 @@ void fetch_binance_product_ids_trades() {
     }
 }
 
+/* Bitfinex allows 30 channel subscriptions per connection; ticker + trades use two per symbol */
+#define BITFINEX_SYMBOLS_PER_CHUNK 15
+
+void fetch_bitfinex_product_ids() {
+    CURL *curl;
+    CURLcode res;
+
+    struct MemoryStruct chunk = {0};
+    chunk.memory = malloc(1);
+    chunk.size = 0;
+
+    curl = curl_easy_init();
+    if (curl) {
+        curl_easy_setopt(curl, CURLOPT_URL, "https://api-pub.bitfinex.com/v2/conf/pub:list:pair:exchange");
+        curl_easy_setopt(curl, CURLOPT_USERAGENT, "libcurl-agent/1.0");
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteMemoryCallback);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void *)&chunk);
+        res = curl_easy_perform(curl);
+
+        if (res == CURLE_OK) {
+            json_error_t error;
+            json_t *root = json_loads(chunk.memory, 0, &error);
+            json_t *pairs = json_array_get(root, 0);   // response is [["BTCUSD", "ETHUSD", ...]]
+
+            if (pairs && json_is_array(pairs)) {
+                size_t total = json_array_size(pairs);
+
+                /* Full list, used to size the number of connections */
+                FILE *fp = fopen("currency_text_files/bitfinex_currency_ids.txt", "w");
+                if (!fp) {
+                    fprintf(stderr, "Failed to open output file\n");
+                    json_decref(root);
+                    curl_easy_cleanup(curl);
+                    free(chunk.memory);
+                    return;
+                }
+                fprintf(fp, "[");
+                for (size_t i = 0; i < total; i++) {
+                    const char *pair = json_string_value(json_array_get(pairs, i));
+                    if (pair) fprintf(fp, "%s\"t%s\"", i > 0 ? ", " : "", pair);
+                }
+                fprintf(fp, "]\n");
+                fclose(fp);
+
+                /* One file per connection */
+                size_t chunk_index = 0;
+                for (size_t i = 0; i < total; i += BITFINEX_SYMBOLS_PER_CHUNK) {
+                    char filename[64];
+                    snprintf(filename, sizeof(filename), "currency_text_files/bitfinex_currency_chunk_%zu.txt", chunk_index++);
+                    fp = fopen(filename, "w");
+                    if (!fp) {
+                        fprintf(stderr, "[ERROR] Could not open %s for writing\n", filename);
+                        continue;
+                    }
+
+                    fprintf(fp, "[");
+                    size_t written = 0;
+                    for (size_t j = i; j < i + BITFINEX_SYMBOLS_PER_CHUNK && j < total; j++) {
+                        const char *pair = json_string_value(json_array_get(pairs, j));
+                        if (pair) {
+                            fprintf(fp, "%s\"t%s\"", written > 0 ? ", " : "", pair);
+                            written++;
+                        }
+                    }
+                    fprintf(fp, "]\n");
+                    fclose(fp);
+                }
+
+                printf("Bitfinex Product IDs saved to bitfinex_currency_ids.txt and bitfinex_currency_chunk_XX.txt\n");
+                json_decref(root);
+            } else {
+                fprintf(stderr, "[ERROR] Invalid or missing Bitfinex pair list\n");
+                if (root) json_decref(root);
+            }
+        } else {
+            fprintf(stderr, "[ERROR] curl_easy_perform() failed: %s\n", curl_easy_strerror(res));
+        }
+
+        curl_easy_cleanup(curl);
+        free(chunk.memory);
+    }
+}
+
  
- int main() {
+ /* REST fetchers per exchange, keyed by the adapter's protocol prefix (see exchange_adapter.h) */
+ typedef struct {
+     const char *exchange;
+     void (*fetch)(void);
+ } SymbolFetcher;
+
+ static void fetch_binance_symbols(void) {
+     fetch_binance_product_ids_trades();
+     fetch_binance_product_ids_trades_full();
+ }
+
+ static void fetch_coinbase_symbols(void) {
      fetch_coinbase_product_ids();
-     fetch_huobi_product_ids();
-     fetch_okx_product_ids();
-     fetch_okx_product_ids_trades();
+ }
+
+ static void fetch_kraken_symbols(void) {
      fetch_kraken_product_ids();
-     fetch_binance_product_ids_trades();
+ }
+
+ static void fetch_bitfinex_symbols(void) {
+     fetch_bitfinex_product_ids();
+ }
 
+ static void fetch_huobi_symbols(void) {
+     fetch_huobi_product_ids();
      fetch_huobi_product_ids_full();
+ }
+
+ static void fetch_okx_symbols(void) {
+     fetch_okx_product_ids();
+     fetch_okx_product_ids_trades();
      fetch_okx_product_ids_full();
      fetch_okx_product_ids_trades_full();
-     fetch_binance_product_ids_trades_full();
-     return 0;
  }
- 
\ No newline at end of file
+
+ static const SymbolFetcher symbol_fetchers[] = {
+     { "binance",  fetch_binance_symbols },
+     { "coinbase", fetch_coinbase_symbols },
+     { "kraken",   fetch_kraken_symbols },
+     { "bitfinex", fetch_bitfinex_symbols },
+     { "huobi",    fetch_huobi_symbols },
+     { "okx",      fetch_okx_symbols }
+ };
+
+ /* ./fetch_currency_id [exchange ...]: refresh the named exchanges, or all of them */
+ int main(int argc, char **argv) {
+     size_t count = sizeof(symbol_fetchers) / sizeof(symbol_fetchers[0]);
+     int status = 0;
+
+     if (argc < 2) {
+         for (size_t i = 0; i < count; i++)
+             symbol_fetchers[i].fetch();
+         return 0;
+     }
+
+     for (int a = 1; a < argc; a++) {
+         size_t i = 0;
+         while (i < count && strcmp(symbol_fetchers[i].exchange, argv[a]) != 0) i++;
+         if (i == count) {
+             fprintf(stderr, "[ERROR] No symbol fetcher for %s\n", argv[a]);
+             status = 1;
+             continue;
+         }
+         symbol_fetchers[i].fetch();
+     }
+     return status;
+ }
@@ -0,0 +1,60 @@
+/*
+ * Huge Page Allocation Header
+ *
+ * Declares the allocator for large, long-lived buffers (merge tables, send
+ * buffers, analytics windows) and a helper for the shared-memory rings, so
+ * the hot path runs on 2 MB pages with every page already mapped.
+ *
+ * Features:
+ *  - `huge_alloc()`: explicit huge pages (MAP_HUGETLB) when the system has
+ *    some reserved, else transparent huge pages (MADV_HUGEPAGE), else plain
+ *    pages. The memory is zeroed and prefaulted before it is returned, so
+ *    the first write in steady state does not take a page fault.
+ *  - `huge_prepare_shared()`: the same advice and prefault for a writer's
+ *    shared-memory mapping (tick ring, quote table). Readers map with
+ *    MAP_POPULATE. Huge pages on /dev/shm need
+ *    /sys/kernel/mm/transparent_hugepage/shmem_enabled set to `advise`
+ *    (or `always`); otherwise the advice is ignored and only prefaulting applies.
+ *  - Failure to get huge pages is never an error; only running out of
+ *    memory is.
+ *
+ * Dependencies:
+ *  - Linux mmap / madvise.
+ *
+ * Usage:
+ *        Table *t = huge_alloc(sizeof(Table) * n, "merge table");
+ *        ...
+ *        huge_free(t, sizeof(Table) * n);
+ *  - Reserve explicit huge pages with `sysctl vm.nr_hugepages=<n>`.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#ifndef HUGE_ALLOC_H
+#define HUGE_ALLOC_H
+
+#include <stddef.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#define HUGE_PAGE_SIZE (2u * 1024 * 1024)
+
+/* Zeroed, prefaulted memory of at least `size` bytes; `what` names it in the log. NULL if out of memory. */
+void *huge_alloc(size_t size, const char *what);
+
+/* Release memory from huge_alloc(); `size` must be the size it was allocated with */
+void huge_free(void *ptr, size_t size);
+
+/* Ask for huge pages on a shared mapping and, if it is writable, fault every page in now */
+static inline void huge_prepare_shared(void *addr, size_t size, int writable) {
+#ifdef MADV_HUGEPAGE
+    madvise(addr, size, MADV_HUGEPAGE);
+#endif
+    if (!writable) return;
+    long page = sysconf(_SC_PAGESIZE);
+    for (size_t off = 0; off < size; off += (size_t)page)
+        ((volatile char *)addr)[off] = 0;
+}
+
+#endif // HUGE_ALLOC_H
@@ -1,136 +1,170 @@
-/*
- * JSON Parser
- * 
- * This module provides utility functions for extracting values from JSON-formatted 
- * WebSocket messages received from cryptocurrency exchanges.
- * 
- * Features:
- *  - Extracts quoted string values from JSON messages.
- *  - Extracts numeric values from JSON messages.
- *  - Parses Bitfinex ticker price from an array-based JSON response.
- *  - Extracts currency symbols from Huobi's WebSocket channel format.
- * 
- * Dependencies:
- *  - Standard C libraries (string.h, stdlib.h).
- * 
- * Usage:
- *  - Called by `exchange_websocket.c` to process market data in WebSocket responses.
- *  - Helps transform raw WebSocket JSON messages into structured price and timestamp data.
- * 
- * Created: 3/7/2025
- * Updated: 4/14/2025
- */
-
-#include "json_parser.h"
-#include <string.h>
-#include <stdlib.h>
-
-/* Extract a quoted value from JSON using key */
-int extract_order_data(const char *json, const char *key, char *dest, size_t dest_size) {
-    const char *pos = strstr(json, key);
-    if (!pos) return 0;
-    pos += strlen(key);
-
-    if (*pos == '"') pos++;
-
-    size_t len = 0;
-    while (pos[len] && pos[len] != '"' && pos[len] != ',' && pos[len] != '}') {
-        len++;
-    }
-
-    if (len >= dest_size) len = dest_size - 1;
-    memcpy(dest, pos, len);
-    dest[len] = '\0';
-
-    return (len > 0);
-}
-
-/* Extract a quoted value from JSON array field using key */
-int extract_array_field(const char *json, const char *key, char *dest, size_t dest_size, size_t index) {
-    const char *pos = strstr(json, key);
-    if (!pos) return 0;
-    pos += strlen(key);
-
-    /* Skip index * 2 + 1 quotes to reach the desired quoted value */
-    size_t quotes_to_skip = index * 2 + 1;
-    size_t quotes_found = 0;
-    while (*pos && quotes_found < quotes_to_skip) {
-        if (*pos == '"') {
-            quotes_found++;
-        }
-        pos++;
-    }
-    /* Check if we found enough quotes */
-    if (quotes_found < quotes_to_skip) return 0;
-    
-    size_t len = strcspn(pos, "\"");
-    if (len >= dest_size) len = dest_size - 1;
-    memcpy(dest, pos, len);
-    dest[len] = '\0';
-
-    if (strcmp(dest, "\0") == 0)
-        return 0;
-    return 1;
-}
-
-/* Extract a numeric (unquoted) value from JSON using key */
-int extract_numeric(const char *json, const char *key, char *dest, size_t dest_size) {
-    const char *pos = strstr(json, key);
-    if (!pos) return 0;
-    pos += strlen(key);
-    pos += strspn(pos, " :\"");
-    size_t len = strspn(pos, "0123456789.-");
-    if (len >= dest_size) len = dest_size - 1;
-    memcpy(dest, pos, len);
-    dest[len] = '\0';
-    return 1;
-}
-
-/* Extract Bitfinex ticker price from an array message */
-int extract_bitfinex_price(const char *json, char *dest, size_t dest_size) {
-    const char *start = strchr(json, '[');
-    if (!start) return 0;
-    start++;
-    int count = 0;
-    const char *priceStart = NULL;
-    for (const char *p = start; *p; p++) {
-        if (*p == ',') {
-            if (++count == 7) {
-                priceStart = p + 1;
-                break;
-            }
-        }
-    }
-    if (!priceStart) return 0;
-    size_t len = strcspn(priceStart, ",]");
-    if (len >= dest_size) len = dest_size - 1;
-    memcpy(dest, priceStart, len);
-    dest[len] = '\0';
-    return 1;
-}
-
-/* Extract currency from Huobi channel string */
-int extract_huobi_currency(const char *json, char *dest, size_t dest_size) {
-    const char *ch_pos = strstr(json, "\"ch\":\"market.");
-    if (!ch_pos) {
-        strncpy(dest, "unknown", dest_size);
-        if (dest_size) dest[dest_size - 1] = '\0';
-        return 0;
-    }
-
-    ch_pos += strlen("\"ch\":\"market.");
-    const char *end = strchr(ch_pos, '.');  // Stops at first '.' after symbol
-    if (!end) {
-        strncpy(dest, "unknown", dest_size);
-        if (dest_size) dest[dest_size - 1] = '\0';
-        return 0;
-    }
-
-    size_t len = end - ch_pos;
-    if (len >= dest_size) len = dest_size - 1;
-
-    memcpy(dest, ch_pos, len);
-    dest[len] = '\0';
-
-    return 1;
-}
+/*
+ * JSON Parser
+ * 
+ * This module provides utility functions for extracting values from JSON-formatted 
+ * WebSocket messages received from cryptocurrency exchanges.
+ * 
+ * Features:
+ *  - Extracts quoted string values from JSON messages.
+ *  - Extracts numeric values from JSON messages.
+ *  - Splits flat arrays (Bitfinex tickers and trades) into positional fields.
+ *  - Extracts currency symbols from Huobi's WebSocket channel format.
+ *  - All searches are bounded by the message length, so messages are parsed
+ *    in place on the receive buffer without copying or NUL-terminating them.
+ * 
+ * Dependencies:
+ *  - Standard C libraries (string.h, stdlib.h).
+ * 
+ * Usage:
+ *  - Called by `exchange_websocket.c` to process market data in WebSocket responses.
+ *  - Helps transform raw WebSocket JSON messages into structured price and timestamp data.
+ * 
+ * Created: 3/7/2025
+ * Updated: 10/17/2026
+ */
+
+#define _GNU_SOURCE
+#include "json_parser.h"
+#include <string.h>
+#include <stdlib.h>
+
+/* Copy `len` bytes into `dest`, truncating to fit, and NUL-terminate */
+static size_t copy_value(const char *src, size_t len, char *dest, size_t dest_size) {
+    if (dest_size == 0) return 0;
+    if (len >= dest_size) len = dest_size - 1;
+    memcpy(dest, src, len);
+    dest[len] = '\0';
+    return len;
+}
+
+const char *json_find(const char *json, size_t len, const char *needle) {
+    return memmem(json, len, needle, strlen(needle));
+}
+
+int json_contains(const char *json, size_t len, const char *needle) {
+    return json_find(json, len, needle) != NULL;
+}
+
+/* Extract a quoted value from JSON using key */
+int extract_order_data(const char *json, size_t len, const char *key, char *dest, size_t dest_size) {
+    const char *end = json + len;
+    const char *pos = json_find(json, len, key);
+    if (!pos) return 0;
+    pos += strlen(key);
+
+    if (pos < end && *pos == '"') pos++;
+
+    const char *val = pos;
+    while (pos < end && *pos != '"' && *pos != ',' && *pos != '}') {
+        pos++;
+    }
+
+    return copy_value(val, pos - val, dest, dest_size) > 0;
+}
+
+/* Extract a quoted value from JSON array field using key */
+int extract_array_field(const char *json, size_t len, const char *key, char *dest, size_t dest_size, size_t index) {
+    const char *end = json + len;
+    const char *pos = json_find(json, len, key);
+    if (!pos) return 0;
+    pos += strlen(key);
+
+    /* Skip index * 2 + 1 quotes to reach the desired quoted value */
+    size_t quotes_to_skip = index * 2 + 1;
+    size_t quotes_found = 0;
+    while (pos < end && quotes_found < quotes_to_skip) {
+        if (*pos == '"') {
+            quotes_found++;
+        }
+        pos++;
+    }
+    /* Check if we found enough quotes */
+    if (quotes_found < quotes_to_skip) return 0;
+
+    const char *val = pos;
+    while (pos < end && *pos != '"') pos++;
+
+    return copy_value(val, pos - val, dest, dest_size) > 0;
+}
+
+/* Extract a numeric (unquoted) value from JSON using key */
+int extract_numeric(const char *json, size_t len, const char *key, char *dest, size_t dest_size) {
+    const char *end = json + len;
+    const char *pos = json_find(json, len, key);
+    if (!pos) return 0;
+    pos += strlen(key);
+    while (pos < end && (*pos == ' ' || *pos == ':' || *pos == '"')) pos++;
+
+    const char *val = pos;
+    while (pos < end && ((*pos >= '0' && *pos <= '9') || *pos == '.' || *pos == '-')) pos++;
+
+    copy_value(val, pos - val, dest, dest_size);
+    return 1;
+}
+
+/* Split a flat array such as [1,"te",2.5] into fields; nested arrays and objects are not supported */
+int split_flat_array(const char *json, size_t len, JsonField *fields, int max_fields) {
+    const char *end = json + len;
+    const char *p = json;
+    if (p >= end || *p != '[') return -1;
+    p++;
+
+    int count = 0;
+    while (p < end) {
+        while (p < end && *p == ' ') p++;
+        if (p < end && *p == ']' && count == 0) return 0;
+
+        const char *start = p;
+        if (p < end && *p == '"') {
+            p++;
+            while (p < end && *p != '"') p++;
+            if (p < end) p++;
+        } else {
+            while (p < end && *p != ',' && *p != ']') {
+                if (*p == '[' || *p == '{') return -1;
+                p++;
+            }
+        }
+        if (p >= end) return -1;
+
+        if (count < max_fields) {
+            fields[count].ptr = start;
+            fields[count].len = p - start;
+        }
+        count++;
+
+        if (*p == ']') return count < max_fields ? count : max_fields;
+        if (*p != ',') return -1;
+        p++;
+    }
+    return -1;
+}
+
+int copy_field(const JsonField *field, char *dest, size_t dest_size) {
+    const char *src = field->ptr;
+    size_t len = field->len;
+    if (len >= 2 && src[0] == '"' && src[len - 1] == '"') {
+        src++;
+        len -= 2;
+    }
+    return copy_value(src, len, dest, dest_size) > 0;
+}
+
+/* Extract currency from Huobi channel string */
+int extract_huobi_currency(const char *json, size_t len, char *dest, size_t dest_size) {
+    static const char prefix[] = "\"ch\":\"market.";
+    const char *ch_pos = json_find(json, len, prefix);
+    const char *end = NULL;
+    if (ch_pos) {
+        ch_pos += sizeof(prefix) - 1;
+        end = memchr(ch_pos, '.', (json + len) - ch_pos);  // Stops at first '.' after symbol
+    }
+    if (!end) {
+        strncpy(dest, "unknown", dest_size);
+        if (dest_size) dest[dest_size - 1] = '\0';
+        return 0;
+    }
+
+    copy_value(ch_pos, end - ch_pos, dest, dest_size);
+    return 1;
+}
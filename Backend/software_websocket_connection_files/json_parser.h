@@ -1,41 +1,65 @@
-/*
- * JSON Parser Header
- * 
- * This header file declares functions used for extracting data from JSON-formatted
- * WebSocket messages received from cryptocurrency exchanges.
- * 
- * Functionality:
- *  - `extract_order_data()`: Extracts a quoted string value (e.g., price) from JSON.
- *  - `extract_numeric()`: Extracts a numeric (unquoted) value from JSON.
- *  - `extract_bitfinex_price()`: Extracts ticker price from a Bitfinex array message.
- *  - `extract_huobi_currency()`: Extracts currency identifiers from Huobi's channel string.
- * 
- * Dependencies:
- *  - Standard C library (stddef.h) for size definitions.
- * 
- * Usage:
- *  - Implemented in `json_parser.c`.
- *  - Used in `exchange_websocket.c` for parsing WebSocket market data.
- * 
- * Created: 3/7/2025
- * Updated: 5/7/2025
- */
-
-#ifndef JSON_PARSER_H
-#define JSON_PARSER_H
-
-#include <stddef.h>
-
-/* Extract a quoted value from JSON using the specified key */
-int extract_order_data(const char *json, const char *key, char *dest, size_t dest_size);
-
-/* Extract a numeric (unquoted) value from JSON using the specified key */
-int extract_numeric(const char *json, const char *key, char *dest, size_t dest_size);
-
-/* Extract Bitfinex ticker price from an array message */
-int extract_bitfinex_price(const char *json, char *dest, size_t dest_size);
-
-/* Extract currency from Huobi channel string */
-int extract_huobi_currency(const char *json, char *dest, size_t dest_size);
-
-#endif // JSON_PARSER_H
+/*
+ * JSON Parser Header
+ * 
+ * This header file declares functions used for extracting data from JSON-formatted
+ * WebSocket messages received from cryptocurrency exchanges.
+ * 
+ * Every function takes the message as a (pointer, length) view and never
+ * reads past `json + len`, so callers can parse the libwebsockets receive
+ * buffer in place; the message does not need to be NUL-terminated.
+ * 
+ * Functionality:
+ *  - `json_find()` / `json_contains()`: Bounded substring search in a message.
+ *  - `extract_order_data()`: Extracts a quoted string value (e.g., price) from JSON.
+ *  - `extract_array_field()`: Extracts the N-th quoted value of an array field.
+ *  - `extract_numeric()`: Extracts a numeric (unquoted) value from JSON.
+ *  - `split_flat_array()`: Splits a flat JSON array into positional (ptr, len) fields.
+ *  - `extract_huobi_currency()`: Extracts currency identifiers from Huobi's channel string.
+ * 
+ * Dependencies:
+ *  - Standard C library (stddef.h) for size definitions.
+ * 
+ * Usage:
+ *  - Implemented in `json_parser.c`.
+ *  - Used by the exchange adapters (`adapter_*.c`) for parsing WebSocket market data.
+ * 
+ * Created: 3/7/2025
+ * Updated: 10/17/2026
+ */
+
+#ifndef JSON_PARSER_H
+#define JSON_PARSER_H
+
+#include <stddef.h>
+
+/* Find `needle` within the first `len` bytes of `json`; NULL if absent */
+const char *json_find(const char *json, size_t len, const char *needle);
+
+/* Non-zero if `needle` occurs within the first `len` bytes of `json` */
+int json_contains(const char *json, size_t len, const char *needle);
+
+/* Extract a quoted value from JSON using the specified key */
+int extract_order_data(const char *json, size_t len, const char *key, char *dest, size_t dest_size);
+
+/* Extract the `index`-th quoted value from a JSON array field */
+int extract_array_field(const char *json, size_t len, const char *key, char *dest, size_t dest_size, size_t index);
+
+/* Extract a numeric (unquoted) value from JSON using the specified key */
+int extract_numeric(const char *json, size_t len, const char *key, char *dest, size_t dest_size);
+
+/* One positional field of a JSON array, pointing into the message */
+typedef struct {
+    const char *ptr;
+    size_t len;
+} JsonField;
+
+/* Split the flat array starting at `json` ('[') into at most `max_fields` fields; returns the count, -1 if malformed */
+int split_flat_array(const char *json, size_t len, JsonField *fields, int max_fields);
+
+/* Copy a field into `dest` as a NUL-terminated string, dropping surrounding quotes */
+int copy_field(const JsonField *field, char *dest, size_t dest_size);
+
+/* Extract currency from Huobi channel string */
+int extract_huobi_currency(const char *json, size_t len, char *dest, size_t dest_size);
+
+#endif // JSON_PARSER_H
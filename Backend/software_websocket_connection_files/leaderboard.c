@@ -0,0 +1,213 @@
+/*
+ * Leaderboard
+ *
+ * Implements the top-N boards of `leaderboard.h`. Symbols are identified
+ * by their analytics slot index, so every per-symbol array is indexed
+ * directly and the heaps store plain ints.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#include "leaderboard.h"
+#include "symbol_registry.h"
+#include "currency_graph.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+
+#define SYMBOLS ANALYTICS_TABLE_SLOTS
+
+typedef struct {
+    int item[SYMBOLS];
+    int size;
+    int max;                        // 1 = max-heap, 0 = min-heap
+} Heap;
+
+typedef struct {
+    double key[SYMBOLS];            // rank, higher is better
+    double value[SYMBOLS];          // value shown: signed % move, USD volume or trades
+    int pos[SYMBOLS];               // position in the heap holding the symbol
+    uint8_t in[SYMBOLS];            // 0 = not ranked yet, 1 = top, 2 = rest
+    Heap top;                       // min-heap: the current top LEADERBOARD_TOP_N, weakest at the root
+    Heap rest;                      // max-heap: everyone else, strongest at the root
+} Board;
+
+static Board boards[LEADERBOARD_BOARDS];
+static const char *board_names[LEADERBOARD_BOARDS] = { "movers_1m", "movers_5m", "movers_1h", "volume_1h", "trades_1h" };
+static const char *value_names[LEADERBOARD_BOARDS] = { "change_pct", "change_pct", "change_pct", "usd", "trades" };
+static const int mover_windows[3] = { ANALYTICS_1M, ANALYTICS_5M, ANALYTICS_1H };
+
+static const char *exchanges[SYMBOLS];
+static const char *symbols[SYMBOLS];
+static double last_prices[SYMBOLS];
+static int registry_ids[SYMBOLS];           // -2 = not resolved yet
+static int started = 0;
+static int changed = 0;
+
+/* `x` belongs nearer the root of `h` than `y` */
+static int above(const Board *b, const Heap *h, int x, int y) {
+    return h->max ? b->key[x] > b->key[y] : b->key[x] < b->key[y];
+}
+
+static void place(Board *b, Heap *h, int i, int x) {
+    h->item[i] = x;
+    b->pos[x] = i;
+}
+
+static void sift_up(Board *b, Heap *h, int i) {
+    int x = h->item[i];
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!above(b, h, x, h->item[parent])) break;
+        place(b, h, i, h->item[parent]);
+        i = parent;
+    }
+    place(b, h, i, x);
+}
+
+static void sift_down(Board *b, Heap *h, int i) {
+    int x = h->item[i];
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= h->size) break;
+        if (child + 1 < h->size && above(b, h, h->item[child + 1], h->item[child])) child++;
+        if (!above(b, h, h->item[child], x)) break;
+        place(b, h, i, h->item[child]);
+        i = child;
+    }
+    place(b, h, i, x);
+}
+
+static void push(Board *b, Heap *h, int x) {
+    place(b, h, h->size++, x);
+    sift_up(b, h, h->size - 1);
+}
+
+static int pop(Board *b, Heap *h) {
+    int x = h->item[0];
+    if (--h->size > 0) {
+        place(b, h, 0, h->item[h->size]);
+        sift_down(b, h, 0);
+    }
+    return x;
+}
+
+static void set_key(Board *b, int x, double key, double value) {
+    int was_top = b->in[x] == 1;
+    b->value[x] = value;
+    if (b->key[x] == key && b->in[x]) {
+        if (was_top) changed = 1;
+        return;
+    }
+    b->key[x] = key;
+
+    if (!b->in[x]) {
+        if (key <= 0) return;
+        if (b->top.size < LEADERBOARD_TOP_N) {
+            b->in[x] = 1;
+            push(b, &b->top, x);
+        } else {
+            b->in[x] = 2;
+            push(b, &b->rest, x);
+        }
+    } else {
+        Heap *h = was_top ? &b->top : &b->rest;
+        sift_up(b, h, b->pos[x]);
+        sift_down(b, h, b->pos[x]);
+    }
+
+    /* Swap the roots while the best of the rest beats the weakest of the top */
+    if (b->rest.size && b->top.size == LEADERBOARD_TOP_N &&
+        b->key[b->rest.item[0]] > b->key[b->top.item[0]]) {
+        int up = pop(b, &b->rest), down = pop(b, &b->top);
+        b->in[up] = 1;
+        push(b, &b->top, up);
+        b->in[down] = 2;
+        push(b, &b->rest, down);
+    }
+    if (was_top || b->in[x] == 1) changed = 1;
+}
+
+void leaderboard_start() {
+    memset(boards, 0, sizeof(boards));
+    for (int k = 0; k < LEADERBOARD_BOARDS; k++) boards[k].rest.max = 1;
+    for (int i = 0; i < SYMBOLS; i++) registry_ids[i] = -2;
+    changed = 0;
+    started = 1;
+}
+
+void leaderboard_update(int index, const char *exchange, const char *symbol, double last_price,
+                        const AnalyticsWindow window[ANALYTICS_WINDOWS]) {
+    if (!started) return;
+    exchanges[index] = exchange;
+    symbols[index] = symbol;
+    last_prices[index] = last_price;
+    if (registry_ids[index] == -2) registry_ids[index] = symbol_registry_id(exchange, symbol);
+
+    for (int k = 0; k < 3; k++) {
+        const AnalyticsWindow *w = &window[mover_windows[k]];
+        double change = (w->trades && w->open > 0) ? (last_price / w->open - 1.0) * 100.0 : 0.0;
+        set_key(&boards[BOARD_MOVERS_1M + k], index, fabs(change), change);
+    }
+
+    const AnalyticsWindow *hour = &window[ANALYTICS_1H];
+    int id = registry_ids[index];
+    double usd = id >= 0 ? currency_graph_usd(id, hour->volume * hour->vwap) : 0.0;
+    set_key(&boards[BOARD_VOLUME_1H], index, usd, usd);
+    set_key(&boards[BOARD_TRADES_1H], index, (double)hour->trades, (double)hour->trades);
+}
+
+static void write_board(FILE *fp, const Board *b, int kind) {
+    int order[LEADERBOARD_TOP_N];
+    int count = 0;
+
+    /* The top heap is unordered beyond its root; sort its few entries best first */
+    for (int i = 0; i < b->top.size; i++) {
+        int x = b->top.item[i];
+        if (b->key[x] <= 0) continue;
+        int j = count++;
+        while (j > 0 && b->key[order[j - 1]] < b->key[x]) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = x;
+    }
+
+    fprintf(fp, "\"%s\":[", board_names[kind]);
+    for (int i = 0; i < count; i++) {
+        int x = order[i];
+        fprintf(fp, "%s{\"exchange\":\"%s\",\"symbol\":\"%s\",\"price\":%.10g,\"%s\":%.6g}", i ? "," : "",
+                exchanges[x], symbols[x], last_prices[x], value_names[kind], b->value[x]);
+    }
+    fputc(']', fp);
+}
+
+void leaderboard_publish(int64_t now_ns) {
+    if (!started || !changed) return;
+
+    char tmp_name[256];
+    snprintf(tmp_name, sizeof(tmp_name), "%s.tmp", LEADERBOARD_FILE);
+    FILE *fp = fopen(tmp_name, "w");
+    if (!fp) {
+        printf("[ERROR] Failed to write %s: %s\n", tmp_name, strerror(errno));
+        return;
+    }
+
+    fprintf(fp, "{\"time_ms\":%lld", (long long)(now_ns / 1000000));
+    for (int k = 0; k < LEADERBOARD_BOARDS; k++) {
+        fputs(",\n", fp);
+        write_board(fp, &boards[k], k);
+    }
+    fputs("}\n", fp);
+
+    if (fclose(fp) != 0 || rename(tmp_name, LEADERBOARD_FILE) != 0)
+        printf("[ERROR] Failed to publish %s: %s\n", LEADERBOARD_FILE, strerror(errno));
+    changed = 0;
+}
+
+void leaderboard_stop() {
+    started = 0;
+}
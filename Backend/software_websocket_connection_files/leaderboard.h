@@ -0,0 +1,62 @@
+/*
+ * Leaderboard Header
+ *
+ * Declares the top-N leaderboards kept next to the trade analytics:
+ * biggest 1m / 5m / 1h movers, highest 1h USD volume and most 1h trades,
+ * across every (exchange, symbol).
+ *
+ * Features:
+ *  - Each board is two indexed binary heaps over the analytics symbols: a
+ *    min-heap holding the current top LEADERBOARD_TOP_N and a max-heap
+ *    holding the rest. A symbol knows its heap position, so a key change
+ *    is one sift plus at most one swap between the heaps: O(log symbols).
+ *  - Keys come from the analytics windows whenever a symbol's windows are
+ *    republished (after each trade, and once a second while they age).
+ *    Movers rank by |last / open - 1| and keep the sign; volume is
+ *    converted to USD by the currency graph (`currency_graph.h`).
+ *  - Published by rewriting LEADERBOARD_FILE (temporary file + rename)
+ *    on the analytics refresh cadence when any board changed. Each board
+ *    is a few hundred bytes, so clients no longer sort the trade log
+ *    themselves.
+ *
+ * Dependencies:
+ *  - analytics_table.h, symbol_registry.h, currency_graph.h.
+ *
+ * Usage:
+ *  - Driven by `trade_analytics.c`, which starts, feeds, publishes and
+ *    stops it. Service thread only.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#ifndef LEADERBOARD_H
+#define LEADERBOARD_H
+
+#include "analytics_table.h"
+
+#define LEADERBOARD_FILE "leaderboard_output_data.json"
+#define LEADERBOARD_TOP_N 10
+
+typedef enum {
+    BOARD_MOVERS_1M = 0,
+    BOARD_MOVERS_5M,
+    BOARD_MOVERS_1H,
+    BOARD_VOLUME_1H,                // USD notional
+    BOARD_TRADES_1H,
+    LEADERBOARD_BOARDS
+} LeaderboardKind;
+
+/* Empty every board */
+void leaderboard_start();
+
+/* New window values for analytics slot `index`; `exchange` and `symbol` must stay valid until stop */
+void leaderboard_update(int index, const char *exchange, const char *symbol, double last_price,
+                        const AnalyticsWindow window[ANALYTICS_WINDOWS]);
+
+/* Rewrite the snapshot file if any board changed since the last call */
+void leaderboard_publish(int64_t now_ns);
+
+void leaderboard_stop();
+
+#endif // LEADERBOARD_H
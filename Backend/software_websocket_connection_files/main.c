@@ -1,174 +1,195 @@
-/*
- * Crypto Exchange WebSocket
- * 
- * This program connects to multiple cryptocurrency exchanges via WebSocket APIs
- * to receive real-time market data, extract relevant information, and log both 
- * ticker prices and trade prices along with timestamps to separate .json files. 
- * 
- * Supported Exchanges:
- *  - Binance    (Ticker + Trade)
- *  - Coinbase   (Ticker + Trade)
- *  - Kraken     (Ticker + Trade)
- *  - Huobi      (Ticker + Trade)
- *  - OKX        (Ticker + Trade)
- *  - Bitfinex   (Planned)
- * 
- * The program uses the libwebsockets library to establish and manage 
- * WebSocket connections. It implements event-driven callbacks to handle 
- * WebSocket events such as connection establishment, message reception, 
- * ping/pong, and disconnection.
- * 
- * Features:
- *  - Extracts and logs ticker and trade price data from incoming JSON messages.
- *  - Converts Binance millisecond timestamps to ISO 8601 format.
- *  - Supports multiple concurrent WebSocket connections.
- *  - Automatic reconnection with exponential backoff on connection failures.
- *  - Periodic health monitoring for each exchange's connection.
- *  - Logs data into separate `.json` and `.bson` files for tickers and trades.
- * 
- * Dependencies:
- *
- *  External Libraries:
- *  -------------------
- *  - libwebsockets (`-lwebsockets`)
- *      Required for managing WebSocket connections, handling protocols, and asynchronous messaging.
- * 
- *  - jansson (`-ljansson`)
- *      Used for parsing, reading, and constructing JSON data structures (e.g., market data responses).
- * 
- *  - libbson (`-lbson-1.0`)
- *      Used to serialize ticker/trade data into BSON format for efficient storage and future analysis.
- * 
- *  - zlib (`-lz`)
- *      Used for decompressing WebSocket message payloads (e.g., Huobi uses gzip).
- * 
- *  - libm (`-lm`)
- *      Standard math library used in calculations (e.g., float handling, price comparisons).
- * 
- *  - libcurl (`-lcurl`)
- *      Required to fetch product ID lists from exchange REST APIs before WebSocket subscriptions.
- * 
- *  Standard C Libraries:
- *  ---------------------
- *  - `stdio.h`      : File I/O and standard output.
- *  - `stdlib.h`     : Memory allocation, process control.
- *  - `string.h`     : String manipulation and comparison.
- *  - `time.h` / `sys/time.h` : Timestamping and formatting.
- *  - `unistd.h`     : Sleep/delay and POSIX API usage.
- *  - `pthread.h`    : Used for running background health monitoring threads.
- *
- *  Notes:
- *  - Make sure all libraries are installed and discoverable via your system's compiler/linker path.
- *  - For Debian/Ubuntu: use `apt install libwebsockets-dev libjansson-dev libcurl4-openssl-dev libbson-1.0-0 zlib1g-dev`
- * 
- * Usage:
- *    See README for build instructions.
- *    Run the program:
- *        ./crypto_ws
- * 
- * Created:  3/7/2025
- * Updated:  5/12/2025
- */
- 
-#include <stdio.h>
-#include <string.h>
-#include <stdlib.h>
-#include <libwebsockets.h>
-#include <errno.h>
-#include <pthread.h>
-
-#include "exchange_websocket.h"
-#include "exchange_connect.h"
-#include "utils.h"
-
-/* External declaration of WebSocket protocols */
-extern struct lws_protocols protocols[];
-
-/* Global WebSocket context */
-struct lws_context *context;
-
-/* Global WebSocket context */
-void start_health_monitor(void);
-
-int main() {
-    printf("[INFO] Starting Crypto WebSocket Data Logger...\n");
-
-    struct lws_context_creation_info context_info;
-    memset(&context_info, 0, sizeof(context_info));
-    context_info.port = CONTEXT_PORT_NO_LISTEN;
-    context_info.protocols = protocols;
-    context_info.options = LWS_SERVER_OPTION_DO_SSL_GLOBAL_INIT;
-
-    context = lws_create_context(&context_info);
-    if (!context) {
-        printf("[ERROR] Failed to create WebSocket context\n");
-        return -1;
-    }
-
-    ticker_data_file = fopen("ticker_output_data.json", "a");
-    if (!ticker_data_file) {
-        printf("[ERROR] Failed to open ticker log file\n");
-        lws_context_destroy(context);
-        return -1;
-    }
-
-    trades_data_file = fopen("trades_output_data.json", "a");
-    if (!trades_data_file) {
-        printf("[ERROR] Failed to open trades log file\n");
-        lws_context_destroy(context);
-        return -1;
-    }
-    
-    // Start JSON files
-    init_json_buffers();
-
-    // Multithread connections
-    start_exchange_connections();  
-
-    // Start connection health tracking
-    start_health_monitor();
-
-    // Connect to exchanges
-    // int total_symbols_binance = count_symbols_in_file("currency_text_files/binance_currency_ids_trades.txt");
-    // int num_chunks_binance = (total_symbols_binance + 99) / 100;
-    // for (int i = 0; i < num_chunks_binance; i++) {
-    //     connect_to_binance(i);
-    //     usleep(50000);
-    // }   
-
-    // connect_to_coinbase();
-    // usleep(50000);
-
-    // int total_symbols_huobi = count_symbols_in_file("currency_text_files/huobi_currency_ids.txt");
-    // int num_chunks_huobi = (total_symbols_huobi + 99) / 100;
-    // for (int i = 0; i < num_chunks_huobi; i++) {
-    //     connect_to_huobi(i);
-    //     usleep(50000);
-    // }    
-
-    // connect_to_kraken();
-    // usleep(50000);
-
-    // int total_symbols_okx = count_symbols_in_file("currency_text_files/okx_currency_ids.txt");
-    // int num_chunks_okx = (total_symbols_okx + 99) / 100;
-    // for (int i = 0; i < num_chunks_okx; i++) {
-    //     connect_to_okx(i);
-    //     usleep(50000);
-    // }    
-
-    // connect_to_bitfinex();
-
-    printf("[INFO] All WebSocket connections initialized. Listening for data...\n");
-
-    // Event loop: Handles incoming WebSocket messages and reconnections
-    while (lws_service(context, 10) >= 0) {}
-
-    printf("[INFO] Cleaning up WebSocket context...\n");
-    flush_buffer_to_file("ticker_output_data.json", ticker_buffer);
-    flush_buffer_to_file("trades_output_data.json", trades_buffer);
-    fclose(ticker_data_file);
-    fclose(trades_data_file);
-    lws_context_destroy(context);
-
-    return 0;
-}
+/*
+ * Crypto Exchange WebSocket
+ * 
+ * This program connects to multiple cryptocurrency exchanges via WebSocket APIs
+ * to receive real-time market data, extract relevant information, and log both 
+ * ticker prices and trade prices along with timestamps to separate .json files. 
+ * 
+ * Supported Exchanges:
+ *  - Binance    (Ticker + Trade)
+ *  - Coinbase   (Ticker + Trade)
+ *  - Kraken     (Ticker + Trade)
+ *  - Huobi      (Ticker + Trade)
+ *  - OKX        (Ticker + Trade)
+ *  - Bitfinex   (Ticker + Trade)
+ * 
+ * The program uses the libwebsockets library to establish and manage 
+ * WebSocket connections. It implements event-driven callbacks to handle 
+ * WebSocket events such as connection establishment, message reception, 
+ * ping/pong, and disconnection.
+ * 
+ * Features:
+ *  - Extracts and logs ticker and trade price data from incoming JSON messages.
+ *  - Converts Binance millisecond timestamps to ISO 8601 format.
+ *  - Supports multiple concurrent WebSocket connections, opened by a
+ *    rate-limited orchestrator that runs inside the event loop.
+ *  - Automatic reconnection with exponential backoff on connection failures.
+ *  - Cached DNS answers and TLS session resumption for fast reconnects.
+ *  - Optional permessage-deflate per exchange with compression statistics.
+ *  - Per-symbol feed profiles (`feed_profiles.conf`) pick the lightest quote channel.
+ *  - Publishes the latest quote per symbol to a shared-memory table (`quote_table.h`)
+ *    and every update to a shared-memory broadcast ring (`tick_ring.h`).
+ *  - Periodic health monitoring for each exchange's connection.
+ *  - Logs data into separate `.json` and `.bson` files for tickers and trades.
+ *  - All of the above lives in `libcryptofeed.a` (`cryptofeed.h`); this file
+ *    is a thin host that runs the feed with every output enabled.
+ *  - `--supervise` runs one collector process per exchange or connection shard
+ *    under an aggregator that merges their records (`supervisor.c`).
+ *  - `CRYPTO_WS_LOW_LATENCY` pins the service thread and busy-polls instead
+ *    of sleeping between events (see README).
+ *  - `CRYPTO_WS_PRICE_FILTER` (off / flag / quarantine) sets what happens to
+ *    bad ticks (see README).
+ *  - `CRYPTO_WS_KTLS=on` moves inbound TLS decryption into the kernel (see README).
+ *  - `--node` also streams every record to a merge node over TCP
+ *    (`node_sender.c`); `--merge` runs that merge node (`merge_node.c`).
+ * 
+ * Dependencies:
+ *
+ *  External Libraries:
+ *  -------------------
+ *  - libwebsockets (`-lwebsockets`)
+ *      Required for managing WebSocket connections, handling protocols, and asynchronous messaging.
+ * 
+ *  - jansson (`-ljansson`)
+ *      Used for parsing, reading, and constructing JSON data structures (e.g., market data responses).
+ * 
+ *  - libbson (`-lbson-1.0`)
+ *      Used to serialize ticker/trade data into BSON format for efficient storage and future analysis.
+ * 
+ *  - zlib (`-lz`)
+ *      Used for decompressing WebSocket message payloads (e.g., Huobi uses gzip).
+ * 
+ *  - libm (`-lm`)
+ *      Standard math library used in calculations (e.g., float handling, price comparisons).
+ * 
+ *  - libcurl (`-lcurl`)
+ *      Required to fetch product ID lists from exchange REST APIs before WebSocket subscriptions.
+ * 
+ *  Standard C Libraries:
+ *  ---------------------
+ *  - `stdio.h`      : File I/O and standard output.
+ *  - `stdlib.h`     : Memory allocation, process control.
+ *  - `string.h`     : String manipulation and comparison.
+ *  - `time.h` / `sys/time.h` : Timestamping and formatting.
+ *  - `unistd.h`     : Sleep/delay and POSIX API usage.
+ *
+ *  Notes:
+ *  - Make sure all libraries are installed and discoverable via your system's compiler/linker path.
+ *  - For Debian/Ubuntu: use `apt install libwebsockets-dev libjansson-dev libcurl4-openssl-dev libbson-1.0-0 zlib1g-dev`
+ * 
+ * Usage:
+ *    See README for build instructions.
+ *    Run the program:
+ *        ./crypto_ws
+ *        ./crypto_ws --supervise                    (one process per exchange)
+ *        ./crypto_ws --supervise binance/2 okx      (selected exchanges, Binance split in two)
+ *        ./crypto_ws --node merge-host:9100 [name]  (collector on a redundant host)
+ *        ./crypto_ws --merge 9100 [output_dir]      (merge node)
+ * 
+ * Created:  3/7/2025
+ * Updated:  10/17/2026
+ */
+ 
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "cryptofeed.h"
+#include "supervisor.h"
+#include "node_link.h"
+#include "merge_node.h"
+
+static void forward_to_merge_node(const MarketRecord *record, void *user) {
+    (void)user;
+    node_sender_write(record);
+}
+
+/* Parse "host:port"; returns the port, or -1 if it is missing */
+static int split_host_port(char *arg) {
+    char *colon = strrchr(arg, ':');
+    if (!colon || !colon[1]) return -1;
+    *colon = '\0';
+    int port = atoi(colon + 1);
+    return (port > 0 && port < 65536) ? port : -1;
+}
+
+int main(int argc, char **argv) {
+    printf("[INFO] Starting Crypto WebSocket Data Logger...\n");
+
+    if (argc > 1 && strcmp(argv[1], "--supervise") == 0) {
+        CollectorShard shards[SUPERVISOR_MAX_CHILDREN];
+        int count = supervisor_parse_shards(argc - 2, argv + 2, shards, SUPERVISOR_MAX_CHILDREN);
+        if (count < 0) return -1;
+        return supervisor_run(shards, count);
+    }
+
+    if (argc > 2 && strcmp(argv[1], "--merge") == 0) {
+        MergeNodeConfig merge_config;
+        merge_node_default_config(&merge_config);
+        merge_config.port = atoi(argv[2]);
+        if (argc > 3) merge_config.output_dir = argv[3];
+        return merge_node_run(&merge_config);
+    }
+
+    int node_mode = argc > 2 && strcmp(argv[1], "--node") == 0;
+
+    // crypto_ws runs the feed with every output on: JSON/BSON logs and the shared-memory table and ring
+    CryptoFeedConfig config;
+    cryptofeed_default_config(&config);
+
+    // CRYPTO_WS_LOW_LATENCY=on or e.g. "service=3,housekeeping=0,busy_poll=50" spins the service thread
+    const char *low_latency = getenv("CRYPTO_WS_LOW_LATENCY");
+    if (low_latency && cryptofeed_config_low_latency(&config, low_latency) != 0) return -1;
+
+    // CRYPTO_WS_KTLS=on decrypts inbound records in the kernel where OpenSSL and the kernel allow it
+    const char *ktls = getenv("CRYPTO_WS_KTLS");
+    config.ktls = ktls && strcmp(ktls, "on") == 0;
+
+    // CRYPTO_WS_PRICE_FILTER=off|flag|quarantine; outliers are flagged by default
+    const char *price_filter = getenv("CRYPTO_WS_PRICE_FILTER");
+    if (price_filter && cryptofeed_config_price_filter(&config, price_filter) != 0) return -1;
+
+    // CRYPTO_WS_TAKER_FEES=binance=0,okx=8 overrides the taker fees (bps) the arbitrage detector nets out
+    config.taker_fees = getenv("CRYPTO_WS_TAKER_FEES");
+
+    // CRYPTO_WS_ALERT_RULES=path reads the alert rules from another file than alert_rules.conf
+    config.alert_rules_file = getenv("CRYPTO_WS_ALERT_RULES");
+
+    CryptoFeed *feed = cryptofeed_create(&config);
+    if (!feed) {
+        printf("[ERROR] Failed to create the market data feed\n");
+        return -1;
+    }
+
+    int result;
+    if (node_mode) {
+        char node_name[NODE_NAME_LEN] = "collector";
+        if (argc > 3) snprintf(node_name, sizeof(node_name), "%s", argv[3]);
+        else gethostname(node_name, sizeof(node_name) - 1);
+
+        int port = split_host_port(argv[2]);
+        if (port < 0 || node_sender_start(argv[2], port, node_name) != 0) {
+            printf("[ERROR] Invalid merge node address, expected <host>:<port>\n");
+            cryptofeed_destroy(feed);
+            return -1;
+        }
+        cryptofeed_on_ticker(feed, forward_to_merge_node, NULL);
+        cryptofeed_on_book(feed, forward_to_merge_node, NULL);
+        cryptofeed_on_trade(feed, forward_to_merge_node, NULL);
+        cryptofeed_start(feed);
+
+        printf("[INFO] All WebSocket connections initialized. Listening for data...\n");
+        while (cryptofeed_service(feed, 10) == 0) node_sender_poll();
+        node_sender_stop();
+        result = 0;
+    } else {
+        printf("[INFO] All WebSocket connections initialized. Listening for data...\n");
+        result = cryptofeed_run(feed);
+    }
+
+    printf("[INFO] Cleaning up WebSocket context...\n");
+    cryptofeed_destroy(feed);
+
+    return result;
+}
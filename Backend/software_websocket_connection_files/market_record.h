@@ -0,0 +1,69 @@
+/*
+ * Market Record Header
+ *
+ * Declares the fixed-size binary record used to hand parsed market data to
+ * other processes (the shared-memory tick ring and later transports).
+ *
+ * Features:
+ *  - One 112-byte record per ticker, top-of-book quote or trade.
+ *  - Plain C layout with fixed-width fields; no pointers, so records can be
+ *    copied between processes as they are.
+ *  - Prices and sizes are doubles parsed from the exchange strings.
+ *
+ * Dependencies:
+ *  - Standard C library (stdint.h).
+ *
+ * Usage:
+ *  - Filled by the collector (`tick_publisher.c`).
+ *  - Read by consumers through `tick_ring.h`.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#ifndef MARKET_RECORD_H
+#define MARKET_RECORD_H
+
+#include <stdint.h>
+
+#define MARKET_RECORD_EXCHANGE_LEN 12
+#define MARKET_RECORD_SYMBOL_LEN 24
+
+typedef enum {
+    MARKET_RECORD_NONE = 0,
+    MARKET_RECORD_TICKER,           // price plus whatever bid/ask the ticker carries
+    MARKET_RECORD_QUOTE,            // best bid/ask only
+    MARKET_RECORD_TRADE             // price and size of one trade
+} MarketRecordKind;
+
+/* Aggressor of a trade (the side that took liquidity) */
+typedef enum {
+    MARKET_SIDE_UNKNOWN = 0,
+    MARKET_SIDE_BUY,                // buyer was the taker ("market_maker": "false")
+    MARKET_SIDE_SELL                // seller was the taker ("market_maker": "true")
+} MarketSide;
+
+#define MARKET_FLAG_OUTLIER 0x0001      // price filter judged the price a bad tick (`price_filter.h`)
+
+typedef struct {
+    uint8_t kind;                   // MarketRecordKind
+    uint8_t side;                   // MarketSide of a trade
+    uint16_t flags;                 // MARKET_FLAG_*
+    char exchange[MARKET_RECORD_EXCHANGE_LEN];
+    char symbol[MARKET_RECORD_SYMBOL_LEN];
+
+    double price;
+    double size;                    // trades only
+    double bid;
+    double ask;
+    double bid_qty;
+    double ask_qty;
+
+    int64_t event_ms;               // exchange event time, 0 if unknown
+    int64_t recv_ns;                // CLOCK_REALTIME when the collector parsed it
+    uint64_t trade_id;              // numeric trade ID, 0 if the exchange has none
+} MarketRecord;
+
+_Static_assert(sizeof(MarketRecord) == 112, "MarketRecord layout is shared with other processes");
+
+#endif // MARKET_RECORD_H
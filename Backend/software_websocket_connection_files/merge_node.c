@@ -0,0 +1,589 @@
+/*
+ * Merge Node
+ *
+ * Receives `MarketRecord` streams from collector nodes over TCP, removes
+ * the duplicates redundant collectors produce and writes one canonical
+ * store (see `merge_node.h` for the merge rules).
+ *
+ * Features:
+ *  - One thread: poll() over the listening socket and every node.
+ *  - Dedup state is three fixed-size structures on prefaulted huge pages
+ *    (`huge_alloc.h`), nothing allocated per record:
+ *      - a linear-probing table from key hash to the event's state;
+ *      - the pending ring, events waiting out their window, in arrival order;
+ *      - the seen ring, written events waiting out their horizon.
+ *    When a ring is full its oldest entry is written / forgotten early.
+ *  - Keys are 64-bit FNV-1a hashes of the identifying fields; two distinct
+ *    events colliding inside one horizon is not a practical concern.
+ *
+ * Dependencies:
+ *  - merge_node.h, node_link.h, tick_ring.h.
+ *
+ * Usage:
+ *  - See `merge_node.h`. `make node_bench` measures it on loopback.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#define _GNU_SOURCE
+#include "merge_node.h"
+#include "node_link.h"
+#include "tick_ring.h"
+#include "huge_alloc.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <poll.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+
+#define TABLE_SLOTS (1u << 21)              // > PENDING_SLOTS + SEEN_SLOTS, load stays under 2/3
+#define PENDING_SLOTS (1u << 18)            // one window at over 1M new events/sec
+#define SEEN_SLOTS (1u << 20)
+#define RECV_BUFFER (256 * 1024)
+#define FILE_BUFFER (1024 * 1024)
+
+typedef struct {
+    uint64_t hash;                  // 0 = empty slot
+    uint64_t pending_seq;           // pending ring sequence + 1, 0 once written
+    uint64_t seen_seq;              // seen ring sequence + 1, 0 = forget when written
+} DedupEntry;
+
+typedef struct {
+    MarketRecord record;            // earliest copy so far
+    uint64_t hash;
+    long long deadline_ms;
+    int node;                       // node that delivered `record`
+} PendingEvent;
+
+typedef struct {
+    uint64_t hash;
+    long long expire_ms;
+} SeenEvent;
+
+typedef struct {
+    char name[NODE_NAME_LEN];
+    int connected;
+    unsigned long long records;     // since the last statistics report
+    unsigned long long won;         // copies written
+    unsigned long long beaten;      // copies dropped for an earlier one inside the window
+    unsigned long long late;        // copies dropped after their event was written
+} NodeStats;
+
+typedef struct {
+    int fd;                         // -1 = free
+    int node;                       // NodeStats index, -1 until the hello arrives
+    char peer[64];
+    size_t filled;
+    char *buffer;
+} NodeConnection;
+
+static volatile sig_atomic_t stopping = 0;
+
+static MergeNodeConfig cfg;
+static DedupEntry *table = NULL;
+static PendingEvent *pending = NULL;
+static SeenEvent *seen = NULL;
+static uint64_t pending_head, pending_tail;
+static uint64_t seen_head, seen_tail;
+
+static NodeStats nodes[MERGE_MAX_NODES];
+static int node_count = 0;
+static NodeConnection connections[MERGE_MAX_NODES];
+static char *recv_buffers = NULL;
+
+static FILE *store = NULL;
+static long store_day = -1;
+static TickRingWriter ring = {0};
+
+static long last_page_faults = 0;
+static unsigned long long written = 0;
+static unsigned long long forced_writes = 0;     // pending ring full: written before the window ended
+static unsigned long long forced_forgets = 0;    // seen ring full: key dropped before the horizon
+static unsigned long long unkeyed = 0;           // trades without a trade ID, written from every node
+
+static long long monotonic_ms() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static void on_signal(int sig) {
+    (void)sig;
+    stopping = 1;
+}
+
+void merge_node_stop() {
+    stopping = 1;
+}
+
+void merge_node_default_config(MergeNodeConfig *config) {
+    memset(config, 0, sizeof(*config));
+    config->bind_address = "0.0.0.0";
+    config->port = 9100;
+    config->output_dir = "merged_output";
+    config->tick_ring_name = TICK_RING_NAME;
+    config->window_ms = MERGE_WINDOW_MS;
+    config->horizon_ms = MERGE_HORIZON_MS;
+    config->stats_ms = MERGE_STATS_MS;
+}
+
+/* ------------------------------------ Keys ------------------------------------ */
+
+static uint64_t fnv1a(uint64_t h, const void *data, size_t len) {
+    const unsigned char *p = data;
+    for (size_t i = 0; i < len; i++) {
+        h ^= p[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+/* Identity of the event a record describes; trades without a trade ID have none (see merge_record) */
+static uint64_t event_key(const MarketRecord *r) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    h = fnv1a(h, r->exchange, strnlen(r->exchange, sizeof(r->exchange)));
+    h = fnv1a(h, "/", 1);
+    h = fnv1a(h, r->symbol, strnlen(r->symbol, sizeof(r->symbol)));
+    h = fnv1a(h, &r->kind, sizeof(r->kind));
+
+    if (r->trade_id) {
+        h = fnv1a(h, &r->trade_id, sizeof(r->trade_id));
+    } else {
+        h = fnv1a(h, &r->event_ms, sizeof(r->event_ms));
+        h = fnv1a(h, &r->price, 6 * sizeof(double));    // price, size, bid, ask, bid_qty, ask_qty
+    }
+    return h ? h : 1;
+}
+
+/* ------------------------------------ Dedup table ------------------------------------ */
+
+static DedupEntry *table_find(uint64_t hash) {
+    for (uint32_t i = hash & (TABLE_SLOTS - 1);; i = (i + 1) & (TABLE_SLOTS - 1)) {
+        if (table[i].hash == hash) return &table[i];
+        if (table[i].hash == 0) return NULL;
+    }
+}
+
+static DedupEntry *table_insert(uint64_t hash) {
+    uint32_t i = hash & (TABLE_SLOTS - 1);
+    while (table[i].hash) i = (i + 1) & (TABLE_SLOTS - 1);
+    table[i].hash = hash;
+    return &table[i];
+}
+
+/* Backward-shift deletion keeps probe chains intact without tombstones */
+static void table_remove(DedupEntry *entry) {
+    uint32_t i = entry - table;
+    uint32_t j = i;
+    for (;;) {
+        j = (j + 1) & (TABLE_SLOTS - 1);
+        if (table[j].hash == 0) break;
+        uint32_t home = table[j].hash & (TABLE_SLOTS - 1);
+        /* Move j into the hole unless its home lies cyclically in (i, j] */
+        int stays = (i <= j) ? (home > i && home <= j) : (home > i || home <= j);
+        if (!stays) {
+            table[i] = table[j];
+            i = j;
+        }
+    }
+    table[i].hash = 0;
+}
+
+/* ------------------------------------ Output ------------------------------------ */
+
+static void open_store(long day) {
+    if (store) fclose(store);
+    store = NULL;
+    store_day = day;
+
+    time_t t = (time_t)day * 86400;
+    struct tm tm;
+    gmtime_r(&t, &tm);
+    char filename[512];
+    snprintf(filename, sizeof(filename), "%s/records_%04d%02d%02d.bin", cfg.output_dir,
+             tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday);
+
+    store = fopen(filename, "ab");
+    if (!store) {
+        printf("[ERROR] Failed to open merged store %s: %s\n", filename, strerror(errno));
+        return;
+    }
+    setvbuf(store, NULL, _IOFBF, FILE_BUFFER);
+    printf("[INFO] Writing merged records to %s\n", filename);
+}
+
+static void write_event(const MarketRecord *record) {
+    if (cfg.output_dir) {
+        long day = (long)(time(NULL) / 86400);
+        if (day != store_day) open_store(day);
+        if (store && fwrite(record, sizeof(*record), 1, store) != 1)
+            printf("[ERROR] Failed to write merged record: %s\n", strerror(errno));
+    }
+    if (ring.header) tick_ring_write(&ring, record);
+    written++;
+}
+
+/* ------------------------------------ Merge ------------------------------------ */
+
+/* Write the oldest pending event */
+static void emit_oldest() {
+    PendingEvent *p = &pending[pending_head & (PENDING_SLOTS - 1)];
+    write_event(&p->record);
+    nodes[p->node].won++;
+
+    DedupEntry *entry = p->hash ? table_find(p->hash) : NULL;
+    if (entry) {
+        if (entry->seen_seq) entry->pending_seq = 0;
+        else table_remove(entry);
+    }
+    pending_head++;
+}
+
+/* Forget the oldest written key */
+static void expire_oldest() {
+    uint64_t seq = seen_head++;
+    DedupEntry *entry = table_find(seen[seq & (SEEN_SLOTS - 1)].hash);
+    if (!entry || entry->seen_seq != seq + 1) return;
+    if (entry->pending_seq) entry->seen_seq = 0;        // forced early: drop it once written
+    else table_remove(entry);
+}
+
+/* Queue a record for the end of its window; hash 0 = not in the dedup table */
+static uint64_t queue_pending(const MarketRecord *record, uint64_t hash, int node, long long now) {
+    if (pending_tail - pending_head == PENDING_SLOTS) {
+        emit_oldest();
+        forced_writes++;
+    }
+    uint64_t pending_seq = pending_tail++;
+    PendingEvent *p = &pending[pending_seq & (PENDING_SLOTS - 1)];
+    p->record = *record;
+    p->hash = hash;
+    p->deadline_ms = now + cfg.window_ms;
+    p->node = node;
+    return pending_seq;
+}
+
+static void merge_record(const MarketRecord *record, int node, long long now) {
+    /* Two genuine fills can share time, price and size, so a trade without a trade ID is
+     * written from every node rather than risk dropping one as a duplicate */
+    if (record->kind == MARKET_RECORD_TRADE && !record->trade_id) {
+        queue_pending(record, 0, node, now);
+        unkeyed++;
+        return;
+    }
+
+    uint64_t hash = event_key(record);
+    DedupEntry *entry = table_find(hash);
+
+    if (entry) {
+        if (entry->pending_seq) {
+            PendingEvent *p = &pending[(entry->pending_seq - 1) & (PENDING_SLOTS - 1)];
+            if (record->recv_ns < p->record.recv_ns) {
+                nodes[p->node].beaten++;
+                p->record = *record;
+                p->node = node;
+            } else {
+                nodes[node].beaten++;
+            }
+        } else {
+            nodes[node].late++;
+        }
+        return;
+    }
+
+    /* Keyless updates only merge inside the window */
+    uint64_t seen_seq = 0;
+    if (record->trade_id || record->event_ms) {
+        if (seen_tail - seen_head == SEEN_SLOTS) {
+            expire_oldest();
+            forced_forgets++;
+        }
+        seen_seq = seen_tail++;
+        seen[seen_seq & (SEEN_SLOTS - 1)] = (SeenEvent){ hash, now + cfg.horizon_ms };
+        seen_seq++;
+    }
+
+    uint64_t pending_seq = queue_pending(record, hash, node, now);
+    entry = table_insert(hash);
+    entry->pending_seq = pending_seq + 1;
+    entry->seen_seq = seen_seq;
+}
+
+static void advance(long long now) {
+    while (pending_head < pending_tail && pending[pending_head & (PENDING_SLOTS - 1)].deadline_ms <= now)
+        emit_oldest();
+    while (seen_head < seen_tail && seen[seen_head & (SEEN_SLOTS - 1)].expire_ms <= now)
+        expire_oldest();
+}
+
+/* ------------------------------------ Network ------------------------------------ */
+
+static int open_listener() {
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(cfg.port);
+    if (inet_pton(AF_INET, cfg.bind_address, &addr.sin_addr) != 1) {
+        printf("[ERROR] Invalid merge node bind address %s\n", cfg.bind_address);
+        return -1;
+    }
+
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        printf("[ERROR] socket() failed: %s\n", strerror(errno));
+        return -1;
+    }
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, MERGE_MAX_NODES) != 0) {
+        printf("[ERROR] Cannot listen on %s:%d: %s\n", cfg.bind_address, cfg.port, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void accept_nodes(int listener) {
+    for (;;) {
+        struct sockaddr_in peer;
+        socklen_t len = sizeof(peer);
+        int fd = accept4(listener, (struct sockaddr *)&peer, &len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;
+
+        NodeConnection *c = NULL;
+        for (int i = 0; i < MERGE_MAX_NODES && !c; i++)
+            if (connections[i].fd < 0) c = &connections[i];
+        if (!c) {
+            printf("[WARNING] Rejecting node connection: %d nodes already connected\n", MERGE_MAX_NODES);
+            close(fd);
+            continue;
+        }
+
+        c->fd = fd;
+        c->node = -1;
+        c->filled = 0;
+        char ip[INET_ADDRSTRLEN];
+        inet_ntop(AF_INET, &peer.sin_addr, ip, sizeof(ip));
+        snprintf(c->peer, sizeof(c->peer), "%s:%d", ip, ntohs(peer.sin_port));
+    }
+}
+
+static void close_connection(NodeConnection *c, const char *reason) {
+    if (c->node >= 0) {
+        nodes[c->node].connected = 0;
+        printf("[WARNING] Node \"%s\" (%s) disconnected: %s\n", nodes[c->node].name, c->peer, reason);
+    } else {
+        printf("[WARNING] Connection from %s closed: %s\n", c->peer, reason);
+    }
+    close(c->fd);
+    c->fd = -1;
+}
+
+/* Stats survive reconnects: a node is identified by the name in its hello */
+static int node_index(const char *name) {
+    for (int i = 0; i < node_count; i++)
+        if (strcmp(nodes[i].name, name) == 0) return i;
+    if (node_count == MERGE_MAX_NODES) return -1;
+    memset(&nodes[node_count], 0, sizeof(NodeStats));
+    snprintf(nodes[node_count].name, sizeof(nodes[node_count].name), "%s", name);
+    return node_count++;
+}
+
+/* Read and merge what one node has sent; returns 1 if anything arrived */
+static int read_node(NodeConnection *c, long long now) {
+    ssize_t n = recv(c->fd, c->buffer + c->filled, RECV_BUFFER - c->filled, 0);
+    if (n == 0) {
+        close_connection(c, "closed by peer");
+        return 0;
+    }
+    if (n < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) close_connection(c, strerror(errno));
+        return 0;
+    }
+    c->filled += n;
+    size_t offset = 0;
+
+    if (c->node < 0) {
+        if (c->filled < sizeof(NodeHello)) return 1;
+        NodeHello hello;
+        memcpy(&hello, c->buffer, sizeof(hello));
+        hello.node[NODE_NAME_LEN - 1] = '\0';
+        if (hello.magic != NODE_LINK_MAGIC || hello.version != NODE_LINK_VERSION ||
+            hello.record_size != sizeof(MarketRecord)) {
+            close_connection(c, "not a compatible collector node");
+            return 0;
+        }
+        c->node = node_index(hello.node);
+        if (c->node < 0) {
+            close_connection(c, "too many distinct nodes");
+            return 0;
+        }
+        nodes[c->node].connected = 1;
+        printf("[INFO] Node \"%s\" connected from %s\n", hello.node, c->peer);
+        offset = sizeof(NodeHello);
+    }
+
+    MarketRecord record;
+    while (c->filled - offset >= sizeof(MarketRecord)) {
+        memcpy(&record, c->buffer + offset, sizeof(record));
+        merge_record(&record, c->node, now);
+        nodes[c->node].records++;
+        offset += sizeof(MarketRecord);
+    }
+    memmove(c->buffer, c->buffer + offset, c->filled - offset);
+    c->filled -= offset;
+    return 1;
+}
+
+static void report(long long elapsed_ms) {
+    for (int i = 0; i < node_count; i++) {
+        NodeStats *s = &nodes[i];
+        printf("[STATS] Node \"%s\": %s, %.0f records/s, %llu won, %llu beaten, %llu late\n", s->name,
+               s->connected ? "connected" : "disconnected", elapsed_ms > 0 ? s->records * 1000.0 / elapsed_ms : 0.0,
+               s->won, s->beaten, s->late);
+        s->records = 0;
+    }
+    struct rusage usage;
+    long faults = getrusage(RUSAGE_SELF, &usage) == 0 ? usage.ru_minflt + usage.ru_majflt : 0;
+    printf("[STATS] Merge: %llu records written, %llu pending, %llu keys remembered, %llu written early, %llu forgotten early, %llu trades without ID, %ld page faults\n",
+           written, (unsigned long long)(pending_tail - pending_head),
+           (unsigned long long)(seen_tail - seen_head), forced_writes, forced_forgets, unkeyed, faults - last_page_faults);
+    last_page_faults = faults;
+    if (store) fflush(store);
+}
+
+/* ------------------------------------ Run ------------------------------------ */
+
+static void release() {
+    for (int i = 0; i < MERGE_MAX_NODES; i++) {
+        if (connections[i].fd >= 0) close(connections[i].fd);
+        connections[i].fd = -1;
+        connections[i].buffer = NULL;
+    }
+    huge_free(recv_buffers, (size_t)MERGE_MAX_NODES * RECV_BUFFER);
+    huge_free(table, TABLE_SLOTS * sizeof(DedupEntry));
+    huge_free(pending, PENDING_SLOTS * sizeof(PendingEvent));
+    huge_free(seen, SEEN_SLOTS * sizeof(SeenEvent));
+    recv_buffers = NULL;
+    table = NULL;
+    pending = NULL;
+    seen = NULL;
+    if (store) fclose(store);
+    store = NULL;
+    store_day = -1;
+    tick_ring_close(&ring, cfg.tick_ring_name);
+}
+
+int merge_node_run(const MergeNodeConfig *config) {
+    cfg = *config;
+    if (cfg.horizon_ms < cfg.window_ms) cfg.horizon_ms = cfg.window_ms;
+    stopping = 0;
+    written = forced_writes = forced_forgets = 0;
+    pending_head = pending_tail = seen_head = seen_tail = 0;
+    node_count = 0;
+
+    /* Zeroed and prefaulted on huge pages: the dedup state is probed at random on every record */
+    table = huge_alloc(TABLE_SLOTS * sizeof(DedupEntry), "merge dedup table");
+    pending = huge_alloc(PENDING_SLOTS * sizeof(PendingEvent), "merge pending ring");
+    seen = huge_alloc(SEEN_SLOTS * sizeof(SeenEvent), "merge seen ring");
+    recv_buffers = huge_alloc((size_t)MERGE_MAX_NODES * RECV_BUFFER, "merge receive buffers");
+    for (int i = 0; i < MERGE_MAX_NODES; i++) {
+        connections[i].fd = -1;
+        connections[i].buffer = recv_buffers ? recv_buffers + (size_t)i * RECV_BUFFER : NULL;
+    }
+    if (!table || !pending || !seen || !recv_buffers) {
+        printf("[ERROR] Memory allocation failed for merge state\n");
+        release();
+        return -1;
+    }
+
+    if (cfg.output_dir && mkdir(cfg.output_dir, 0755) != 0 && errno != EEXIST) {
+        printf("[ERROR] Cannot create %s: %s\n", cfg.output_dir, strerror(errno));
+        release();
+        return -1;
+    }
+    if (cfg.tick_ring_name && tick_ring_create(&ring, cfg.tick_ring_name, TICK_RING_CAPACITY) != 0)
+        printf("[WARNING] Merged tick ring disabled: %s\n", strerror(errno));
+
+    int listener = open_listener();
+    if (listener < 0) {
+        release();
+        return -1;
+    }
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    printf("[INFO] Merge node listening on %s:%d (window %d ms, horizon %d ms)\n",
+           cfg.bind_address, cfg.port, cfg.window_ms, cfg.horizon_ms);
+
+    struct pollfd fds[MERGE_MAX_NODES + 1];
+    NodeConnection *polled[MERGE_MAX_NODES + 1];
+    long long last_stats_ms = monotonic_ms();
+    struct rusage usage;
+    last_page_faults = getrusage(RUSAGE_SELF, &usage) == 0 ? usage.ru_minflt + usage.ru_majflt : 0;
+
+    while (!stopping) {
+        int count = 0;
+        fds[count].fd = listener;
+        fds[count].events = POLLIN;
+        polled[count++] = NULL;
+        for (int i = 0; i < MERGE_MAX_NODES; i++) {
+            if (connections[i].fd < 0) continue;
+            fds[count].fd = connections[i].fd;
+            fds[count].events = POLLIN;
+            polled[count++] = &connections[i];
+        }
+
+        /* Wake for the next window deadline */
+        long long now = monotonic_ms();
+        int timeout = 100;
+        if (pending_head < pending_tail) {
+            long long wait = pending[pending_head & (PENDING_SLOTS - 1)].deadline_ms - now;
+            timeout = wait < 0 ? 0 : (wait < timeout ? (int)wait : timeout);
+        }
+
+        if (poll(fds, count, timeout) < 0 && errno != EINTR) {
+            printf("[ERROR] poll() failed: %s\n", strerror(errno));
+            break;
+        }
+
+        now = monotonic_ms();
+        for (int i = 0; i < count; i++) {
+            if (!fds[i].revents) continue;
+            if (!polled[i]) accept_nodes(listener);
+            else if (polled[i]->fd >= 0) read_node(polled[i], now);
+        }
+        advance(now);
+
+        if (now - last_stats_ms >= cfg.stats_ms) {
+            report(now - last_stats_ms);
+            last_stats_ms = now;
+        }
+    }
+
+    /* Drain what the nodes already sent, then write everything still pending */
+    long long now = monotonic_ms();
+    for (int i = 0; i < MERGE_MAX_NODES; i++)
+        while (connections[i].fd >= 0 && read_node(&connections[i], now)) {}
+    while (pending_head < pending_tail) emit_oldest();
+
+    report(monotonic_ms() - last_stats_ms);
+    printf("[INFO] Merge node stopped: %llu records written\n", written);
+    close(listener);
+    release();
+    return 0;
+}
@@ -0,0 +1,67 @@
+/*
+ * Merge Node Header
+ *
+ * Declares the merge node: it accepts record streams from several collector
+ * nodes (`node_link.h`), keeps one copy of every event and writes the
+ * canonical store.
+ *
+ * Features:
+ *  - Events are identified by (exchange, symbol, kind, trade ID). Tickers
+ *    and quotes are identified by their exchange event time and contents
+ *    instead. Trades without a trade ID (Kraken) have no reliable identity,
+ *    since two fills can share time, price and size: every node's copy is
+ *    written rather than risk dropping a real trade.
+ *  - A new event is held for `window_ms`; of the copies that arrive in that
+ *    time the one with the earliest `recv_ns` is written. Copies arriving
+ *    later, up to `horizon_ms` after the first, are counted and dropped.
+ *  - Records with neither a trade ID nor an event time are only merged
+ *    within the window, so a repeated but genuine update is not lost.
+ *  - Output: `<output_dir>/records_YYYYMMDD.bin`, raw `MarketRecord`s in
+ *    write order, and optionally a local tick ring (`tick_ring.h`).
+ *  - Per-node statistics every `stats_ms`: records, copies that won, lost
+ *    the race, or arrived after their event was written.
+ *  - Memory is fixed (about 100 MB): 1M remembered keys cover the horizon up
+ *    to ~100k new events/sec; above that keys are forgotten early and the
+ *    statistics say how many.
+ *
+ * Dependencies:
+ *  - node_link.h, tick_ring.h, market_record.h; POSIX sockets and poll.
+ *
+ * Usage:
+ *  - `crypto_ws --merge <port> [output_dir]` (see `main.c`), or:
+ *        MergeNodeConfig config;
+ *        merge_node_default_config(&config);
+ *        config.port = 9100;
+ *        merge_node_run(&config);        // until SIGINT / SIGTERM
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#ifndef MERGE_NODE_H
+#define MERGE_NODE_H
+
+#define MERGE_MAX_NODES 16
+#define MERGE_WINDOW_MS 200                 // how long the first copy waits for an earlier one
+#define MERGE_HORIZON_MS 10000              // how long a written event's key is remembered
+#define MERGE_STATS_MS 60000
+
+typedef struct {
+    const char *bind_address;       // "0.0.0.0" by default
+    int port;
+    const char *output_dir;         // "merged_output"; NULL = no file
+    const char *tick_ring_name;     // TICK_RING_NAME; NULL = no ring
+    int window_ms;
+    int horizon_ms;
+    int stats_ms;
+} MergeNodeConfig;
+
+void merge_node_default_config(MergeNodeConfig *config);
+
+/* Listen and merge until SIGINT / SIGTERM or `merge_node_stop()`; returns 0 on a clean stop, -1 on error */
+int merge_node_run(const MergeNodeConfig *config);
+
+/* Async-signal-safe */
+void merge_node_stop();
+
+#endif // MERGE_NODE_H
@@ -0,0 +1,192 @@
+/*
+ * Message Classifier
+ *
+ * Sorts incoming exchange messages into control and market data before any
+ * field is extracted. Each exchange puts its discriminating token (event
+ * type, channel name) at a fixed place near the start of the message, so a
+ * prefix compare plus one or two byte switches is enough; nothing beyond
+ * `CLASSIFY_WINDOW` bytes is ever read.
+ *
+ * Features:
+ *  - Binance:  `{"e":"trade"` / `{"e":"24hrTicker"`, `{"result":...}` acks, `{"error"` / `{"code"`.
+ *  - Coinbase: first-byte switch on the `"type"` value.
+ *  - Kraken:   objects are events (heartbeat first), arrays carry the channel
+ *              name just before the pair at the end of the message.
+ *  - OKX:      `pong`, `{"event":...}` and `{"arg":{"channel":...}}` pushes.
+ *  - Huobi:    `{"ping"`, `{"ch":"market.<symbol>.<channel>"`, status replies.
+ *  - Bitfinex: `{"event":...}` objects, `[chanId,"hb"]`, `[chanId,"te",[...]]`
+ *              trades and `[chanId,[...]]` ticker updates.
+ *
+ * Dependencies:
+ *  - Standard C libraries (string.h).
+ *
+ * Usage:
+ *  - Called from `callback_combined()` in `exchange_websocket.c` for every
+ *    received message.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#define _GNU_SOURCE
+#include "message_classifier.h"
+#include <string.h>
+
+/* Compare against a string literal at a fixed offset, bounded by len */
+#define MATCH_AT(msg, len, off, lit) \
+    ((len) >= (off) + sizeof(lit) - 1 && memcmp((msg) + (off), (lit), sizeof(lit) - 1) == 0)
+
+#define HAS_PREFIX(msg, len, lit) MATCH_AT(msg, len, 0, lit)
+
+static size_t window(size_t len) {
+    return len < CLASSIFY_WINDOW ? len : CLASSIFY_WINDOW;
+}
+
+/* Locate the value following `key` within the classify window; NULL if absent */
+static const char *value_after(const char *msg, size_t len, const char *key, size_t *remaining) {
+    size_t key_len = strlen(key);
+    const char *pos = memmem(msg, window(len), key, key_len);
+    if (!pos) return NULL;
+    pos += key_len;
+    if (pos >= msg + len) return NULL;
+    *remaining = (msg + len) - pos;
+    return pos;
+}
+
+MessageKind classify_binance_message(const char *msg, size_t len) {
+    /* Combined stream envelope: the stream name "<symbol>@<channel>" carries the kind */
+    if (HAS_PREFIX(msg, len, "{\"stream\":\"")) {
+        const char *at = memchr(msg + 11, '@', window(len) - 11);
+        if (!at) return MSG_UNKNOWN;
+        size_t rest = (msg + len) - (at + 1);
+        if (MATCH_AT(at + 1, rest, 0, "trade\"")) return MSG_TRADE;
+        if (MATCH_AT(at + 1, rest, 0, "ticker\"") || MATCH_AT(at + 1, rest, 0, "miniTicker\"")) return MSG_TICKER;
+        if (MATCH_AT(at + 1, rest, 0, "bookTicker\"")) return MSG_QUOTE;
+        return MSG_UNKNOWN;
+    }
+    if (HAS_PREFIX(msg, len, "{\"e\":\"")) {
+        if (MATCH_AT(msg, len, 6, "trade\"")) return MSG_TRADE;
+        if (MATCH_AT(msg, len, 6, "24hrTicker\"") || MATCH_AT(msg, len, 6, "24hrMiniTicker\"")) return MSG_TICKER;
+        return MSG_UNKNOWN;
+    }
+    if (HAS_PREFIX(msg, len, "{\"u\":")) return MSG_QUOTE;             // bookTicker carries no event type
+    if (HAS_PREFIX(msg, len, "{\"result\"")) return MSG_ACK;
+    if (HAS_PREFIX(msg, len, "{\"error\"") || HAS_PREFIX(msg, len, "{\"code\"")) return MSG_ERROR;
+    return MSG_UNKNOWN;
+}
+
+MessageKind classify_coinbase_message(const char *msg, size_t len) {
+    size_t rest = 0;
+    const char *type = value_after(msg, len, "\"type\":\"", &rest);
+    if (!type) return MSG_UNKNOWN;
+
+    switch (type[0]) {
+        case 't': return MATCH_AT(type, rest, 0, "ticker\"") ? MSG_TICKER : MSG_UNKNOWN;
+        case 'm': return MATCH_AT(type, rest, 0, "match\"") ? MSG_TRADE : MSG_UNKNOWN;
+        case 'l': return MSG_ACK;           // last_match: one snapshot trade sent after subscribing
+        case 's': return MSG_ACK;           // subscriptions
+        case 'h': return MSG_HEARTBEAT;
+        case 'e': return MSG_ERROR;
+        default:  return MSG_UNKNOWN;
+    }
+}
+
+MessageKind classify_kraken_message(const char *msg, size_t len) {
+    if (len == 0) return MSG_UNKNOWN;
+
+    if (msg[0] == '{') {
+        if (HAS_PREFIX(msg, len, "{\"event\":\"heartbeat\"")) return MSG_HEARTBEAT;
+        if (memmem(msg, window(len), "\"status\":\"error\"", 16) ||
+            memmem(msg, window(len), "\"errorMessage\"", 14))
+            return MSG_ERROR;
+        return MSG_ACK;                     // systemStatus, subscriptionStatus, pong
+    }
+    if (msg[0] != '[') return MSG_UNKNOWN;
+
+    /* [channelID, <data>, "channelName", "pair"] - the last four quotes delimit the pair and the channel name */
+    size_t quotes[4];
+    int found = 0;
+    size_t stop = (len > CLASSIFY_WINDOW) ? len - CLASSIFY_WINDOW : 0;
+    for (size_t i = len; i > stop && found < 4; i--) {
+        if (msg[i - 1] == '"') quotes[found++] = i - 1;
+    }
+    if (found < 4) return MSG_UNKNOWN;
+
+    const char *name = msg + quotes[3] + 1;
+    size_t name_len = quotes[2] - quotes[3] - 1;
+    if (name_len == 6 && memcmp(name, "ticker", 6) == 0) return MSG_TICKER;
+    if (name_len == 5 && memcmp(name, "trade", 5) == 0) return MSG_TRADE;
+    if (name_len == 6 && memcmp(name, "spread", 6) == 0) return MSG_QUOTE;
+    return MSG_UNKNOWN;
+}
+
+MessageKind classify_okx_message(const char *msg, size_t len) {
+    if (len == 4 && memcmp(msg, "pong", 4) == 0) return MSG_HEARTBEAT;
+
+    if (HAS_PREFIX(msg, len, "{\"event\":\"")) {
+        if (MATCH_AT(msg, len, 10, "error\"")) return MSG_ERROR;
+        return MSG_ACK;                     // subscribe, unsubscribe, notice
+    }
+    if (HAS_PREFIX(msg, len, "{\"arg\":{\"channel\":\"")) {
+        if (MATCH_AT(msg, len, 19, "tickers\"")) return MSG_TICKER;
+        if (MATCH_AT(msg, len, 19, "trades\"")) return MSG_TRADE;
+        if (MATCH_AT(msg, len, 19, "bbo-tbt\"")) return MSG_QUOTE;
+    }
+    return MSG_UNKNOWN;
+}
+
+MessageKind classify_bitfinex_message(const char *msg, size_t len) {
+    if (len == 0) return MSG_UNKNOWN;
+
+    if (msg[0] == '{') {
+        if (HAS_PREFIX(msg, len, "{\"event\":\"error\"") ||
+            memmem(msg, window(len), "\"event\":\"error\"", 16))
+            return MSG_ERROR;
+        return MSG_ACK;                     // info, subscribed, conf
+    }
+    if (msg[0] != '[') return MSG_UNKNOWN;
+
+    /* Skip the channel ID */
+    size_t i = 1;
+    while (i < window(len) && msg[i] >= '0' && msg[i] <= '9') i++;
+    if (i >= len || msg[i] != ',') return MSG_UNKNOWN;
+    i++;
+
+    if (MATCH_AT(msg, len, i, "\"hb\"")) return MSG_HEARTBEAT;
+    if (MATCH_AT(msg, len, i, "\"te\"")) return MSG_TRADE;
+    if (MATCH_AT(msg, len, i, "[[") || MATCH_AT(msg, len, i, "[]")) return MSG_UNKNOWN;  // trade snapshot
+    if (MATCH_AT(msg, len, i, "[")) return MSG_TICKER;
+    return MSG_UNKNOWN;                     // "tu" repeats a "te" trade with its final ID
+}
+
+MessageKind classify_huobi_message(const char *msg, size_t len) {
+    if (HAS_PREFIX(msg, len, "{\"ping\":")) return MSG_PING;
+
+    if (HAS_PREFIX(msg, len, "{\"ch\":\"market.")) {
+        /* Skip the symbol to reach the channel name */
+        const char *sym = msg + 14;
+        const char *dot = memchr(sym, '.', window(len) - 14);
+        if (!dot) return MSG_UNKNOWN;
+        size_t off = (dot + 1) - msg;
+        if (MATCH_AT(msg, len, off, "ticker\"")) return MSG_TICKER;
+        if (MATCH_AT(msg, len, off, "trade.detail\"")) return MSG_TRADE;
+        if (MATCH_AT(msg, len, off, "bbo\"")) return MSG_QUOTE;
+        return MSG_UNKNOWN;
+    }
+    if (memmem(msg, window(len), "\"status\":\"error\"", 16)) return MSG_ERROR;
+    if (memmem(msg, window(len), "\"status\":\"ok\"", 13)) return MSG_ACK;
+    return MSG_UNKNOWN;
+}
+
+const char *message_kind_name(MessageKind kind) {
+    switch (kind) {
+        case MSG_HEARTBEAT: return "heartbeat";
+        case MSG_PING:      return "ping";
+        case MSG_ACK:       return "ack";
+        case MSG_ERROR:     return "error";
+        case MSG_TICKER:    return "ticker";
+        case MSG_QUOTE:     return "quote";
+        case MSG_TRADE:     return "trade";
+        default:            return "unknown";
+    }
+}
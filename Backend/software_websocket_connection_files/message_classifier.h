@@ -0,0 +1,55 @@
+/*
+ * Message Classifier Header
+ *
+ * Declares per-exchange classifiers that decide what kind of message was
+ * received by looking only at a short, bounded window of its first bytes
+ * (or last bytes for Kraken's array messages).
+ *
+ * Features:
+ *  - `MessageKind`: heartbeat, ping, ack, error, ticker, quote (top of book),
+ *    trade or unknown.
+ *  - One classifier per exchange, each constant-time in the message length.
+ *  - Control frames are recognised without touching the JSON extractors or jansson.
+ *
+ * Dependencies:
+ *  - Standard C library (stddef.h).
+ *
+ * Usage:
+ *  - Implemented in `message_classifier.c`.
+ *  - Used by `exchange_websocket.c` to route each message to its handler.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#ifndef MESSAGE_CLASSIFIER_H
+#define MESSAGE_CLASSIFIER_H
+
+#include <stddef.h>
+
+#define CLASSIFY_WINDOW 128             // bytes a classifier may inspect
+
+typedef enum {
+    MSG_UNKNOWN = 0,
+    MSG_HEARTBEAT,                      // keep-alive, nothing to do
+    MSG_PING,                           // server expects a reply (Huobi)
+    MSG_ACK,                            // subscription / status confirmation
+    MSG_ERROR,                          // request rejected by the exchange
+    MSG_TICKER,
+    MSG_QUOTE,                          // best bid/ask only (bookTicker, spread, bbo)
+    MSG_TRADE
+} MessageKind;
+
+MessageKind classify_binance_message(const char *msg, size_t len);
+MessageKind classify_coinbase_message(const char *msg, size_t len);
+MessageKind classify_kraken_message(const char *msg, size_t len);
+MessageKind classify_okx_message(const char *msg, size_t len);
+MessageKind classify_bitfinex_message(const char *msg, size_t len);
+
+/* Expects the already-decompressed payload */
+MessageKind classify_huobi_message(const char *msg, size_t len);
+
+/* Human-readable name for a message kind */
+const char *message_kind_name(MessageKind kind);
+
+#endif // MESSAGE_CLASSIFIER_H
@@ -0,0 +1,229 @@
+/*
+ * Node Merge Benchmark
+ *
+ * Runs a merge node and several collector nodes as local processes on
+ * loopback and measures merge throughput with every record sent by every
+ * node, as with fully redundant collectors.
+ *
+ * Features:
+ *  - Forks a merge node writing to a temporary directory, then N sender
+ *    processes that each stream the same M records (their own receive
+ *    times) through `node_sender_write`: trades with a trade ID, and one in
+ *    eight each of OKX-style trades (string "tradeId" parsed like the
+ *    collector does), quotes, and trades without an ID (as Kraken sends).
+ *  - Reports records/sec received by the merge node and checks the merged
+ *    store holds every trade ID and quote exactly once, and every trade
+ *    without an ID once per node.
+ *
+ * Usage:
+ *  - Build: `make node_bench` (not part of `make all`).
+ *  - Run:   `./node_bench [nodes] [records]` (defaults: 2 nodes, 1000000 records).
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#include "node_link.h"
+#include "merge_node.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#define BENCH_PORT 19100
+#define BENCH_SYMBOLS 16
+#define BENCH_EVENT_MS 1700000000000LL
+
+#define BENCH_OKX_TRADE_ID 130639474ULL
+
+/* Record i: an OKX trade, a quote, a trade without a trade ID, or (otherwise) a trade with trade ID i + 1 */
+#define BENCH_OKX(i) ((i) % 8 == 1)
+#define BENCH_QUOTE(i) ((i) % 8 == 3)
+#define BENCH_UNKEYED(i) ((i) % 8 == 7)
+
+static double now_sec() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int64_t realtime_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static int run_merge(const char *dir) {
+    MergeNodeConfig config;
+    merge_node_default_config(&config);
+    config.bind_address = "127.0.0.1";
+    config.port = BENCH_PORT;
+    config.output_dir = dir;
+    config.tick_ring_name = NULL;
+    config.stats_ms = 3600000;
+    return merge_node_run(&config) == 0 ? 0 : 1;
+}
+
+static int run_sender(int id, long records) {
+    char name[NODE_NAME_LEN];
+    snprintf(name, sizeof(name), "bench-%d", id);
+    if (node_sender_start("127.0.0.1", BENCH_PORT, name) != 0) return 1;
+
+    NodeSenderStats stats;
+    double deadline = now_sec() + 5;
+    do {
+        node_sender_poll();
+        node_sender_get_stats(&stats);
+        if (!stats.connects) usleep(1000);
+    } while (!stats.connects && now_sec() < deadline);
+    if (!stats.connects) {
+        printf("[ERROR] Sender %d could not reach the merge node\n", id);
+        return 1;
+    }
+
+    MarketRecord record;
+    memset(&record, 0, sizeof(record));
+
+    double start = now_sec();
+    for (long i = 0; i < records; i++) {
+        strcpy(record.exchange, BENCH_OKX(i) ? "OKX" : "Bench");
+        snprintf(record.symbol, sizeof(record.symbol), "SYM%d-USD", (int)(i % BENCH_SYMBOLS));
+        double price = 100.0 + (i % 1000) * 0.01;
+        if (BENCH_OKX(i)) {
+            /* OKX sends "tradeId":"130639474"; the collector parses it as in market_record_from_trade() */
+            char trade_id[32];
+            snprintf(trade_id, sizeof(trade_id), "%llu", BENCH_OKX_TRADE_ID + i);
+            record.kind = MARKET_RECORD_TRADE;
+            record.trade_id = strtoull(trade_id, NULL, 10);
+            record.price = price;
+            record.size = 0.5;
+            record.bid = record.ask = 0.0;
+        } else if (BENCH_QUOTE(i)) {
+            record.kind = MARKET_RECORD_QUOTE;
+            record.trade_id = 0;
+            record.price = record.size = 0.0;
+            record.bid = price - 0.01;
+            record.ask = price + 0.01;
+        } else {
+            record.kind = MARKET_RECORD_TRADE;
+            record.trade_id = BENCH_UNKEYED(i) ? 0 : i + 1;
+            record.price = price;
+            record.size = 1.0;
+            record.bid = record.ask = 0.0;
+        }
+        record.event_ms = BENCH_EVENT_MS + i;
+        record.recv_ns = realtime_ns();
+
+        /* Stand in for TCP backpressure instead of letting the buffer drop records */
+        while (node_sender_backlog() > NODE_SEND_BUFFER - 65536) node_sender_poll();
+        node_sender_write(&record);
+        if ((i & 255) == 0) node_sender_poll();
+    }
+    node_sender_stop();
+    double elapsed = now_sec() - start;
+
+    node_sender_get_stats(&stats);
+    printf("[INFO] Sender %d: %llu records in %.2f s (%.0f records/s), %llu dropped\n", id,
+           (unsigned long long)stats.sent, elapsed, stats.sent / elapsed, (unsigned long long)stats.dropped);
+    return stats.dropped ? 1 : 0;
+}
+
+/* Count records in the merged store: each trade ID and quote once, each trade without an ID once per node */
+static int verify(const char *dir, long records, int nodes) {
+    unsigned char *seen = calloc(records, 1);
+    long total = 0, duplicates = 0, missing = 0;
+    DIR *d = opendir(dir);
+    struct dirent *entry;
+
+    while (seen && d && (entry = readdir(d))) {
+        if (entry->d_name[0] == '.') continue;
+        char path[512];
+        snprintf(path, sizeof(path), "%s/%s", dir, entry->d_name);
+        FILE *fp = fopen(path, "rb");
+        if (!fp) continue;
+        MarketRecord record;
+        while (fread(&record, sizeof(record), 1, fp) == 1) {
+            total++;
+            long i = strcmp(record.exchange, "OKX") == 0 ? (long)(record.trade_id - BENCH_OKX_TRADE_ID) :
+                     record.trade_id ? (long)record.trade_id - 1 : (long)(record.event_ms - BENCH_EVENT_MS);
+            if (i < 0 || i >= records) continue;
+            if (++seen[i] > (BENCH_UNKEYED(i) ? nodes : 1)) duplicates++;
+        }
+        fclose(fp);
+        unlink(path);
+    }
+    if (d) closedir(d);
+    rmdir(dir);
+
+    long expected = 0;
+    for (long i = 0; seen && i < records; i++) {
+        int copies = BENCH_UNKEYED(i) ? nodes : 1;
+        expected += copies;
+        if (seen[i] < copies) missing += copies - seen[i];
+    }
+    free(seen);
+
+    printf("[INFO] Merged store: %ld records (%ld expected), %ld duplicates, %ld missing\n",
+           total, expected, duplicates, missing);
+    return (total == expected && !duplicates && !missing) ? 0 : 1;
+}
+
+int main(int argc, char **argv) {
+    int nodes = argc > 1 ? atoi(argv[1]) : 2;
+    long records = argc > 2 ? atol(argv[2]) : 1000000;
+    if (nodes < 1 || nodes > MERGE_MAX_NODES || records < 1) {
+        printf("Usage: %s [nodes 1-%d] [records]\n", argv[0], MERGE_MAX_NODES);
+        return 1;
+    }
+
+    char dir[] = "/tmp/node_bench_XXXXXX";
+    if (!mkdtemp(dir)) {
+        perror("mkdtemp");
+        return 1;
+    }
+
+    fflush(stdout);
+    pid_t merge = fork();
+    if (merge == 0) {
+        int rc = run_merge(dir);
+        fflush(stdout);
+        _exit(rc);
+    }
+    usleep(200000);
+
+    double start = now_sec();
+    for (int i = 0; i < nodes; i++) {
+        fflush(stdout);
+        if (fork() == 0) {
+            int rc = run_sender(i, records);
+            fflush(stdout);
+            _exit(rc);
+        }
+    }
+
+    int failed = 0, status;
+    for (int i = 0; i < nodes; i++) {
+        if (wait(&status) == merge) {
+            printf("[ERROR] Merge node exited early\n");
+            return 1;
+        }
+        failed |= !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+    }
+    double elapsed = now_sec() - start;
+
+    /* Stop the merge node; it writes everything still in its window */
+    kill(merge, SIGTERM);
+    waitpid(merge, &status, 0);
+    failed |= !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+
+    printf("[RESULT] %d nodes x %ld records: %.2f s, %.0f records/s into the merge node, %.0f unique/s\n",
+           nodes, records, elapsed, nodes * records / elapsed, records / elapsed);
+    failed |= verify(dir, records, nodes);
+    printf(failed ? "[RESULT] FAILED\n" : "[RESULT] OK\n");
+    return failed;
+}
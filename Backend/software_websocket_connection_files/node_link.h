@@ -0,0 +1,82 @@
+/*
+ * Node Link Header
+ *
+ * Declares the TCP stream a collector node uses to ship its records to a
+ * merge node (`merge_node.h`), and the sender side of it.
+ *
+ * Features:
+ *  - Wire format: one `NodeHello` naming the node, then raw `MarketRecord`s
+ *    back to back. Both ends run on the same architecture, so records are
+ *    sent as they are laid out in memory.
+ *  - The sender never blocks the service thread: records go into a send
+ *    buffer that `node_sender_poll()` drains with non-blocking writes.
+ *  - While the merge node is unreachable, or the buffer is full, records are
+ *    dropped and counted; the other node's copy covers the gap. The sender
+ *    reconnects with backoff (NODE_RECONNECT_MIN_MS to NODE_RECONNECT_MAX_MS).
+ *
+ * Dependencies:
+ *  - market_record.h: Record layout.
+ *  - POSIX sockets.
+ *
+ * Usage:
+ *  - `crypto_ws --node <host>:<port> [name]` (see `main.c`), or from an
+ *    application:
+ *        node_sender_start("10.0.0.5", 9100, "collector-a");
+ *        ... node_sender_write(&record) from feed callbacks ...
+ *        ... node_sender_poll() after every cryptofeed_service() ...
+ *        node_sender_stop();
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#ifndef NODE_LINK_H
+#define NODE_LINK_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "market_record.h"
+
+#define NODE_LINK_MAGIC 0x4b4e5343u            // "CSNK"
+#define NODE_LINK_VERSION 1
+#define NODE_NAME_LEN 32
+
+#define NODE_SEND_BUFFER (4 * 1024 * 1024)     // bytes queued before records are dropped
+#define NODE_RECONNECT_MIN_MS 500
+#define NODE_RECONNECT_MAX_MS 10000
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t record_size;           // sizeof(MarketRecord), checked by the merge node
+    uint32_t reserved;
+    char node[NODE_NAME_LEN];       // NUL-terminated node name, shown in merge statistics
+} NodeHello;
+
+_Static_assert(sizeof(NodeHello) == 48, "NodeHello is part of the wire format");
+
+typedef struct {
+    uint64_t sent;                  // records fully written to the socket
+    uint64_t dropped;               // records discarded while disconnected or backed up
+    uint64_t connects;
+} NodeSenderStats;
+
+/* Start connecting to the merge node; returns 0 on success, -1 if `host` does not resolve */
+int node_sender_start(const char *host, int port, const char *node_name);
+
+/* Queue one record; never blocks */
+void node_sender_write(const MarketRecord *record);
+
+/* Connect, reconnect and flush queued records; call often from the service loop */
+void node_sender_poll();
+
+void node_sender_get_stats(NodeSenderStats *stats);
+
+/* Bytes queued but not yet accepted by the socket */
+size_t node_sender_backlog();
+
+/* Give queued records up to two seconds to leave, then close */
+void node_sender_stop();
+
+#endif // NODE_LINK_H
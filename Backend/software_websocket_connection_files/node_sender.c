@@ -0,0 +1,244 @@
+/*
+ * Node Sender
+ *
+ * Ships this collector's records to a merge node over one TCP connection
+ * (wire format in `node_link.h`).
+ *
+ * Features:
+ *  - Non-blocking connect and writes; the service thread only ever copies a
+ *    record into the send buffer.
+ *  - TCP_NODELAY, so a lone trade is not held back by Nagle's algorithm;
+ *    records queued in one service pass still leave in one write.
+ *  - On a broken connection the unsent tail is dropped and counted, and the
+ *    next connection starts with a fresh `NodeHello`.
+ *
+ * Dependencies:
+ *  - node_link.h, POSIX sockets (getaddrinfo, poll).
+ *
+ * Usage:
+ *  - See `node_link.h`.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#include "node_link.h"
+#include "huge_alloc.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#define FLUSH_THRESHOLD (64 * 1024)    // write immediately once this much is queued
+#define NODE_STOP_FLUSH_MS 2000         // how long stop waits for queued records to leave
+
+typedef enum { SENDER_IDLE = 0, SENDER_CONNECTING, SENDER_CONNECTED } SenderState;
+
+static struct sockaddr_storage address;
+static socklen_t address_len = 0;
+static char endpoint[300];
+static char node_name[NODE_NAME_LEN];
+
+static SenderState state = SENDER_IDLE;
+static int fd = -1;
+static char *buffer = NULL;
+static size_t head = 0, tail = 0;      // unsent bytes are buffer[head, tail)
+static size_t hello_left = 0;          // bytes of the hello still in the buffer
+static uint64_t payload_sent = 0;      // record bytes written on this connection
+static uint64_t sent_before_connect = 0;
+static int backoff_ms = NODE_RECONNECT_MIN_MS;
+static long long next_connect_ms = 0;
+static NodeSenderStats stats;
+
+static long long monotonic_ms() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static void disconnect(const char *reason) {
+    if (fd >= 0) close(fd);
+    fd = -1;
+
+    if (state == SENDER_CONNECTED) {
+        size_t unsent = tail - head - hello_left;
+        stats.dropped += (unsent + sizeof(MarketRecord) - 1) / sizeof(MarketRecord);
+        printf("[WARNING] Lost merge node %s: %s\n", endpoint, reason);
+    }
+    state = SENDER_IDLE;
+    head = tail = hello_left = 0;
+    next_connect_ms = monotonic_ms() + backoff_ms;
+    backoff_ms *= 2;
+    if (backoff_ms > NODE_RECONNECT_MAX_MS) backoff_ms = NODE_RECONNECT_MAX_MS;
+}
+
+static void begin_connect() {
+    fd = socket(address.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        disconnect(strerror(errno));
+        return;
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    if (connect(fd, (struct sockaddr *)&address, address_len) != 0 && errno != EINPROGRESS) {
+        disconnect(strerror(errno));
+        return;
+    }
+    state = SENDER_CONNECTING;
+}
+
+static void on_connected() {
+    NodeHello hello;
+    memset(&hello, 0, sizeof(hello));
+    hello.magic = NODE_LINK_MAGIC;
+    hello.version = NODE_LINK_VERSION;
+    hello.record_size = sizeof(MarketRecord);
+    memcpy(hello.node, node_name, sizeof(hello.node));
+
+    memcpy(buffer, &hello, sizeof(hello));
+    head = 0;
+    tail = hello_left = sizeof(hello);
+    payload_sent = 0;
+    sent_before_connect = stats.sent;
+    state = SENDER_CONNECTED;
+    backoff_ms = NODE_RECONNECT_MIN_MS;
+    stats.connects++;
+    printf("[INFO] Streaming records to merge node %s as \"%s\"\n", endpoint, node_name);
+}
+
+static void flush() {
+    while (head < tail) {
+        ssize_t n = send(fd, buffer + head, tail - head, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            if (errno == EINTR) continue;
+            disconnect(strerror(errno));
+            return;
+        }
+
+        /* Count whole records that have left, after the hello */
+        size_t hello_part = (size_t)n < hello_left ? (size_t)n : hello_left;
+        hello_left -= hello_part;
+        head += n;
+        payload_sent += n - hello_part;
+        stats.sent = sent_before_connect + payload_sent / sizeof(MarketRecord);
+    }
+    if (head == tail) head = tail = 0;
+}
+
+int node_sender_start(const char *host, int port, const char *name) {
+    struct addrinfo hints, *res = NULL;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    char service[16];
+    snprintf(service, sizeof(service), "%d", port);
+    int rc = getaddrinfo(host, service, &hints, &res);
+    if (rc != 0 || !res) {
+        printf("[ERROR] Cannot resolve merge node %s: %s\n", host, gai_strerror(rc));
+        return -1;
+    }
+    memcpy(&address, res->ai_addr, res->ai_addrlen);
+    address_len = res->ai_addrlen;
+    freeaddrinfo(res);
+
+    buffer = huge_alloc(NODE_SEND_BUFFER, "node send buffer");
+    if (!buffer) return -1;
+
+    snprintf(endpoint, sizeof(endpoint), "%s:%d", host, port);
+    snprintf(node_name, sizeof(node_name), "%s", name);
+    memset(&stats, 0, sizeof(stats));
+    state = SENDER_IDLE;
+    next_connect_ms = 0;
+    node_sender_poll();
+    return 0;
+}
+
+void node_sender_write(const MarketRecord *record) {
+    if (state != SENDER_CONNECTED) {
+        if (buffer) stats.dropped++;
+        return;
+    }
+
+    if (tail + sizeof(MarketRecord) > NODE_SEND_BUFFER) {
+        if (head > 0) {
+            memmove(buffer, buffer + head, tail - head);
+            tail -= head;
+            head = 0;
+        }
+        if (tail + sizeof(MarketRecord) > NODE_SEND_BUFFER) {
+            stats.dropped++;
+            return;
+        }
+    }
+
+    memcpy(buffer + tail, record, sizeof(MarketRecord));
+    tail += sizeof(MarketRecord);
+    if (tail - head >= FLUSH_THRESHOLD) flush();
+}
+
+void node_sender_poll() {
+    if (!buffer) return;
+
+    switch (state) {
+        case SENDER_IDLE:
+            if (monotonic_ms() >= next_connect_ms) begin_connect();
+            if (state != SENDER_CONNECTING) break;
+            /* A loopback connect often completes at once */
+            /* fall through */
+        case SENDER_CONNECTING: {
+            struct pollfd pfd = { .fd = fd, .events = POLLOUT };
+            if (poll(&pfd, 1, 0) <= 0) break;
+            int err = 0;
+            socklen_t len = sizeof(err);
+            getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len);
+            if (err) {
+                disconnect(strerror(err));
+                break;
+            }
+            on_connected();
+            flush();
+            break;
+        }
+        case SENDER_CONNECTED:
+            flush();
+            break;
+    }
+}
+
+void node_sender_get_stats(NodeSenderStats *out) {
+    *out = stats;
+}
+
+size_t node_sender_backlog() {
+    return (state == SENDER_CONNECTED) ? tail - head : 0;
+}
+
+void node_sender_stop() {
+    if (!buffer) return;
+
+    long long deadline = monotonic_ms() + NODE_STOP_FLUSH_MS;
+    while (state == SENDER_CONNECTED && head < tail && monotonic_ms() < deadline) {
+        struct pollfd pfd = { .fd = fd, .events = POLLOUT };
+        poll(&pfd, 1, 50);
+        flush();
+    }
+    if (fd >= 0) close(fd);
+    fd = -1;
+    state = SENDER_IDLE;
+    huge_free(buffer, NODE_SEND_BUFFER);
+    buffer = NULL;
+    printf("[INFO] Node sender stopped: %llu records sent, %llu dropped, %llu connections\n",
+           (unsigned long long)stats.sent, (unsigned long long)stats.dropped, (unsigned long long)stats.connects);
+}
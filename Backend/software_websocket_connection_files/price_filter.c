@@ -0,0 +1,242 @@
+/*
+ * Price Filter
+ *
+ * Implements the streaming median/MAD bad-tick filter from `price_filter.h`.
+ * Windows for every venue symbol and every normalized pair live in two
+ * arrays indexed by registry id (`symbol_registry.h`), on prefaulted huge
+ * pages; nothing is allocated per tick.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#include "price_filter.h"
+#include "symbol_registry.h"
+#include "huge_alloc.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+
+#define MAD_TO_SIGMA 1.4826                 // MAD of a normal distribution is 0.6745 sigma
+
+/* Last PRICE_FILTER_WINDOW accepted prices, in arrival order and sorted */
+typedef struct {
+    double ring[PRICE_FILTER_WINDOW];
+    double sorted[PRICE_FILTER_WINDOW];
+    uint32_t count;
+    uint32_t next;                          // ring position of the next insert
+} RobustWindow;
+
+typedef struct {
+    uint32_t streak;                        // consecutive outliers
+    RobustWindow window;
+} VenueState;
+
+/* Indexed by symbol id and pair id */
+static VenueState *venues = NULL;
+static RobustWindow *pairs = NULL;
+static FILE *quarantine_file = NULL;
+
+/* Why the last outlier was rejected, for the quarantine log */
+static double last_median = 0.0;
+static double last_score = 0.0;
+
+static unsigned long long checked = 0, outliers = 0, invalid = 0, level_shifts = 0;
+static unsigned long long reported_checked = 0, reported_outliers = 0;
+static int64_t next_report_ns = 0;
+
+/* ------------------------------- Robust window ---------------------------------- */
+
+/* First position in `sorted` whose value is >= `value` */
+static uint32_t lower_bound(const double *sorted, uint32_t count, double value) {
+    uint32_t lo = 0, hi = count;
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        if (sorted[mid] < value) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+static void window_insert(RobustWindow *w, double value) {
+    if (w->count == PRICE_FILTER_WINDOW) {
+        /* Full: the oldest price leaves the sorted copy first */
+        uint32_t at = lower_bound(w->sorted, w->count, w->ring[w->next]);
+        memmove(&w->sorted[at], &w->sorted[at + 1], (w->count - at - 1) * sizeof(double));
+        w->count--;
+    }
+    uint32_t at = lower_bound(w->sorted, w->count, value);
+    memmove(&w->sorted[at + 1], &w->sorted[at], (w->count - at) * sizeof(double));
+    w->sorted[at] = value;
+    w->count++;
+
+    w->ring[w->next] = value;
+    w->next = (w->next + 1) % PRICE_FILTER_WINDOW;
+}
+
+/*
+ * k-th smallest (0-based) absolute deviation from sorted[mid]. Deviations
+ * of the values left of the median, read outwards, are ascending, and so
+ * are those to its right: a k-th-of-two-sorted-arrays search, O(log n).
+ */
+static double kth_deviation(const RobustWindow *w, uint32_t mid, uint32_t k) {
+    const double *s = w->sorted;
+    double m = s[mid];
+    uint32_t na = mid + 1;                  // left:  A[i] = m - s[mid - i]
+    uint32_t nb = w->count - na;            // right: B[j] = s[mid + 1 + j] - m
+
+    uint32_t lo = (k + 1 > nb) ? k + 1 - nb : 0;
+    uint32_t hi = (k + 1 < na) ? k + 1 : na;
+    while (lo < hi) {
+        uint32_t i = (lo + hi) / 2;         // take i from A, k + 1 - i from B
+        uint32_t j = k + 1 - i;
+        if (j > 0 && (s[mid + j] - m) > (m - s[mid - i])) lo = i + 1;
+        else hi = i;
+    }
+    uint32_t i = lo, j = k + 1 - lo;
+    double a = i > 0 ? m - s[mid - (i - 1)] : 0.0;
+    double b = j > 0 ? s[mid + j] - m : 0.0;
+    return a > b ? a : b;
+}
+
+/* Robust z-score of `value` in the window; 0 while the window is warming up */
+static double robust_score(const RobustWindow *w, double value, double *median_out) {
+    if (w->count < PRICE_FILTER_MIN_SAMPLES) return 0.0;
+
+    uint32_t mid = (w->count - 1) / 2;
+    double median = w->sorted[mid];
+    double scale = MAD_TO_SIGMA * kth_deviation(w, mid, mid);
+    double floor = PRICE_FILTER_MIN_BAND * median;
+    if (scale < floor) scale = floor;
+
+    *median_out = median;
+    return fabs(value - median) / scale;
+}
+
+/* ------------------------------------- API -------------------------------------- */
+
+int price_filter_parse_mode(const char *text) {
+    if (strcmp(text, "off") == 0) return PRICE_FILTER_OFF;
+    if (strcmp(text, "flag") == 0) return PRICE_FILTER_FLAG;
+    if (strcmp(text, "quarantine") == 0) return PRICE_FILTER_QUARANTINE;
+    return -1;
+}
+
+int price_filter_start(PriceFilterMode mode) {
+    if (mode == PRICE_FILTER_OFF) return 0;
+
+    venues = huge_alloc(sizeof(VenueState) * SYMBOL_REGISTRY_MAX, "price filter windows");
+    pairs = huge_alloc(sizeof(RobustWindow) * SYMBOL_REGISTRY_PAIRS, "price filter pair windows");
+    if (!venues || !pairs) {
+        huge_free(venues, sizeof(VenueState) * SYMBOL_REGISTRY_MAX);
+        huge_free(pairs, sizeof(RobustWindow) * SYMBOL_REGISTRY_PAIRS);
+        venues = NULL;
+        pairs = NULL;
+        return -1;
+    }
+
+    if (mode == PRICE_FILTER_QUARANTINE) {
+        quarantine_file = fopen(PRICE_FILTER_QUARANTINE_FILE, "a");
+        if (!quarantine_file)
+            printf("[WARNING] Failed to open %s (%s), quarantined ticks are only counted\n",
+                   PRICE_FILTER_QUARANTINE_FILE, strerror(errno));
+    }
+
+    printf("[INFO] Price filter: %s outliers beyond %.0f robust sigma over the last %d prices\n",
+           mode == PRICE_FILTER_FLAG ? "flagging" : "quarantining", PRICE_FILTER_THRESHOLD, PRICE_FILTER_WINDOW);
+    return 0;
+}
+
+static void report(int64_t now_ns) {
+    printf("[STATS] price filter: %llu checked, %llu outliers (%.4f%%), %llu invalid, %llu level shifts\n",
+           checked - reported_checked, outliers - reported_outliers,
+           checked > reported_checked ? 100.0 * (outliers - reported_outliers) / (checked - reported_checked) : 0.0,
+           invalid, level_shifts);
+    reported_checked = checked;
+    reported_outliers = outliers;
+    next_report_ns = now_ns + (int64_t)PRICE_FILTER_REPORT_MS * 1000000;
+    if (quarantine_file) fflush(quarantine_file);
+}
+
+static int mark_outlier(MarketRecord *record) {
+    record->flags |= MARKET_FLAG_OUTLIER;
+    outliers++;
+    return 1;
+}
+
+int price_filter_check(MarketRecord *record, int id) {
+    if (!venues) return 0;
+    checked++;
+    if (record->recv_ns >= next_report_ns) {
+        if (next_report_ns) report(record->recv_ns);
+        else next_report_ns = record->recv_ns + (int64_t)PRICE_FILTER_REPORT_MS * 1000000;
+    }
+
+    /* Quote-only records are judged by their mid */
+    double value = record->price;
+    if (record->kind == MARKET_RECORD_QUOTE) value = (record->bid + record->ask) / 2;
+
+    last_median = 0.0;
+    last_score = INFINITY;
+    if (!isfinite(value) || value <= 0 ||
+        (record->kind != MARKET_RECORD_TRADE && record->bid > 0 && record->ask > 0 && record->bid > record->ask)) {
+        invalid++;
+        return mark_outlier(record);
+    }
+
+    if (id < 0) return 0;
+    VenueState *v = &venues[id];
+    int pair_id = symbol_registry_info(id)->pair;
+    RobustWindow *pair = pair_id >= 0 ? &pairs[pair_id] : NULL;
+
+    double venue_median = value, pair_median = value;
+    double score = robust_score(&v->window, value, &venue_median);
+    if (score > PRICE_FILTER_THRESHOLD && pair && pair->count >= PRICE_FILTER_MIN_SAMPLES) {
+        /* Off for this venue; let the other venues' prices decide */
+        double pair_score = robust_score(pair, value, &pair_median);
+        if (pair_score < score) score = pair_score;
+    }
+
+    if (score > PRICE_FILTER_THRESHOLD) {
+        if (++v->streak < PRICE_FILTER_MAX_STREAK) {
+            last_median = venue_median;
+            last_score = score;
+            return mark_outlier(record);
+        }
+        /* Persistently off: a new price level, not a bad tick */
+        v->window.count = 0;
+        v->window.next = 0;
+        level_shifts++;
+    }
+
+    v->streak = 0;
+    window_insert(&v->window, value);
+    if (pair) window_insert(pair, value);
+    return 0;
+}
+
+void price_filter_quarantine(const MarketRecord *record) {
+    if (!quarantine_file) return;
+    static const char *kinds[] = { "none", "ticker", "quote", "trade" };
+    fprintf(quarantine_file,
+            "{\"recv_ms\":%lld,\"exchange\":\"%s\",\"symbol\":\"%s\",\"kind\":\"%s\",\"price\":%.10g,"
+            "\"bid\":%.10g,\"ask\":%.10g,\"size\":%.10g,\"median\":%.10g,\"score\":%.2f}\n",
+            (long long)(record->recv_ns / 1000000), record->exchange, record->symbol,
+            kinds[record->kind <= MARKET_RECORD_TRADE ? record->kind : 0], record->price,
+            record->bid, record->ask, record->size, last_median, isfinite(last_score) ? last_score : -1.0);
+}
+
+void price_filter_stop() {
+    if (!venues) return;
+    report(0);
+    if (quarantine_file) fclose(quarantine_file);
+    quarantine_file = NULL;
+
+    huge_free(venues, sizeof(VenueState) * SYMBOL_REGISTRY_MAX);
+    huge_free(pairs, sizeof(RobustWindow) * SYMBOL_REGISTRY_PAIRS);
+    venues = NULL;
+    pairs = NULL;
+}
@@ -0,0 +1,73 @@
+/*
+ * Price Filter Header
+ *
+ * Declares the inline bad-tick filter: every ticker, quote and trade price
+ * is checked against robust statistics of the recent prices of the same
+ * venue and symbol, and of the same asset pair across all venues.
+ *
+ * Features:
+ *  - Rolling median and MAD (median absolute deviation) over the last
+ *    PRICE_FILTER_WINDOW accepted prices, kept as a sorted window: an
+ *    update is two binary searches and a short memmove. The MAD is a
+ *    binary search over the two sorted halves around the median. Memory
+ *    per symbol is fixed.
+ *  - A price is an outlier when its robust z-score,
+ *    |price - median| / (1.4826 * MAD), exceeds PRICE_FILTER_THRESHOLD for
+ *    its venue and also for the consolidated window of its normalized
+ *    pair ("BTC-USDT" across venues), once that window has enough samples.
+ *    A move every venue makes together therefore passes.
+ *  - The scale never drops below PRICE_FILTER_MIN_BAND of the median, so
+ *    a flat market does not turn one-tick moves into outliers.
+ *  - PRICE_FILTER_MAX_STREAK outliers in a row are taken as a new price
+ *    level: the venue window restarts from the current price.
+ *  - Non-positive or non-finite prices and crossed quotes are always outliers.
+ *  - Outliers are not added to any window.
+ *
+ * Dependencies:
+ *  - market_record.h, symbol_registry.h (symbol and pair ids), huge_alloc.h.
+ *
+ * Usage:
+ *  - `cryptofeed.c` checks each record before it reaches the outputs and,
+ *    depending on `CryptoFeedConfig.price_filter`, flags or drops it.
+ *    All calls must come from the service thread.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#ifndef PRICE_FILTER_H
+#define PRICE_FILTER_H
+
+#include "market_record.h"
+
+#define PRICE_FILTER_WINDOW 64              // accepted prices kept per venue symbol and per pair
+#define PRICE_FILTER_MIN_SAMPLES 16         // accept everything until a window holds this many
+#define PRICE_FILTER_THRESHOLD 8.0          // robust z-score above which a price is an outlier
+#define PRICE_FILTER_MIN_BAND 0.002         // scale floor, as a fraction of the median
+#define PRICE_FILTER_MAX_STREAK 16          // consecutive outliers taken as a new venue price level
+#define PRICE_FILTER_REPORT_MS 60000
+#define PRICE_FILTER_QUARANTINE_FILE "quarantine_output_data.json"
+
+typedef enum {
+    PRICE_FILTER_OFF = 0,
+    PRICE_FILTER_FLAG,                      // outliers pass with MARKET_FLAG_OUTLIER set
+    PRICE_FILTER_QUARANTINE                 // outliers are dropped and written to the quarantine log
+} PriceFilterMode;
+
+/* Parse "off", "flag" or "quarantine"; -1 if unknown */
+int price_filter_parse_mode(const char *text);
+
+/* Allocate the windows and, in quarantine mode, open the quarantine log; returns 0, or -1 if out of memory */
+int price_filter_start(PriceFilterMode mode);
+
+/* Check one record of registry id `id` (-1 = only the sanity checks) and add it to its windows
+ * if it is clean; returns 1 (and sets MARKET_FLAG_OUTLIER) if it is an outlier, 0 otherwise */
+int price_filter_check(MarketRecord *record, int id);
+
+/* Append an outlier to the quarantine log */
+void price_filter_quarantine(const MarketRecord *record);
+
+/* Report totals, close the log and free the windows */
+void price_filter_stop();
+
+#endif // PRICE_FILTER_H
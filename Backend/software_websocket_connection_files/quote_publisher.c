@@ -0,0 +1,172 @@
+/*
+ * Quote Publisher
+ *
+ * Writes the shared-memory latest-quote table described in `quote_table.h`.
+ * All updates come from the lws service thread, so there is exactly one
+ * writer and no writer-side locking: each update is an odd/even seqlock
+ * bracket around plain stores.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#include "quote_publisher.h"
+#include "huge_alloc.h"
+#include "utils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+
+static QuoteTableHeader *table = NULL;
+static char table_name[64];
+static int table_full_reported = 0;
+
+static int64_t realtime_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+int quote_publisher_start(const char *name) {
+    /* A table left by a previous run may still be mapped by readers; they keep the old copy */
+    shm_unlink(name);
+
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        printf("[ERROR] shm_open(%s) failed: %s\n", name, strerror(errno));
+        return -1;
+    }
+    if (ftruncate(fd, QUOTE_TABLE_SIZE) != 0) {
+        printf("[ERROR] Failed to size quote table: %s\n", strerror(errno));
+        close(fd);
+        shm_unlink(name);
+        return -1;
+    }
+
+    void *map = mmap(NULL, QUOTE_TABLE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        printf("[ERROR] Failed to map quote table: %s\n", strerror(errno));
+        shm_unlink(name);
+        return -1;
+    }
+
+    huge_prepare_shared(map, QUOTE_TABLE_SIZE, 1);
+
+    /* ftruncate zero-fills, so every slot starts unclaimed */
+    table = (QuoteTableHeader *)map;
+    table->version = QUOTE_TABLE_VERSION;
+    table->slot_count = QUOTE_TABLE_SLOTS;
+    table->slot_size = sizeof(QuoteSlot);
+    table->state = QUOTE_TABLE_LIVE;
+    table->created_ns = realtime_ns();
+    __atomic_store_n(&table->magic, QUOTE_TABLE_MAGIC, __ATOMIC_RELEASE);
+
+    snprintf(table_name, sizeof(table_name), "%s", name);
+    printf("[INFO] Publishing latest quotes to /dev/shm%s (%d slots)\n", name, QUOTE_TABLE_SLOTS);
+    return 0;
+}
+
+/* Find the slot for (exchange, symbol), claiming a free one on first use */
+static QuoteSlot *slot_for(const char *exchange, const char *symbol) {
+    if (strlen(exchange) >= QUOTE_EXCHANGE_LEN || strlen(symbol) >= QUOTE_SYMBOL_LEN || !symbol[0])
+        return NULL;
+
+    QuoteSlot *slots = quote_table_slots(table);
+    uint32_t mask = table->slot_count - 1;
+    uint32_t index = quote_table_hash(exchange, symbol) & mask;
+
+    for (uint32_t probe = 0; probe <= mask; probe++) {
+        QuoteSlot *slot = &slots[(index + probe) & mask];
+        if (!slot->claimed) {
+            strcpy(slot->exchange, exchange);
+            strcpy(slot->symbol, symbol);
+            __atomic_store_n(&slot->claimed, 1, __ATOMIC_RELEASE);
+            __atomic_store_n(&table->used, table->used + 1, __ATOMIC_RELAXED);
+            return slot;
+        }
+        if (strcmp(slot->exchange, exchange) == 0 && strcmp(slot->symbol, symbol) == 0)
+            return slot;
+    }
+
+    if (!table_full_reported) {
+        printf("[WARNING] Quote table full (%d slots), new symbols are not published\n", QUOTE_TABLE_SLOTS);
+        table_full_reported = 1;
+    }
+    return NULL;
+}
+
+static void write_begin(QuoteSlot *slot) {
+    __atomic_store_n(&slot->seq, slot->seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static void write_end(QuoteSlot *slot) {
+    slot->update_ns = realtime_ns();
+    slot->updates++;
+    __atomic_store_n(&slot->seq, slot->seq + 1, __ATOMIC_RELEASE);
+}
+
+/* Parse a decimal field into `dest`; empty fields leave it unchanged */
+static void set_field(double *dest, const char *value) {
+    if (value[0]) *dest = strtod(value, NULL);
+}
+
+void quote_publisher_ticker(const TickerData *ticker, double usd_price) {
+    if (!table) return;
+    QuoteSlot *slot = slot_for(ticker->exchange, ticker->currency);
+    if (!slot) return;
+
+    long long event_ms = ticker->local_time ? 0 : timestamp_to_ms(ticker->time_ms[0] ? ticker->time_ms : ticker->timestamp);
+
+    write_begin(slot);
+    set_field(&slot->price, ticker->price);
+    set_field(&slot->bid, ticker->bid);
+    set_field(&slot->ask, ticker->ask);
+    set_field(&slot->bid_qty, ticker->bid_qty);
+    set_field(&slot->ask_qty, ticker->ask_qty);
+    if (event_ms) slot->event_ms = event_ms;
+    if (usd_price) slot->usd_price = usd_price;
+    write_end(slot);
+}
+
+void quote_publisher_trade(const TradeData *trade, double usd_price) {
+    if (!table || !trade->price[0]) return;
+    QuoteSlot *slot = slot_for(trade->exchange, trade->currency);
+    if (!slot) return;
+
+    long long event_ms = trade->local_time ? 0 : timestamp_to_ms(trade->timestamp);
+
+    write_begin(slot);
+    slot->price = strtod(trade->price, NULL);
+    if (event_ms) slot->event_ms = event_ms;
+    if (usd_price) slot->usd_price = usd_price;
+    write_end(slot);
+}
+
+void quote_publisher_record(const MarketRecord *record, double usd_price) {
+    if (!table || record->kind == MARKET_RECORD_NONE) return;
+    QuoteSlot *slot = slot_for(record->exchange, record->symbol);
+    if (!slot) return;
+
+    write_begin(slot);
+    if (record->price) slot->price = record->price;
+    if (record->bid) slot->bid = record->bid;
+    if (record->ask) slot->ask = record->ask;
+    if (record->bid_qty) slot->bid_qty = record->bid_qty;
+    if (record->ask_qty) slot->ask_qty = record->ask_qty;
+    if (record->event_ms) slot->event_ms = record->event_ms;
+    if (usd_price) slot->usd_price = usd_price;
+    write_end(slot);
+}
+
+void quote_publisher_stop() {
+    if (!table) return;
+    __atomic_store_n(&table->state, QUOTE_TABLE_CLOSED, __ATOMIC_RELEASE);
+    munmap(table, QUOTE_TABLE_SIZE);
+    shm_unlink(table_name);
+    table = NULL;
+}
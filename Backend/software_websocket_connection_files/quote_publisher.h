@@ -0,0 +1,48 @@
+/*
+ * Quote Publisher Header
+ *
+ * Declares the collector side of the shared-memory latest-quote table
+ * (`quote_table.h`).
+ *
+ * Features:
+ *  - Creates the table in /dev/shm and marks it closed on exit.
+ *  - Turns parsed tickers, top-of-book quotes and trades into seqlocked
+ *    slot updates; fields a message does not carry keep their last value.
+ *
+ * Dependencies:
+ *  - quote_table.h: Shared layout.
+ *  - exchange_websocket.h: TickerData / TradeData.
+ *  - market_record.h: Records forwarded by the supervisor aggregator.
+ *
+ * Usage:
+ *  - Implemented in `quote_publisher.c`.
+ *  - Created, closed and fed by `cryptofeed.c`, or by `supervisor.c` when
+ *    collectors run in child processes.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#ifndef QUOTE_PUBLISHER_H
+#define QUOTE_PUBLISHER_H
+
+#include "quote_table.h"
+#include "exchange_websocket.h"
+#include "market_record.h"
+
+/* Create (or replace) the shared table; returns 0 on success, -1 on error */
+int quote_publisher_start(const char *name);
+
+/* Update the slot for a ticker or top-of-book message; `usd_price` 0 keeps the last one */
+void quote_publisher_ticker(const TickerData *ticker, double usd_price);
+
+/* Update the last price of the slot for a trade */
+void quote_publisher_trade(const TradeData *trade, double usd_price);
+
+/* Update from a record read back from a tick ring (supervisor aggregator); zero fields are kept */
+void quote_publisher_record(const MarketRecord *record, double usd_price);
+
+/* Mark the table closed and unlink it */
+void quote_publisher_stop();
+
+#endif // QUOTE_PUBLISHER_H
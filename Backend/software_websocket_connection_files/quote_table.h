@@ -0,0 +1,199 @@
+/*
+ * Quote Table Header
+ *
+ * Declares the shared-memory latest-quote table the collector publishes for
+ * co-located consumers, and a header-only reader API for them.
+ *
+ * Features:
+ *  - One 128-byte, cache-line-aligned slot per (exchange, symbol) holding
+ *    last price, bid/ask, sizes and the exchange event time, plus the last
+ *    price converted to USD through the currency graph (`currency_graph.h`).
+ *  - Each slot is protected by a seqlock: the collector never blocks, readers
+ *    retry if they raced with an update. Reads are lock-free and make no
+ *    syscalls once the table is mapped.
+ *  - Slots are found by hashing (exchange, symbol) with linear probing; a
+ *    slot's key is written once and never moves.
+ *  - Exchange and symbol are stored as the collector logs them
+ *    (e.g. "Binance" / "BTCUSDT", "Kraken" / "XBT/USD").
+ *
+ * Dependencies:
+ *  - POSIX shared memory (sys/mman.h, fcntl.h); GCC/Clang `__atomic`
+ *    builtins, so the header also builds as C++.
+ *
+ * Usage:
+ *  - Written by the collector through `quote_publisher.c`.
+ *  - Consumers: include this header only, then
+ *        QuoteTableReader r;
+ *        if (quote_table_attach(&r, QUOTE_TABLE_NAME) == 0) {
+ *            const QuoteSlot *slot = quote_table_find(&r, "Binance", "BTCUSDT");
+ *            QuoteSnapshot q;
+ *            if (slot && quote_table_read(slot, &q)) ... q.bid, q.ask ...
+ *        }
+ *    Keep the slot pointer; later reads of it are a handful of loads.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#ifndef QUOTE_TABLE_H
+#define QUOTE_TABLE_H
+
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define QUOTE_TABLE_NAME "/crypto_ws_quotes"   // appears as /dev/shm/crypto_ws_quotes
+#define QUOTE_TABLE_MAGIC 0x51575343u          // "CSWQ"
+#define QUOTE_TABLE_VERSION 2
+#define QUOTE_TABLE_SLOTS 16384                // power of two
+#define QUOTE_EXCHANGE_LEN 16
+#define QUOTE_SYMBOL_LEN 24
+
+#define QUOTE_TABLE_LIVE 1                     // collector running
+#define QUOTE_TABLE_CLOSED 2                   // collector exited, values are final
+
+typedef struct __attribute__((aligned(64))) {
+    uint32_t magic;                 // written last, once the table is initialised
+    uint32_t version;
+    uint32_t slot_count;
+    uint32_t slot_size;
+    uint32_t state;                 // QUOTE_TABLE_LIVE / QUOTE_TABLE_CLOSED
+    uint32_t used;                  // slots claimed so far
+    int64_t created_ns;             // CLOCK_REALTIME
+} QuoteTableHeader;
+
+typedef struct __attribute__((aligned(64))) {
+    uint32_t seq;                   // seqlock: odd while the collector is writing
+    uint32_t claimed;               // exchange/symbol set; never cleared
+    char exchange[QUOTE_EXCHANGE_LEN];
+    char symbol[QUOTE_SYMBOL_LEN];
+
+    double price;                   // last price (ticker or trade)
+    double bid;
+    double ask;
+    double bid_qty;
+    double ask_qty;
+    int64_t event_ms;               // exchange event time, 0 if unknown
+    int64_t update_ns;              // CLOCK_REALTIME when the collector wrote the slot
+    uint64_t updates;
+    double usd_price;               // last price in USD, 0 if its quote asset has no path to USD
+} QuoteSlot;
+
+/* Consistent copy of one slot */
+typedef struct {
+    double price;
+    double bid;
+    double ask;
+    double bid_qty;
+    double ask_qty;
+    int64_t event_ms;
+    int64_t update_ns;
+    uint64_t updates;
+    double usd_price;
+} QuoteSnapshot;
+
+_Static_assert(sizeof(QuoteSlot) == 128, "QuoteSlot must stay two cache lines");
+
+#define QUOTE_TABLE_SIZE (sizeof(QuoteTableHeader) + (size_t)QUOTE_TABLE_SLOTS * sizeof(QuoteSlot))
+
+/* FNV-1a over "exchange\0symbol", shared by the writer and readers */
+static inline uint32_t quote_table_hash(const char *exchange, const char *symbol) {
+    uint32_t h = 2166136261u;
+    for (const char *p = exchange; *p; p++) h = (h ^ (uint8_t)*p) * 16777619u;
+    h = (h ^ 0u) * 16777619u;
+    for (const char *p = symbol; *p; p++) h = (h ^ (uint8_t)*p) * 16777619u;
+    return h;
+}
+
+static inline QuoteSlot *quote_table_slots(QuoteTableHeader *header) {
+    return (QuoteSlot *)(header + 1);
+}
+
+/* ----------------------------- Reader (header-only) ----------------------------- */
+
+typedef struct {
+    const QuoteTableHeader *header;
+    const QuoteSlot *slots;
+} QuoteTableReader;
+
+/* Map the table read-only; returns 0 on success, -1 if it does not exist or is not a quote table */
+static inline int quote_table_attach(QuoteTableReader *reader, const char *name) {
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < QUOTE_TABLE_SIZE) {
+        close(fd);
+        return -1;
+    }
+
+    void *map = mmap(NULL, QUOTE_TABLE_SIZE, PROT_READ, MAP_SHARED | MAP_POPULATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return -1;
+
+    const QuoteTableHeader *header = (const QuoteTableHeader *)map;
+    if (__atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) != QUOTE_TABLE_MAGIC ||
+        header->version != QUOTE_TABLE_VERSION || header->slot_size != sizeof(QuoteSlot)) {
+        munmap(map, QUOTE_TABLE_SIZE);
+        return -1;
+    }
+
+    reader->header = header;
+    reader->slots = (const QuoteSlot *)(header + 1);
+    return 0;
+}
+
+static inline void quote_table_detach(QuoteTableReader *reader) {
+    if (reader->header) munmap((void *)reader->header, QUOTE_TABLE_SIZE);
+    reader->header = NULL;
+    reader->slots = NULL;
+}
+
+/* QUOTE_TABLE_LIVE while the collector runs, QUOTE_TABLE_CLOSED after it exits */
+static inline uint32_t quote_table_state(const QuoteTableReader *reader) {
+    return __atomic_load_n(&reader->header->state, __ATOMIC_ACQUIRE);
+}
+
+/* Slot for (exchange, symbol), or NULL if the collector has not published it yet */
+static inline const QuoteSlot *quote_table_find(const QuoteTableReader *reader, const char *exchange, const char *symbol) {
+    uint32_t mask = reader->header->slot_count - 1;
+    uint32_t index = quote_table_hash(exchange, symbol) & mask;
+
+    for (uint32_t probe = 0; probe <= mask; probe++) {
+        const QuoteSlot *slot = &reader->slots[(index + probe) & mask];
+        if (!__atomic_load_n(&slot->claimed, __ATOMIC_ACQUIRE)) return NULL;
+        if (strncmp(slot->exchange, exchange, QUOTE_EXCHANGE_LEN) == 0 &&
+            strncmp(slot->symbol, symbol, QUOTE_SYMBOL_LEN) == 0)
+            return slot;
+    }
+    return NULL;
+}
+
+/* Copy a consistent snapshot of `slot`; returns 0 if it has never been written */
+static inline int quote_table_read(const QuoteSlot *slot, QuoteSnapshot *out) {
+    uint32_t before, after;
+    do {
+        before = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+        if (before & 1) continue;
+
+        out->price = slot->price;
+        out->bid = slot->bid;
+        out->ask = slot->ask;
+        out->bid_qty = slot->bid_qty;
+        out->ask_qty = slot->ask_qty;
+        out->event_ms = slot->event_ms;
+        out->update_ns = slot->update_ns;
+        out->updates = slot->updates;
+        out->usd_price = slot->usd_price;
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        after = __atomic_load_n(&slot->seq, __ATOMIC_RELAXED);
+    } while ((before & 1) || before != after);
+
+    return out->updates != 0;
+}
+
+#endif // QUOTE_TABLE_H
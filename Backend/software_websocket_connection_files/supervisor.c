@@ -0,0 +1,478 @@
+/*
+ * Supervisor
+ *
+ * Runs the collector as several processes so one exchange's crash or CPU
+ * load cannot stall the others. The parent (aggregator) never opens a
+ * WebSocket itself: it forks the collectors, drains their tick rings into
+ * the merged outputs and restarts children that exit.
+ *
+ * Features:
+ *  - One child per `CollectorShard`, pinned round-robin to cores 1..N-1
+ *    (the aggregator takes core 0) when more than one core is online.
+ *  - Each child runs a normal `CryptoFeed` limited to its exchange and
+ *    shard, writing BSON and its private ring `/crypto_ws_ticks_<exchange>_<n>`.
+ *  - The aggregator owns `/dev/shm/crypto_ws_ticks`,
+ *    `/dev/shm/crypto_ws_quotes`, the trade analytics (so every shard's
+ *    trades land in one table) and the arbitrage detector, currency graph and
+ *    composite index, which have to see every venue; records keep the receive time stamped by
+ *    the child.
+ *  - The child processes cannot share the JSON logs, so the aggregator keeps
+ *    the store instead: every merged record is appended to a dated file of
+ *    raw `MarketRecord`s, as the merge node writes (`merge_node.h`).
+ *  - Children die with the aggregator (PR_SET_PDEATHSIG).
+ *  - With `CRYPTO_WS_LOW_LATENCY` set, each child spins on its own core;
+ *    `CRYPTO_WS_KTLS` is passed through the same way.
+ *  - Restart backoff doubles from SUPERVISOR_RESTART_MIN_MS up to
+ *    SUPERVISOR_RESTART_MAX_MS and resets once a child has run
+ *    SUPERVISOR_STABLE_MS.
+ *
+ * Dependencies:
+ *  - cryptofeed.h, tick_ring.h, tick_publisher.h, quote_publisher.h,
+ *    trade_analytics.h, symbol_registry.h, arb_detector.h, currency_graph.h,
+ *    composite_index.h, alert_engine.h.
+ *  - POSIX / Linux (fork, waitpid, sched_setaffinity, prctl).
+ *
+ * Usage:
+ *  - Called by `main.c` for `crypto_ws --supervise`.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#define _GNU_SOURCE
+#include "supervisor.h"
+#include "cryptofeed.h"
+#include "cryptofeed_internal.h"
+#include "exchange_adapter.h"
+#include "tick_ring.h"
+#include "tick_publisher.h"
+#include "quote_publisher.h"
+#include "trade_analytics.h"
+#include "symbol_registry.h"
+#include "arb_detector.h"
+#include "currency_graph.h"
+#include "composite_index.h"
+#include "alert_engine.h"
+#include "utils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/prctl.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#define DRAIN_BATCH 512                 // records taken from one child ring before moving on
+#define IDLE_SLEEP_US 200               // pause when every ring is caught up
+#define ATTACH_RETRY_MS 100             // how often to look for a restarted child's ring
+#define STOP_GRACE_MS 5000              // SIGTERM to SIGKILL
+#define STORE_BUFFER (1024 * 1024)
+
+typedef struct {
+    CollectorShard shard;
+    char ring_name[64];
+    pid_t pid;                          // 0 while not running
+    int cpu;                            // -1 = not pinned
+    long long started_ms;
+    long long next_start_ms;
+    int backoff_ms;
+    int64_t spawned_ns;                 // rings created before this belong to an earlier run
+
+    TickRingReader reader;
+    int attached;
+    long long next_attach_ms;
+
+    unsigned long long records;         // since the last statistics report
+    unsigned long long lost_reported;
+    unsigned restarts;
+} Collector;
+
+static volatile sig_atomic_t supervisor_stopping = 0;
+static CryptoFeed *child_feed = NULL;
+
+static int store_enabled = 0;
+static FILE *store = NULL;
+static long store_day = -1;
+
+static void on_supervisor_signal(int sig) {
+    (void)sig;
+    supervisor_stopping = 1;
+}
+
+static void on_child_signal(int sig) {
+    (void)sig;
+    if (child_feed) cryptofeed_stop(child_feed);
+}
+
+static int64_t realtime_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void pin_to_cpu(int cpu) {
+    if (cpu < 0) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (sched_setaffinity(0, sizeof(set), &set) != 0)
+        printf("[WARNING] Failed to pin pid %d to CPU %d: %s\n", (int)getpid(), cpu, strerror(errno));
+}
+
+int supervisor_parse_shards(int argc, char **argv, CollectorShard *shards, int max_shards) {
+    int count = 0;
+
+    if (argc == 0) {
+        for (int i = 0; i < exchange_adapter_count && count < max_shards; i++) {
+            snprintf(shards[count].exchange, sizeof(shards[count].exchange), "%s", exchange_adapters[i]->endpoint.exchange);
+            shards[count].shard_index = 0;
+            shards[count].shard_count = 1;
+            count++;
+        }
+        return count;
+    }
+
+    for (int a = 0; a < argc; a++) {
+        char name[16];
+        int shard_count = 1;
+        const char *slash = strchr(argv[a], '/');
+        size_t n = slash ? (size_t)(slash - argv[a]) : strlen(argv[a]);
+        if (n == 0 || n >= sizeof(name)) {
+            printf("[ERROR] Invalid collector shard \"%s\"\n", argv[a]);
+            return -1;
+        }
+        memcpy(name, argv[a], n);
+        name[n] = '\0';
+        if (slash) shard_count = atoi(slash + 1);
+
+        const ExchangeAdapter *adapter = find_exchange_adapter(name);
+        if (!adapter || shard_count < 1 || shard_count > adapter->max_connections) {
+            printf("[ERROR] Invalid collector shard \"%s\"\n", argv[a]);
+            return -1;
+        }
+
+        for (int s = 0; s < shard_count; s++) {
+            if (count == max_shards) {
+                printf("[ERROR] More than %d collector processes requested\n", max_shards);
+                return -1;
+            }
+            snprintf(shards[count].exchange, sizeof(shards[count].exchange), "%s", adapter->endpoint.exchange);
+            shards[count].shard_index = s;
+            shards[count].shard_count = shard_count;
+            count++;
+        }
+    }
+    return count;
+}
+
+/* Body of a collector process; never returns */
+static void run_collector(const Collector *c) {
+    /* Exit with the aggregator; covers the case where it died before prctl ran */
+    prctl(PR_SET_PDEATHSIG, SIGTERM);
+    if (getppid() == 1) _exit(0);
+
+    signal(SIGINT, SIG_IGN);            // Ctrl+C goes to the aggregator, which stops the children
+    signal(SIGTERM, on_child_signal);
+    pin_to_cpu(c->cpu);
+
+    CryptoFeedConfig config;
+    cryptofeed_default_config(&config);
+    config.log_json = 0;                // the JSON logs are single-writer files
+    config.quote_table = 0;             // merged by the aggregator
+    config.analytics = 0;               // likewise
+    config.arbitrage = 0;               // needs every venue, runs in the aggregator
+    config.usd_pricing = 0;             // likewise
+    config.composite_index = 0;
+    config.alerts = 0;                  // checked once, on the merged stream
+    config.tick_ring_name = c->ring_name;
+    config.exchanges = c->shard.exchange;
+    config.shard_index = c->shard.shard_index;
+    config.shard_count = c->shard.shard_count;
+
+    /* Low-latency collectors spin on the core the supervisor gave them */
+    const char *low_latency = getenv("CRYPTO_WS_LOW_LATENCY");
+    if (low_latency && cryptofeed_config_low_latency(&config, low_latency) == 0)
+        config.service_cpu = c->cpu;
+
+    const char *ktls = getenv("CRYPTO_WS_KTLS");
+    config.ktls = ktls && strcmp(ktls, "on") == 0;
+
+    /* Each child filters its own shard */
+    const char *price_filter = getenv("CRYPTO_WS_PRICE_FILTER");
+    if (price_filter) cryptofeed_config_price_filter(&config, price_filter);
+
+    child_feed = cryptofeed_create(&config);
+    if (!child_feed) _exit(1);
+    int result = cryptofeed_run(child_feed);
+    cryptofeed_destroy(child_feed);
+    fflush(stdout);
+    _exit(result == 0 ? 0 : 1);
+}
+
+static void spawn_collector(Collector *c, long long now) {
+    c->spawned_ns = realtime_ns();
+    /* Every stdio stream, not just stdout, or the child could write the aggregator's buffers again */
+    fflush(NULL);
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        printf("[ERROR] fork() failed for %s: %s\n", c->ring_name, strerror(errno));
+        c->next_start_ms = now + c->backoff_ms;
+        return;
+    }
+    if (pid == 0) run_collector(c);
+
+    c->pid = pid;
+    c->started_ms = now;
+    c->next_attach_ms = now;
+    if (c->cpu >= 0)
+        printf("[INFO] Started collector %s shard %d/%d (pid %d, CPU %d)\n", c->shard.exchange,
+               c->shard.shard_index + 1, c->shard.shard_count, (int)pid, c->cpu);
+    else
+        printf("[INFO] Started collector %s shard %d/%d (pid %d)\n", c->shard.exchange,
+               c->shard.shard_index + 1, c->shard.shard_count, (int)pid);
+}
+
+/* Start the day's SUPERVISOR_OUTPUT_DIR/records_YYYYMMDD.bin (UTC), appending if it exists */
+static void open_store(long day) {
+    if (store) fclose(store);
+    store = NULL;
+    store_day = day;
+
+    time_t t = (time_t)day * 86400;
+    struct tm tm;
+    gmtime_r(&t, &tm);
+    char filename[512];
+    snprintf(filename, sizeof(filename), "%s/records_%04d%02d%02d.bin", SUPERVISOR_OUTPUT_DIR,
+             tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday);
+
+    store = fopen(filename, "ab");
+    if (!store) {
+        printf("[ERROR] Failed to open merged store %s: %s\n", filename, strerror(errno));
+        return;
+    }
+    setvbuf(store, NULL, _IOFBF, STORE_BUFFER);
+    printf("[INFO] Writing merged records to %s\n", filename);
+}
+
+static void write_store(const MarketRecord *record) {
+    if (!store_enabled) return;
+    long day = (long)(time(NULL) / 86400);
+    if (day != store_day) open_store(day);
+    if (store && fwrite(record, sizeof(*record), 1, store) != 1)
+        printf("[ERROR] Failed to write merged record: %s\n", strerror(errno));
+}
+
+/* Cross-venue stages the aggregator runs on the merged stream (same sequence as a single-process feed) */
+static CryptoFeedConfig stages;
+
+/* Copy up to DRAIN_BATCH records from one child into the merged outputs */
+static int drain_collector(Collector *c) {
+    MarketRecord record;
+    int drained = 0;
+    while (drained < DRAIN_BATCH && tick_ring_poll(&c->reader, &record)) {
+        /* Outliers the child flagged stay out of the cross-venue quotes and rates */
+        int id = symbol_registry_id(record.exchange, record.symbol);
+        double usd_price = id >= 0 ? cryptofeed_run_clean_stages(&stages, id, &record,
+                                                                 record.flags & MARKET_FLAG_OUTLIER) : 0.0;
+
+        tick_publisher_write(&record);
+        write_store(&record);
+        quote_publisher_record(&record, usd_price);
+        trade_analytics_record(&record);
+        drained++;
+    }
+    c->records += drained;
+    return drained;
+}
+
+static void detach_collector(Collector *c) {
+    if (!c->attached) return;
+    while (drain_collector(c) > 0) {}
+    if (c->reader.lost > c->lost_reported)
+        printf("[WARNING] Aggregator lost %llu records from %s\n",
+               (unsigned long long)(c->reader.lost - c->lost_reported), c->ring_name);
+    tick_ring_detach(&c->reader);
+    c->attached = 0;
+    c->lost_reported = 0;
+}
+
+/* Map the ring of the current run of a child once it has created it */
+static void attach_collector(Collector *c, long long now) {
+    c->next_attach_ms = now + ATTACH_RETRY_MS;
+    if (tick_ring_attach(&c->reader, c->ring_name, TICK_RING_FROM_OLDEST) != 0) return;
+
+    /* Still the ring of the previous run: the child has not replaced it yet */
+    if (c->reader.header->created_ns < c->spawned_ns) {
+        tick_ring_detach(&c->reader);
+        return;
+    }
+    c->attached = 1;
+}
+
+static void reap_collectors(Collector *collectors, int count, long long now) {
+    int status;
+    pid_t pid;
+    while ((pid = waitpid(-1, &status, WNOHANG)) > 0) {
+        for (int i = 0; i < count; i++) {
+            Collector *c = &collectors[i];
+            if (c->pid != pid) continue;
+
+            if (WIFSIGNALED(status))
+                printf("[ERROR] Collector %s (pid %d) killed by signal %d\n", c->ring_name, (int)pid, WTERMSIG(status));
+            else
+                printf("[WARNING] Collector %s (pid %d) exited with status %d\n", c->ring_name, (int)pid, WEXITSTATUS(status));
+
+            detach_collector(c);
+            c->pid = 0;
+            if (supervisor_stopping) break;
+
+            if (now - c->started_ms >= SUPERVISOR_STABLE_MS) c->backoff_ms = SUPERVISOR_RESTART_MIN_MS;
+            c->next_start_ms = now + c->backoff_ms;
+            printf("[INFO] Restarting %s in %d ms\n", c->ring_name, c->backoff_ms);
+            c->backoff_ms *= 2;
+            if (c->backoff_ms > SUPERVISOR_RESTART_MAX_MS) c->backoff_ms = SUPERVISOR_RESTART_MAX_MS;
+            c->restarts++;
+            break;
+        }
+    }
+}
+
+static void report_collectors(Collector *collectors, int count, long long elapsed_ms) {
+    for (int i = 0; i < count; i++) {
+        Collector *c = &collectors[i];
+        unsigned long long lost = c->attached ? c->reader.lost - c->lost_reported : 0;
+        printf("[STATS] %s: %s, %.0f records/s, %llu lost, %u restarts\n", c->ring_name,
+               c->pid ? "running" : "stopped", elapsed_ms > 0 ? c->records * 1000.0 / elapsed_ms : 0.0,
+               lost, c->restarts);
+        c->records = 0;
+        if (c->attached) c->lost_reported = c->reader.lost;
+    }
+}
+
+/* SIGTERM every child, then SIGKILL whatever is left after STOP_GRACE_MS */
+static void stop_collectors(Collector *collectors, int count) {
+    for (int i = 0; i < count; i++)
+        if (collectors[i].pid) kill(collectors[i].pid, SIGTERM);
+
+    long long deadline = get_monotonic_ms() + STOP_GRACE_MS;
+    for (;;) {
+        reap_collectors(collectors, count, get_monotonic_ms());
+        int running = 0;
+        for (int i = 0; i < count; i++) running += collectors[i].pid != 0;
+        if (!running) return;
+
+        if (get_monotonic_ms() >= deadline) {
+            for (int i = 0; i < count; i++)
+                if (collectors[i].pid) kill(collectors[i].pid, SIGKILL);
+            deadline = get_monotonic_ms() + STOP_GRACE_MS;
+        }
+        usleep(10000);
+    }
+}
+
+int supervisor_run(const CollectorShard *shards, int count) {
+    if (count <= 0 || count > SUPERVISOR_MAX_CHILDREN) {
+        printf("[ERROR] Supervisor needs 1 to %d collectors\n", SUPERVISOR_MAX_CHILDREN);
+        return -1;
+    }
+
+    Collector *collectors = calloc(count, sizeof(Collector));
+    if (!collectors) {
+        printf("[ERROR] Memory allocation failed for collectors\n");
+        return -1;
+    }
+
+    /* Core 0 for the aggregator, the children round-robin over the rest */
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus > 1) pin_to_cpu(0);
+
+    long long now = get_monotonic_ms();
+    for (int i = 0; i < count; i++) {
+        Collector *c = &collectors[i];
+        c->shard = shards[i];
+        snprintf(c->ring_name, sizeof(c->ring_name), "%s_%s_%d", TICK_RING_NAME, c->shard.exchange, c->shard.shard_index);
+        c->cpu = (cpus > 1) ? 1 + (int)(i % (cpus - 1)) : -1;
+        c->backoff_ms = SUPERVISOR_RESTART_MIN_MS;
+        c->next_start_ms = now;
+    }
+
+    if (tick_publisher_start(TICK_RING_NAME) != 0)
+        printf("[WARNING] Merged tick ring disabled\n");
+    if (quote_publisher_start(QUOTE_TABLE_NAME) != 0)
+        printf("[WARNING] Merged quote table disabled\n");
+    if (trade_analytics_start(ANALYTICS_TABLE_NAME, ANALYTICS_OUTPUT_DIR) != 0)
+        printf("[WARNING] Trade analytics disabled\n");
+    store_enabled = mkdir(SUPERVISOR_OUTPUT_DIR, 0755) == 0 || errno == EEXIST;
+    if (!store_enabled)
+        printf("[WARNING] Merged store disabled, cannot create %s: %s\n", SUPERVISOR_OUTPUT_DIR, strerror(errno));
+    cryptofeed_default_config(&stages);
+    stages.classify_trades = 0;         // each collector classifies its own shard
+    if (arb_detector_start(getenv("CRYPTO_WS_TAKER_FEES")) != 0) {
+        printf("[WARNING] Arbitrage detector disabled\n");
+        stages.arbitrage = 0;
+    }
+    currency_graph_start();
+    composite_index_start();
+    if (alert_engine_start(getenv("CRYPTO_WS_ALERT_RULES")) != 0) {
+        printf("[WARNING] Alerts disabled\n");
+        stages.alerts = 0;
+    }
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_supervisor_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    printf("[INFO] Supervising %d collector processes on %ld CPUs\n", count, cpus);
+    long long last_stats_ms = now;
+
+    while (!supervisor_stopping) {
+        now = get_monotonic_ms();
+        reap_collectors(collectors, count, now);
+
+        int drained = 0;
+        for (int i = 0; i < count && !supervisor_stopping; i++) {
+            Collector *c = &collectors[i];
+            if (!c->pid && now >= c->next_start_ms) spawn_collector(c, now);
+            if (c->pid && !c->attached && now >= c->next_attach_ms) attach_collector(c, now);
+            if (c->attached) drained += drain_collector(c);
+        }
+        trade_analytics_poll();
+        arb_detector_poll();
+        currency_graph_poll();
+        composite_index_poll();
+        alert_engine_poll();
+
+        if (now - last_stats_ms >= SUPERVISOR_STATS_MS) {
+            report_collectors(collectors, count, now - last_stats_ms);
+            if (store) fflush(store);
+            last_stats_ms = now;
+        }
+
+        if (!drained) usleep(IDLE_SLEEP_US);
+    }
+
+    printf("[INFO] Stopping collectors...\n");
+    stop_collectors(collectors, count);
+    for (int i = 0; i < count; i++) detach_collector(&collectors[i]);
+
+    tick_publisher_stop();
+    if (store) fclose(store);
+    store = NULL;
+    store_day = -1;
+    quote_publisher_stop();
+    trade_analytics_stop();
+    arb_detector_stop();
+    alert_engine_stop();
+    composite_index_stop();
+    currency_graph_stop();
+    free(collectors);
+    return 0;
+}
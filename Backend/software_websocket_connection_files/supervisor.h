@@ -0,0 +1,52 @@
+/*
+ * Supervisor Header
+ *
+ * Declares the multi-process collector mode: the parent process forks one
+ * collector per exchange (or per shard of an exchange's connections), pins
+ * each to a core, merges their records and restarts any that exit.
+ *
+ * Features:
+ *  - `CollectorShard`: one child process, owning an exchange and every
+ *    `shard_count`-th of its connections.
+ *  - Children publish parsed records to their own shared-memory tick ring
+ *    (`tick_ring.h`); the aggregator drains every ring into the merged ring
+ *    and quote table, so readers see one feed, and appends every record to
+ *    `SUPERVISOR_OUTPUT_DIR/records_YYYYMMDD.bin` (the merge node's format).
+ *  - A crashed child is restarted with exponential backoff while the other
+ *    exchanges keep streaming.
+ *
+ * Dependencies:
+ *  - cryptofeed.h: Each child runs an ordinary feed restricted to its shard.
+ *  - POSIX fork / waitpid, Linux sched_setaffinity and prctl.
+ *
+ * Usage:
+ *  - `crypto_ws --supervise [exchange[/shards] ...]` (see `main.c`).
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#ifndef SUPERVISOR_H
+#define SUPERVISOR_H
+
+#define SUPERVISOR_MAX_CHILDREN 32
+#define SUPERVISOR_RESTART_MIN_MS 1000      // first restart delay after a crash
+#define SUPERVISOR_RESTART_MAX_MS 30000     // backoff cap
+#define SUPERVISOR_STABLE_MS 60000          // a child that ran this long restarts without backoff
+#define SUPERVISOR_STATS_MS 60000           // per-child statistics report period
+#define SUPERVISOR_OUTPUT_DIR "merged_output" // dated MarketRecord store of the merged stream
+
+typedef struct {
+    char exchange[16];              // adapter protocol prefix, e.g. "huobi"
+    int shard_index;
+    int shard_count;                // 1 = all connections of the exchange
+} CollectorShard;
+
+/* Turn "binance/2 okx huobi" style arguments into shards; no arguments = one child per adapter.
+ * Returns the shard count, or -1 on an unknown exchange or too many shards. */
+int supervisor_parse_shards(int argc, char **argv, CollectorShard *shards, int max_shards);
+
+/* Fork the collectors and run the aggregator until SIGINT / SIGTERM; returns 0 on a clean stop */
+int supervisor_run(const CollectorShard *shards, int count);
+
+#endif // SUPERVISOR_H
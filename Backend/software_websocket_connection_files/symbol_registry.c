@@ -0,0 +1,185 @@
+/*
+ * Symbol Registry
+ *
+ * Implements the dense symbol and pair ids of `symbol_registry.h`. Ids
+ * are handed out in order of first sight and never reused; two
+ * linear-probing indexes map names to them.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#include "symbol_registry.h"
+#include "exchange_adapter.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define INDEX_SLOTS (2 * SYMBOL_REGISTRY_MAX)       // power of two, load stays under 1/2
+#define PAIR_INDEX_SLOTS (2 * SYMBOL_REGISTRY_PAIRS)
+#define ASSET_INDEX_SLOTS (2 * SYMBOL_REGISTRY_ASSETS)
+
+static SymbolInfo symbols[SYMBOL_REGISTRY_MAX];
+static PairInfo pairs[SYMBOL_REGISTRY_PAIRS];
+static int symbol_count = 0;
+static char assets[SYMBOL_REGISTRY_ASSETS][SYMBOL_ASSET_LEN];
+static int pair_count = 0;
+static int asset_count = 0;
+static int full_reported = 0;
+
+/* id + 1 per slot, 0 = empty */
+static int symbol_index[INDEX_SLOTS];
+static int pair_index[PAIR_INDEX_SLOTS];
+static int asset_index[ASSET_INDEX_SLOTS];
+
+static uint32_t name_hash(const char *a, const char *b) {
+    uint32_t h = 2166136261u;
+    for (const char *p = a; *p; p++) h = (h ^ (uint8_t)*p) * 16777619u;
+    h = (h ^ 0u) * 16777619u;
+    for (const char *p = b; *p; p++) h = (h ^ (uint8_t)*p) * 16777619u;
+    return h;
+}
+
+static int venue_index(const char *exchange) {
+    const ExchangeAdapter *adapter = find_exchange_adapter(exchange);
+    for (int i = 0; adapter && i < exchange_adapter_count; i++)
+        if (exchange_adapters[i] == adapter) return i;
+    return -1;
+}
+
+/* Index slot of an asset name: its entry, or the empty slot where it belongs; NULL if the index is full */
+static int *asset_slot(const char *asset) {
+    uint32_t mask = ASSET_INDEX_SLOTS - 1;
+    uint32_t index = name_hash(asset, "") & mask;
+
+    for (uint32_t probe = 0; probe <= mask; probe++) {
+        int *slot = &asset_index[(index + probe) & mask];
+        if (!*slot || strcmp(assets[*slot - 1], asset) == 0) return slot;
+    }
+    return NULL;
+}
+
+/* Asset id, registering it on first use */
+static int asset_id(const char *asset) {
+    int *slot = asset_slot(asset);
+    if (!slot) return -1;
+    if (*slot) return *slot - 1;
+    if (asset_count == SYMBOL_REGISTRY_ASSETS) return -1;
+
+    snprintf(assets[asset_count], SYMBOL_ASSET_LEN, "%s", asset);
+    *slot = ++asset_count;
+    return asset_count - 1;
+}
+
+/* Pair id for a normalized "BASE-QUOTE" name, registering it on first use */
+static int pair_id(const char *name) {
+    uint32_t mask = PAIR_INDEX_SLOTS - 1;
+    uint32_t index = name_hash(name, "") & mask;
+
+    for (uint32_t probe = 0; probe <= mask; probe++) {
+        int *slot = &pair_index[(index + probe) & mask];
+        if (*slot && strcmp(pairs[*slot - 1].name, name) == 0) return *slot - 1;
+        if (*slot) continue;
+
+        const char *dash = strchr(name, '-');
+        if (!dash || pair_count == SYMBOL_REGISTRY_PAIRS) return -1;
+
+        PairInfo *pair = &pairs[pair_count];
+        snprintf(pair->name, sizeof(pair->name), "%s", name);
+        snprintf(pair->base, sizeof(pair->base), "%.*s", (int)(dash - name), name);
+        snprintf(pair->quote, sizeof(pair->quote), "%s", dash + 1);
+        pair->base_id = asset_id(pair->base);
+        pair->quote_id = asset_id(pair->quote);
+        pair->venue_count = 0;
+        *slot = ++pair_count;
+        return pair_count - 1;
+    }
+    return -1;
+}
+
+int symbol_registry_id(const char *exchange, const char *symbol) {
+    uint32_t mask = INDEX_SLOTS - 1;
+    uint32_t index = name_hash(exchange, symbol) & mask;
+
+    for (uint32_t probe = 0; probe <= mask; probe++) {
+        int *slot = &symbol_index[(index + probe) & mask];
+        if (*slot) {
+            const SymbolInfo *info = &symbols[*slot - 1];
+            if (strcmp(info->exchange, exchange) == 0 && strcmp(info->symbol, symbol) == 0) return *slot - 1;
+            continue;
+        }
+
+        if (symbol_count == SYMBOL_REGISTRY_MAX || strlen(exchange) >= MARKET_RECORD_EXCHANGE_LEN ||
+            strlen(symbol) >= MARKET_RECORD_SYMBOL_LEN) {
+            if (!full_reported && symbol_count == SYMBOL_REGISTRY_MAX) {
+                printf("[WARNING] Symbol registry full (%d symbols), new symbols skip cross-venue stages\n",
+                       SYMBOL_REGISTRY_MAX);
+                full_reported = 1;
+            }
+            return -1;
+        }
+
+        /* First sight: resolve venue and pair once */
+        int id = symbol_count++;
+        SymbolInfo *info = &symbols[id];
+        memset(info, 0, sizeof(*info));
+        strcpy(info->exchange, exchange);
+        strcpy(info->symbol, symbol);
+        info->venue = venue_index(exchange);
+
+        char pair[MARKET_RECORD_SYMBOL_LEN];
+        info->pair = exchange_normalize_symbol(exchange, symbol, pair, sizeof(pair)) ? pair_id(pair) : -1;
+        if (info->pair >= 0) {
+            PairInfo *p = &pairs[info->pair];
+            if (p->venue_count < SYMBOL_PAIR_MAX_VENUES) p->venues[p->venue_count++] = id;
+        }
+
+        *slot = id + 1;
+        return id;
+    }
+    return -1;
+}
+
+SymbolInfo *symbol_registry_info(int id) {
+    return &symbols[id];
+}
+
+const PairInfo *symbol_registry_pair(int pair) {
+    return &pairs[pair];
+}
+
+int symbol_registry_asset_id(const char *asset) {
+    int *slot = asset_slot(asset);
+    return slot && *slot ? *slot - 1 : -1;
+}
+
+const char *symbol_registry_asset(int asset) {
+    return assets[asset];
+}
+
+int symbol_registry_count() {
+    return symbol_count;
+}
+
+int symbol_registry_pair_count() {
+    return pair_count;
+}
+
+int symbol_registry_asset_count() {
+    return asset_count;
+}
+
+void symbol_registry_update(int id, const MarketRecord *record) {
+    SymbolQuote *q = &symbols[id].quote;
+    if (record->price > 0) {
+        q->last = record->price;
+        q->last_ns = record->recv_ns;
+    }
+    if (record->bid > 0 || record->ask > 0) {
+        if (record->bid > 0) q->bid = record->bid;
+        if (record->ask > 0) q->ask = record->ask;
+        if (record->bid_qty > 0) q->bid_qty = record->bid_qty;
+        if (record->ask_qty > 0) q->ask_qty = record->ask_qty;
+        q->quote_ns = record->recv_ns;
+    }
+}
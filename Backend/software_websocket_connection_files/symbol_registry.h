@@ -0,0 +1,97 @@
+/*
+ * Symbol Registry Header
+ *
+ * Declares the in-process registry that gives every (exchange, symbol) a
+ * small dense id on first sight, resolves it once to its venue and
+ * normalized pair, and keeps the latest clean quote per id.
+ *
+ * Features:
+ *  - Ids are dense (0, 1, 2, ...), so per-symbol state in other modules
+ *    is a plain array indexed by id instead of another hash table.
+ *  - Each id knows its adapter index and its normalized "BASE-QUOTE" pair
+ *    (`exchange_normalize_symbol()`); pairs have dense ids too, and list
+ *    the venue symbols quoting them. Their base and quote assets ("BTC",
+ *    "USDT") get dense asset ids as well.
+ *  - `SymbolQuote` per id: last price, best bid/ask and sizes, with the
+ *    receive time of each, updated from records that passed the price filter.
+ *  - Lookups hash (exchange, symbol) once per record; everything after
+ *    that is array indexing.
+ *
+ * Dependencies:
+ *  - market_record.h, exchange_adapter.h.
+ *
+ * Usage:
+ *  - `cryptofeed.c` (and the supervisor's aggregator) resolve each record
+ *    with `symbol_registry_id()` and hand the id to the price filter and
+ *    the cross-venue stages. Service thread only.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#ifndef SYMBOL_REGISTRY_H
+#define SYMBOL_REGISTRY_H
+
+#include "market_record.h"
+
+#define SYMBOL_REGISTRY_MAX 8192            // venue symbols
+#define SYMBOL_REGISTRY_PAIRS 4096          // normalized pairs
+#define SYMBOL_REGISTRY_ASSETS 2048         // distinct base/quote assets
+#define SYMBOL_PAIR_MAX_VENUES 16           // venue symbols listed per pair
+#define SYMBOL_ASSET_LEN 12
+
+/* Latest top of book and trade of one venue symbol */
+typedef struct {
+    double last;                    // last trade or ticker price
+    double bid;
+    double ask;
+    double bid_qty;
+    double ask_qty;
+    int64_t quote_ns;               // recv time of the last bid/ask, 0 = none yet
+    int64_t last_ns;                // recv time of the last price
+} SymbolQuote;
+
+typedef struct {
+    char exchange[MARKET_RECORD_EXCHANGE_LEN];
+    char symbol[MARKET_RECORD_SYMBOL_LEN];
+    int venue;                      // index in `exchange_adapters[]`, -1 if unknown
+    int pair;                       // normalized pair id, -1 if the symbol cannot be normalized
+    SymbolQuote quote;
+} SymbolInfo;
+
+typedef struct {
+    char name[MARKET_RECORD_SYMBOL_LEN];    // "BTC-USDT"
+    char base[SYMBOL_ASSET_LEN];
+    char quote[SYMBOL_ASSET_LEN];
+    int base_id;                            // asset ids, -1 when the asset table is full
+    int quote_id;
+    int venue_count;
+    int venues[SYMBOL_PAIR_MAX_VENUES];     // symbol ids quoting this pair
+} PairInfo;
+
+/* Current price of a venue symbol: the mid when its bid/ask is at least as recent as its last price */
+static inline double symbol_quote_price(const SymbolQuote *q) {
+    if (q->bid > 0 && q->ask > 0 && q->quote_ns >= q->last_ns) return (q->bid + q->ask) / 2;
+    return q->last;
+}
+
+/* Id of (exchange, symbol), registering it on first use; -1 when the registry is full */
+int symbol_registry_id(const char *exchange, const char *symbol);
+
+/* Info for a valid id */
+SymbolInfo *symbol_registry_info(int id);
+const PairInfo *symbol_registry_pair(int pair);
+
+/* Asset id of "BTC", "USD", ...; -1 if no pair has used it yet */
+int symbol_registry_asset_id(const char *asset);
+const char *symbol_registry_asset(int asset);
+
+/* Number of ids / pairs / assets handed out so far */
+int symbol_registry_count();
+int symbol_registry_pair_count();
+int symbol_registry_asset_count();
+
+/* Update the latest quote of `id` from a record; zero fields are kept */
+void symbol_registry_update(int id, const MarketRecord *record);
+
+#endif // SYMBOL_REGISTRY_H
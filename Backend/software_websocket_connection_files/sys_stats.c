@@ -0,0 +1,107 @@
+/*
+ * System Statistics
+ *
+ * Reads kernel-side counters for connection and CPU metrics. This file
+ * deliberately avoids libwebsockets/glibc TCP headers so it can use the
+ * Linux `struct tcp_info`, which carries the byte counters.
+ *
+ * Features:
+ *  - Socket byte counters via getsockopt(TCP_INFO).
+ *  - Per-thread CPU time via CLOCK_THREAD_CPUTIME_ID, preemptions via
+ *    getrusage(RUSAGE_THREAD).
+ *  - Thread pinning and socket busy polling for the low-latency mode.
+ *  - kTLS availability from /proc/sys/net/ipv4/tcp_available_ulp.
+ *
+ * Dependencies:
+ *  - Linux headers (linux/tcp.h), POSIX time, sched_setaffinity.
+ *
+ * Usage:
+ *  - Called by `exchange_connect.c` when reporting connection statistics
+ *    and by `cryptofeed.c` / `dns_cache.c` when pinning threads.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#define _GNU_SOURCE
+#include "sys_stats.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <time.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <linux/tcp.h>
+
+/* Read bytes received on a TCP socket from the kernel */
+long long get_socket_rx_bytes(int fd) {
+    if (fd < 0) return -1;
+
+    struct tcp_info info;
+    socklen_t len = sizeof(info);
+    if (getsockopt(fd, IPPROTO_TCP, TCP_INFO, &info, &len) != 0)
+        return -1;
+
+    /* Older kernels return a shorter struct without the byte counters */
+    if (len < offsetof(struct tcp_info, tcpi_bytes_received) + sizeof(info.tcpi_bytes_received))
+        return -1;
+
+    return (long long)info.tcpi_bytes_received;
+}
+
+/* CPU time of the calling thread */
+double get_thread_cpu_ms() {
+    struct timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0)
+        return 0.0;
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+/* Times the scheduler took the CPU away from the calling thread */
+long get_thread_involuntary_switches() {
+    struct rusage usage;
+    if (getrusage(RUSAGE_THREAD, &usage) != 0)
+        return -1;
+    return usage.ru_nivcsw;
+}
+
+/* Restrict the calling thread to a single CPU */
+int pin_current_thread(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0 ? 0 : -1;
+}
+
+/* Busy-poll the device queue for up to `usec` before sleeping on this socket */
+int set_socket_busy_poll(int fd, int usec) {
+#ifdef SO_BUSY_POLL
+    if (fd < 0 || setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &usec, sizeof(usec)) != 0)
+        return -1;
+#ifdef SO_PREFER_BUSY_POLL
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_PREFER_BUSY_POLL, &one, sizeof(one));
+#endif
+    return 0;
+#else
+    (void)fd;
+    (void)usec;
+    return -1;
+#endif
+}
+
+/* The kernel lists loaded upper-layer protocols; "tls" appears once the module is in */
+int kernel_tls_available() {
+    char ulps[256] = "";
+    FILE *fp = fopen("/proc/sys/net/ipv4/tcp_available_ulp", "r");
+    if (!fp) return 0;
+    if (!fgets(ulps, sizeof(ulps), fp)) ulps[0] = '\0';
+    fclose(fp);
+
+    for (char *tok = strtok(ulps, " \t\n"); tok; tok = strtok(NULL, " \t\n"))
+        if (strcmp(tok, "tls") == 0) return 1;
+    return 0;
+}
@@ -0,0 +1,49 @@
+/*
+ * System Statistics Header
+ *
+ * Declares small helpers that read kernel-side counters used for
+ * connection and CPU metrics.
+ *
+ * Features:
+ *  - get_socket_rx_bytes(): Bytes received on a TCP socket (TCP_INFO).
+ *  - get_thread_cpu_ms(): CPU time consumed by the calling thread.
+ *  - get_thread_involuntary_switches(): Times the calling thread was preempted.
+ *  - pin_current_thread(): Restrict the calling thread to one CPU.
+ *  - set_socket_busy_poll(): Let blocking reads spin on the NIC queue (SO_BUSY_POLL).
+ *  - kernel_tls_available(): Whether the kernel `tls` ULP (kTLS) is loaded.
+ *
+ * Dependencies:
+ *  - Linux TCP_INFO (kernel 4.1+ for byte counters), SO_BUSY_POLL (3.11+).
+ *
+ * Usage:
+ *  - Kept free of libwebsockets includes so it can use <linux/tcp.h>.
+ *  - Used by `exchange_connect.c` for periodic connection statistics and by
+ *    the low-latency mode of `cryptofeed.c`.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#ifndef SYS_STATS_H
+#define SYS_STATS_H
+
+/* Total bytes received on a TCP socket (TLS records included), -1 if unavailable */
+long long get_socket_rx_bytes(int fd);
+
+/* CPU time used by the calling thread in milliseconds */
+double get_thread_cpu_ms();
+
+/* Involuntary context switches of the calling thread so far, -1 if unavailable */
+long get_thread_involuntary_switches();
+
+/* Pin the calling thread to `cpu`; returns 0 on success, -1 on error */
+int pin_current_thread(int cpu);
+
+/* Enable SO_BUSY_POLL (and SO_PREFER_BUSY_POLL where defined) on a socket; returns 0 on success, -1 on error.
+ * Raising it above net.core.busy_read needs CAP_NET_ADMIN. */
+int set_socket_busy_poll(int fd, int usec);
+
+/* 1 if the `tls` upper-layer protocol is available for kTLS, 0 if not (module not loaded) */
+int kernel_tls_available();
+
+#endif // SYS_STATS_H
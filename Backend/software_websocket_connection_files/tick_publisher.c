@@ -0,0 +1,92 @@
+/*
+ * Tick Publisher
+ *
+ * Appends every parsed ticker, quote and trade to the shared-memory tick
+ * ring. The ring has a single writer: all calls come from the lws service
+ * thread.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#include "tick_publisher.h"
+#include "utils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+
+static TickRingWriter ring = {0};
+static char ring_name[64];
+
+static int64_t realtime_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static double to_double(const char *value) {
+    return value[0] ? strtod(value, NULL) : 0.0;
+}
+
+static int set_key(MarketRecord *record, const char *exchange, const char *symbol) {
+    if (!symbol[0] || strlen(exchange) >= MARKET_RECORD_EXCHANGE_LEN || strlen(symbol) >= MARKET_RECORD_SYMBOL_LEN)
+        return 0;
+    strcpy(record->exchange, exchange);
+    strcpy(record->symbol, symbol);
+    return 1;
+}
+
+int market_record_from_ticker(const TickerData *ticker, MarketRecord *record) {
+    memset(record, 0, sizeof(*record));
+    if (!set_key(record, ticker->exchange, ticker->currency)) return 0;
+
+    /* Top-of-book channels carry no last price */
+    record->kind = ticker->price[0] ? MARKET_RECORD_TICKER : MARKET_RECORD_QUOTE;
+    record->price = to_double(ticker->price);
+    record->bid = to_double(ticker->bid);
+    record->ask = to_double(ticker->ask);
+    record->bid_qty = to_double(ticker->bid_qty);
+    record->ask_qty = to_double(ticker->ask_qty);
+    /* Exchange time only: a local fallback timestamp would differ between redundant collectors */
+    record->event_ms = ticker->local_time ? 0 : timestamp_to_ms(ticker->time_ms[0] ? ticker->time_ms : ticker->timestamp);
+    record->recv_ns = realtime_ns();
+    return 1;
+}
+
+int market_record_from_trade(const TradeData *trade, MarketRecord *record) {
+    memset(record, 0, sizeof(*record));
+    if (!trade->price[0] || !set_key(record, trade->exchange, trade->currency)) return 0;
+
+    record->kind = MARKET_RECORD_TRADE;
+    record->price = to_double(trade->price);
+    record->size = to_double(trade->size);
+    record->event_ms = trade->local_time ? 0 : timestamp_to_ms(trade->timestamp);
+    record->recv_ns = realtime_ns();
+    record->trade_id = strtoull(trade->trade_id, NULL, 10);
+
+    /* "market_maker" is true when the buyer was the maker, i.e. a seller took liquidity */
+    if (strcmp(trade->market_maker, "true") == 0) record->side = MARKET_SIDE_SELL;
+    else if (strcmp(trade->market_maker, "false") == 0) record->side = MARKET_SIDE_BUY;
+    return 1;
+}
+
+int tick_publisher_start(const char *name) {
+    if (tick_ring_create(&ring, name, TICK_RING_CAPACITY) != 0) {
+        printf("[ERROR] Failed to create tick ring %s: %s\n", name, strerror(errno));
+        return -1;
+    }
+    snprintf(ring_name, sizeof(ring_name), "%s", name);
+    printf("[INFO] Publishing ticks to /dev/shm%s (%d records)\n", name, TICK_RING_CAPACITY);
+    return 0;
+}
+
+void tick_publisher_write(const MarketRecord *record) {
+    if (ring.header) tick_ring_write(&ring, record);
+}
+
+void tick_publisher_stop() {
+    tick_ring_close(&ring, ring_name);
+}
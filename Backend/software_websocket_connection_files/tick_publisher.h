@@ -0,0 +1,45 @@
+/*
+ * Tick Publisher Header
+ *
+ * Declares the collector side of the shared-memory tick ring (`tick_ring.h`)
+ * and the conversion from parsed exchange data to `MarketRecord`.
+ *
+ * Features:
+ *  - Every parsed ticker, top-of-book quote and trade is appended to the
+ *    ring once, after parsing and before file logging.
+ *  - `market_record_from_ticker()` / `market_record_from_trade()` are shared
+ *    with any other transport that ships records out of the process.
+ *
+ * Dependencies:
+ *  - tick_ring.h, market_record.h: Shared layouts.
+ *  - exchange_websocket.h: TickerData / TradeData.
+ *
+ * Usage:
+ *  - Implemented in `tick_publisher.c`.
+ *  - Started, stopped and fed by `cryptofeed.c`.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#ifndef TICK_PUBLISHER_H
+#define TICK_PUBLISHER_H
+
+#include "market_record.h"
+#include "tick_ring.h"
+#include "exchange_websocket.h"
+
+/* Convert parsed data to a record; returns 0 if it lacks the fields a record needs */
+int market_record_from_ticker(const TickerData *ticker, MarketRecord *record);
+int market_record_from_trade(const TradeData *trade, MarketRecord *record);
+
+/* Create (or replace) the ring; returns 0 on success, -1 on error */
+int tick_publisher_start(const char *name);
+
+/* Append one record to the ring */
+void tick_publisher_write(const MarketRecord *record);
+
+/* Mark the ring closed and unlink it */
+void tick_publisher_stop();
+
+#endif // TICK_PUBLISHER_H
@@ -0,0 +1,247 @@
+/*
+ * Tick Ring Header
+ *
+ * Declares a single-writer, multi-reader broadcast ring of `MarketRecord`s
+ * in shared memory, and a header-only library for writing and reading it.
+ *
+ * Features:
+ *  - Disruptor-style: a power-of-two array of slots addressed by a 64-bit
+ *    sequence number; the writer never waits for readers.
+ *  - Every slot carries a stamp (2 * seq + 1 while being written,
+ *    2 * seq + 2 once published). A reader that was lapped sees a newer
+ *    stamp, skips ahead and counts the records it lost.
+ *  - Readers attach independently and keep their own position; attaching
+ *    or falling behind never affects the writer or other readers.
+ *  - No syscalls after attach; an idle poll is one atomic load.
+ *  - Both sides map every page up front (huge pages where shmem allows),
+ *    so neither takes page faults in steady state.
+ *
+ * Dependencies:
+ *  - market_record.h: Record layout.
+ *  - POSIX shared memory (sys/mman.h, fcntl.h); GCC/Clang `__atomic` builtins.
+ *
+ * Usage:
+ *  - Written by the collector through `tick_publisher.c`.
+ *  - Consumers include this header only:
+ *        TickRingReader r;
+ *        MarketRecord rec;
+ *        if (tick_ring_attach(&r, TICK_RING_NAME, TICK_RING_FROM_LATEST) == 0)
+ *            while (running)
+ *                if (tick_ring_poll(&r, &rec)) ... else (idle) ...
+ *  - `make tick_ring_bench` builds a throughput benchmark.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#ifndef TICK_RING_H
+#define TICK_RING_H
+
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "market_record.h"
+#include "huge_alloc.h"
+
+#define TICK_RING_NAME "/crypto_ws_ticks"      // appears as /dev/shm/crypto_ws_ticks
+#define TICK_RING_MAGIC 0x4b545343u            // "CSTK"
+#define TICK_RING_VERSION 1
+#define TICK_RING_CAPACITY 65536               // records, power of two (8 MiB)
+
+#define TICK_RING_LIVE 1
+#define TICK_RING_CLOSED 2
+
+#define TICK_RING_FROM_LATEST 0                // start with the next record written
+#define TICK_RING_FROM_OLDEST 1                // start with the oldest record still in the ring
+
+typedef struct __attribute__((aligned(64))) {
+    uint32_t magic;                 // written last, once the ring is initialised
+    uint32_t version;
+    uint32_t capacity;
+    uint32_t slot_size;
+    uint32_t state;                 // TICK_RING_LIVE / TICK_RING_CLOSED
+    uint32_t reserved;
+    int64_t created_ns;
+
+    /* Own cache line: the only field readers poll */
+    uint64_t cursor __attribute__((aligned(64)));  // records published so far
+} TickRingHeader;
+
+typedef struct __attribute__((aligned(64))) {
+    uint64_t stamp;                 // 2 * seq + 1 while writing, 2 * seq + 2 when published
+    MarketRecord record;
+} TickRingSlot;
+
+_Static_assert(sizeof(TickRingSlot) == 128, "TickRingSlot must stay two cache lines");
+
+#define TICK_RING_SIZE(capacity) (sizeof(TickRingHeader) + (size_t)(capacity) * sizeof(TickRingSlot))
+
+/* ------------------------------------ Writer ------------------------------------ */
+
+typedef struct {
+    TickRingHeader *header;
+    TickRingSlot *slots;
+    uint64_t next;                  // sequence of the next record
+    uint64_t mask;
+} TickRingWriter;
+
+/* Create (or replace) the ring `name` with `capacity` slots; returns 0 on success, -1 on error */
+static inline int tick_ring_create(TickRingWriter *writer, const char *name, uint32_t capacity) {
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0) return -1;
+
+    /* Readers of a previous ring keep their mapping; new readers get the new one */
+    shm_unlink(name);
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) return -1;
+
+    size_t size = TICK_RING_SIZE(capacity);
+    if (ftruncate(fd, size) != 0) {
+        close(fd);
+        shm_unlink(name);
+        return -1;
+    }
+
+    void *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        shm_unlink(name);
+        return -1;
+    }
+    huge_prepare_shared(map, size, 1);
+
+    TickRingHeader *header = (TickRingHeader *)map;
+    header->version = TICK_RING_VERSION;
+    header->capacity = capacity;
+    header->slot_size = sizeof(TickRingSlot);
+    header->state = TICK_RING_LIVE;
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    header->created_ns = (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+    __atomic_store_n(&header->magic, TICK_RING_MAGIC, __ATOMIC_RELEASE);
+
+    writer->header = header;
+    writer->slots = (TickRingSlot *)(header + 1);
+    writer->next = 0;
+    writer->mask = capacity - 1;
+    return 0;
+}
+
+/* Publish one record; never blocks */
+static inline void tick_ring_write(TickRingWriter *writer, const MarketRecord *record) {
+    uint64_t seq = writer->next++;
+    TickRingSlot *slot = &writer->slots[seq & writer->mask];
+
+    __atomic_store_n(&slot->stamp, 2 * seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    slot->record = *record;
+    __atomic_store_n(&slot->stamp, 2 * seq + 2, __ATOMIC_RELEASE);
+    __atomic_store_n(&writer->header->cursor, seq + 1, __ATOMIC_RELEASE);
+}
+
+/* Mark the ring closed, unmap it and optionally unlink `name` */
+static inline void tick_ring_close(TickRingWriter *writer, const char *name) {
+    if (!writer->header) return;
+    __atomic_store_n(&writer->header->state, TICK_RING_CLOSED, __ATOMIC_RELEASE);
+    munmap(writer->header, TICK_RING_SIZE(writer->header->capacity));
+    if (name) shm_unlink(name);
+    writer->header = NULL;
+    writer->slots = NULL;
+}
+
+/* ------------------------------------ Reader ------------------------------------ */
+
+typedef struct {
+    const TickRingHeader *header;
+    const TickRingSlot *slots;
+    uint64_t next;                  // sequence of the next record to read
+    uint64_t mask;
+    uint64_t lost;                  // records overwritten before this reader got to them
+} TickRingReader;
+
+/* Map the ring read-only; returns 0 on success, -1 if it does not exist or is not a tick ring */
+static inline int tick_ring_attach(TickRingReader *reader, const char *name, int start) {
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) return -1;
+
+    struct stat st;
+    TickRingHeader header;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(TickRingHeader) ||
+        pread(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header) ||
+        header.magic != TICK_RING_MAGIC || header.version != TICK_RING_VERSION ||
+        header.slot_size != sizeof(TickRingSlot) || (size_t)st.st_size < TICK_RING_SIZE(header.capacity)) {
+        close(fd);
+        return -1;
+    }
+
+    void *map = mmap(NULL, TICK_RING_SIZE(header.capacity), PROT_READ, MAP_SHARED | MAP_POPULATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return -1;
+    huge_prepare_shared(map, TICK_RING_SIZE(header.capacity), 0);
+
+    reader->header = (const TickRingHeader *)map;
+    reader->slots = (const TickRingSlot *)(reader->header + 1);
+    reader->mask = header.capacity - 1;
+    reader->lost = 0;
+
+    uint64_t cursor = __atomic_load_n(&reader->header->cursor, __ATOMIC_ACQUIRE);
+    if (start == TICK_RING_FROM_OLDEST)
+        reader->next = (cursor > header.capacity) ? cursor - header.capacity : 0;
+    else
+        reader->next = cursor;
+    return 0;
+}
+
+static inline void tick_ring_detach(TickRingReader *reader) {
+    if (reader->header) munmap((void *)reader->header, TICK_RING_SIZE(reader->mask + 1));
+    reader->header = NULL;
+    reader->slots = NULL;
+}
+
+/* TICK_RING_LIVE while the writer runs, TICK_RING_CLOSED after it exits */
+static inline uint32_t tick_ring_state(const TickRingReader *reader) {
+    return __atomic_load_n(&reader->header->state, __ATOMIC_ACQUIRE);
+}
+
+/* Records published but not yet read by this reader */
+static inline uint64_t tick_ring_backlog(const TickRingReader *reader) {
+    return __atomic_load_n(&reader->header->cursor, __ATOMIC_ACQUIRE) - reader->next;
+}
+
+/* Copy the next record into `out`; returns 1 if one was read, 0 if the reader is caught up.
+ * Records overwritten before they could be read are skipped and added to `lost`. */
+static inline int tick_ring_poll(TickRingReader *reader, MarketRecord *out) {
+    uint64_t capacity = reader->mask + 1;
+
+    for (;;) {
+        uint64_t cursor = __atomic_load_n(&reader->header->cursor, __ATOMIC_ACQUIRE);
+        if (reader->next >= cursor) return 0;
+
+        /* Lapped: everything older than one ring behind the writer is gone */
+        if (cursor - reader->next > capacity) {
+            reader->lost += cursor - capacity - reader->next;
+            reader->next = cursor - capacity;
+        }
+
+        const TickRingSlot *slot = &reader->slots[reader->next & reader->mask];
+        uint64_t expected = 2 * reader->next + 2;
+        uint64_t before = __atomic_load_n(&slot->stamp, __ATOMIC_ACQUIRE);
+        if (before == expected) {
+            *out = slot->record;
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (__atomic_load_n(&slot->stamp, __ATOMIC_RELAXED) == expected) {
+                reader->next++;
+                return 1;
+            }
+        }
+        /* The writer has moved on to a later lap of this slot */
+        reader->lost++;
+        reader->next++;
+    }
+}
+
+#endif // TICK_RING_H
@@ -0,0 +1,147 @@
+/*
+ * Tick Ring Benchmark
+ *
+ * Measures shared-memory tick ring throughput with one writer and several
+ * reader processes, each attached independently through `tick_ring.h`.
+ *
+ * Features:
+ *  - Forks N readers, waits until all are attached, then writes M records
+ *    as fast as possible, or at a fixed rate to check readers keep up.
+ *  - Each reader reports records received, records lost to overwrite and
+ *    its own events/sec; readers also check the records arrive in order.
+ *
+ * Usage:
+ *  - Build: `make tick_ring_bench` (not part of `make all`).
+ *  - Run:   `./tick_ring_bench [readers] [records] [events/sec]`
+ *           (defaults: 4 readers, 20000000 records, unpaced).
+ *  - Unpaced, the writer laps readers that get less CPU than it does; that
+ *    shows up as "lost", not as corrupt or out-of-order records.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#include "tick_ring.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#define BENCH_RING_NAME "/crypto_ws_ticks_bench"
+
+static double now_sec() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int run_reader(int id, int ready_fd) {
+    TickRingReader reader;
+    if (tick_ring_attach(&reader, BENCH_RING_NAME, TICK_RING_FROM_LATEST) != 0) {
+        printf("[ERROR] Reader %d could not attach\n", id);
+        return 1;
+    }
+    char ok = 1;
+    if (write(ready_fd, &ok, 1) != 1) return 1;
+    close(ready_fd);
+
+    MarketRecord record;
+    uint64_t received = 0, out_of_order = 0, last_id = 0;
+    double start = 0;
+
+    for (;;) {
+        if (tick_ring_poll(&reader, &record)) {
+            if (received == 0) start = now_sec();
+            if (record.trade_id <= last_id) out_of_order++;
+            last_id = record.trade_id;
+            received++;
+        }
+        else if (tick_ring_state(&reader) == TICK_RING_CLOSED && tick_ring_backlog(&reader) == 0) {
+            break;
+        }
+    }
+
+    double elapsed = now_sec() - start;
+    printf("[INFO] Reader %d: %llu received, %llu lost, %llu out of order, %.2f M events/sec\n",
+           id, (unsigned long long)received, (unsigned long long)reader.lost,
+           (unsigned long long)out_of_order, elapsed > 0 ? received / elapsed / 1e6 : 0.0);
+    fflush(stdout);
+    tick_ring_detach(&reader);
+    return out_of_order ? 1 : 0;
+}
+
+int main(int argc, char **argv) {
+    int readers = (argc > 1) ? atoi(argv[1]) : 4;
+    long long records = (argc > 2) ? atoll(argv[2]) : 20000000LL;
+    double rate = (argc > 3) ? atof(argv[3]) : 0.0;
+    if (readers < 1 || records < 1 || rate < 0) {
+        fprintf(stderr, "Usage: %s [readers] [records] [events/sec]\n", argv[0]);
+        return 1;
+    }
+
+    TickRingWriter writer;
+    if (tick_ring_create(&writer, BENCH_RING_NAME, TICK_RING_CAPACITY) != 0) {
+        perror("tick_ring_create");
+        return 1;
+    }
+
+    fflush(stdout);
+    int ready[2];
+    if (pipe(ready) != 0) {
+        perror("pipe");
+        return 1;
+    }
+
+    for (int i = 0; i < readers; i++) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            perror("fork");
+            return 1;
+        }
+        if (pid == 0) {
+            /* Children leave with _exit(), so nothing buffered before the fork may be flushed twice */
+            close(ready[0]);
+            _exit(run_reader(i, ready[1]));
+        }
+    }
+    close(ready[1]);
+
+    /* Start writing only once every reader is attached */
+    char ok;
+    for (int i = 0; i < readers; i++) {
+        if (read(ready[0], &ok, 1) != 1) {
+            fprintf(stderr, "[ERROR] A reader exited before attaching\n");
+            return 1;
+        }
+    }
+    close(ready[0]);
+
+    MarketRecord record;
+    memset(&record, 0, sizeof(record));
+    record.kind = MARKET_RECORD_TRADE;
+    strcpy(record.exchange, "Bench");
+    strcpy(record.symbol, "BTC-USD");
+
+    double start = now_sec();
+    for (long long i = 1; i <= records; i++) {
+        record.trade_id = (uint64_t)i;
+        record.price = 50000.0 + (i & 1023);
+        tick_ring_write(&writer, &record);
+
+        /* Paced mode: hold every batch of 1024 records to its schedule */
+        if (rate > 0 && (i & 1023) == 0)
+            while (now_sec() - start < i / rate) {}
+    }
+    double elapsed = now_sec() - start;
+    printf("[INFO] Writer: %lld records, %.2f M events/sec, %d readers\n", records, records / elapsed / 1e6, readers);
+
+    tick_ring_close(&writer, BENCH_RING_NAME);
+
+    int failed = 0, status;
+    while (wait(&status) > 0)
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) failed = 1;
+    return failed;
+}
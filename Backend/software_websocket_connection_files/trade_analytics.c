@@ -0,0 +1,425 @@
+/*
+ * Trade Analytics
+ *
+ * Implements the rolling trade analytics from `trade_analytics.h`: window
+ * state per symbol, the shared-memory table of `analytics_table.h` and
+ * the periodic snapshot store. All calls come from one thread, so the table
+ * has a single writer and uses the same seqlock brackets as the quote table.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#define _GNU_SOURCE
+#include "trade_analytics.h"
+#include "huge_alloc.h"
+#include "leaderboard.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include <time.h>
+#include <sys/stat.h>
+
+/* One time bucket of one window: what its trades add to the running totals */
+typedef struct {
+    int64_t id;                     // bucket number (receive ms / bucket length), 0 = empty
+    uint32_t trades;
+    uint32_t reserved;
+    double pv;                      // sum of price * size
+    double volume;
+    double buy;
+    double sell;
+    double r2;                      // sum of squared log returns
+    double open;                    // first trade price in the bucket
+} Bucket;
+
+_Static_assert(sizeof(Bucket) == 64, "Bucket should stay one cache line");
+
+/* Running totals of the buckets still inside one window */
+typedef struct {
+    int64_t head;                   // newest bucket number the window has moved to
+    int64_t oldest;                 // oldest bucket holding trades, valid while trades > 0
+    uint64_t trades;
+    double pv;
+    double volume;
+    double buy;
+    double sell;
+    double r2;
+} Window;
+
+typedef struct {
+    char exchange[ANALYTICS_EXCHANGE_LEN];
+    char symbol[ANALYTICS_SYMBOL_LEN];
+    int claimed;
+    int dirty;                      // traded since the last snapshot
+    double last_price;
+    Window window[ANALYTICS_WINDOWS];
+    Bucket bucket[ANALYTICS_WINDOWS][ANALYTICS_BUCKETS];
+} SymbolState;
+
+static const int64_t window_ms[ANALYTICS_WINDOWS] = { 60000, 300000, 900000, 3600000 };
+static const char *window_names[ANALYTICS_WINDOWS] = { "1m", "5m", "15m", "1h" };
+
+/* Symbol states share their index with the table slots */
+static SymbolState *states = NULL;
+static int used_index[ANALYTICS_TABLE_SLOTS];
+static int used_count = 0;
+static int full_reported = 0;
+
+static AnalyticsTableHeader *table = NULL;
+static AnalyticsSlot *slots = NULL;
+static char table_name[64];
+
+static const char *output_dir = NULL;
+static FILE *store = NULL;
+static long store_day = -1;
+
+static int64_t next_refresh_ns = 0;
+static int64_t next_snapshot_ns = 0;
+static int64_t last_snapshot_ns = 0;
+static unsigned long long trades_since_snapshot = 0;
+
+static int64_t realtime_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME_COARSE, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static int64_t bucket_ms(int w) {
+    return window_ms[w] / ANALYTICS_BUCKETS;
+}
+
+/* ----------------------------------- Windows ------------------------------------ */
+
+/* Move window `w` forward to bucket `id`, subtracting every bucket that falls out of it */
+static void advance_window(SymbolState *s, int w, int64_t id) {
+    Window *win = &s->window[w];
+    Bucket *ring = s->bucket[w];
+    if (id <= win->head) return;
+
+    if (id - win->head >= ANALYTICS_BUCKETS) {
+        /* Quiet for a whole window: nothing is left */
+        memset(ring, 0, sizeof(s->bucket[w]));
+        memset(win, 0, sizeof(*win));
+    } else {
+        for (int64_t b = win->head - ANALYTICS_BUCKETS + 1; b <= id - ANALYTICS_BUCKETS; b++) {
+            Bucket *k = &ring[b % ANALYTICS_BUCKETS];
+            if (k->id != b) continue;
+            win->trades -= k->trades;
+            win->pv -= k->pv;
+            win->volume -= k->volume;
+            win->buy -= k->buy;
+            win->sell -= k->sell;
+            win->r2 -= k->r2;
+            memset(k, 0, sizeof(*k));
+        }
+        /* Drop the rounding left over from subtracting, so an empty window reads exactly zero */
+        if (win->trades == 0) memset(win, 0, sizeof(*win));
+    }
+    win->head = id;
+
+    /* The opening bucket only moves forward, so this is amortized O(1) */
+    if (win->trades) {
+        if (win->oldest < id - ANALYTICS_BUCKETS + 1) win->oldest = id - ANALYTICS_BUCKETS + 1;
+        while (ring[win->oldest % ANALYTICS_BUCKETS].id != win->oldest) win->oldest++;
+    }
+}
+
+static void add_trade(SymbolState *s, int w, int64_t id, const MarketRecord *record, double r2) {
+    Window *win = &s->window[w];
+    if (id > win->head) advance_window(s, w, id);
+    else if (id <= win->head - ANALYTICS_BUCKETS) return;   // older than the window
+
+    Bucket *k = &s->bucket[w][id % ANALYTICS_BUCKETS];
+    if (k->id != id) {
+        k->id = id;
+        k->open = record->price;
+    }
+    if (win->trades == 0 || id < win->oldest) win->oldest = id;
+
+    double pv = record->price * record->size;
+    double buy = record->side == MARKET_SIDE_BUY ? record->size : 0.0;
+    double sell = record->side == MARKET_SIDE_SELL ? record->size : 0.0;
+
+    k->trades++;
+    k->pv += pv;
+    k->volume += record->size;
+    k->buy += buy;
+    k->sell += sell;
+    k->r2 += r2;
+
+    win->trades++;
+    win->pv += pv;
+    win->volume += record->size;
+    win->buy += buy;
+    win->sell += sell;
+    win->r2 += r2;
+}
+
+static void window_values(const SymbolState *s, int w, AnalyticsWindow *out) {
+    const Window *win = &s->window[w];
+    double sided = win->buy + win->sell;
+
+    out->trades = win->trades;
+    out->volume = win->volume;
+    out->vwap = win->volume > 0 ? win->pv / win->volume : 0.0;
+    out->volatility = win->r2 > 0 ? 100.0 * sqrt(win->r2) : 0.0;
+    out->avg_size = win->trades ? win->volume / win->trades : 0.0;
+    out->buy_volume = win->buy;
+    out->sell_volume = win->sell;
+    out->imbalance = sided > 0 ? (win->buy - win->sell) / sided : 0.0;
+    out->open = win->trades ? s->bucket[w][win->oldest % ANALYTICS_BUCKETS].open : 0.0;
+}
+
+/* ------------------------------------ Table ------------------------------------- */
+
+static int create_table(const char *name) {
+    /* A table left by a previous run may still be mapped by readers; they keep the old copy */
+    shm_unlink(name);
+
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        printf("[ERROR] shm_open(%s) failed: %s\n", name, strerror(errno));
+        return -1;
+    }
+    if (ftruncate(fd, ANALYTICS_TABLE_SIZE) != 0) {
+        printf("[ERROR] Failed to size analytics table: %s\n", strerror(errno));
+        close(fd);
+        shm_unlink(name);
+        return -1;
+    }
+
+    void *map = mmap(NULL, ANALYTICS_TABLE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        printf("[ERROR] Failed to map analytics table: %s\n", strerror(errno));
+        shm_unlink(name);
+        return -1;
+    }
+    huge_prepare_shared(map, ANALYTICS_TABLE_SIZE, 1);
+
+    table = (AnalyticsTableHeader *)map;
+    table->version = ANALYTICS_TABLE_VERSION;
+    table->slot_count = ANALYTICS_TABLE_SLOTS;
+    table->slot_size = sizeof(AnalyticsSlot);
+    table->state = ANALYTICS_TABLE_LIVE;
+    table->created_ns = realtime_ns();
+    for (int w = 0; w < ANALYTICS_WINDOWS; w++) table->window_ms[w] = window_ms[w];
+    __atomic_store_n(&table->magic, ANALYTICS_TABLE_MAGIC, __ATOMIC_RELEASE);
+
+    slots = (AnalyticsSlot *)(table + 1);
+    snprintf(table_name, sizeof(table_name), "%s", name);
+    printf("[INFO] Publishing trade analytics to /dev/shm%s (%d slots)\n", name, ANALYTICS_TABLE_SLOTS);
+    return 0;
+}
+
+static void publish(int index, int64_t now_ns) {
+    const SymbolState *s = &states[index];
+    AnalyticsWindow values[ANALYTICS_WINDOWS];
+    for (int w = 0; w < ANALYTICS_WINDOWS; w++) window_values(s, w, &values[w]);
+    leaderboard_update(index, s->exchange, s->symbol, s->last_price, values);
+    if (!table) return;
+    AnalyticsSlot *slot = &slots[index];
+
+    __atomic_store_n(&slot->seq, slot->seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    slot->last_price = s->last_price;
+    memcpy(slot->window, values, sizeof(values));
+    slot->update_ns = now_ns;
+    slot->updates++;
+    __atomic_store_n(&slot->seq, slot->seq + 1, __ATOMIC_RELEASE);
+}
+
+/* Index of (exchange, symbol), claiming a state and table slot on first use; -1 when full */
+static int state_for(const char *exchange, const char *symbol) {
+    if (strlen(exchange) >= ANALYTICS_EXCHANGE_LEN || strlen(symbol) >= ANALYTICS_SYMBOL_LEN || !symbol[0])
+        return -1;
+
+    uint32_t mask = ANALYTICS_TABLE_SLOTS - 1;
+    uint32_t index = analytics_table_hash(exchange, symbol) & mask;
+
+    for (uint32_t probe = 0; probe <= mask; probe++) {
+        int i = (int)((index + probe) & mask);
+        SymbolState *s = &states[i];
+        if (!s->claimed) {
+            strcpy(s->exchange, exchange);
+            strcpy(s->symbol, symbol);
+            s->claimed = 1;
+            used_index[used_count++] = i;
+            if (table) {
+                strcpy(slots[i].exchange, exchange);
+                strcpy(slots[i].symbol, symbol);
+                __atomic_store_n(&slots[i].claimed, 1, __ATOMIC_RELEASE);
+                __atomic_store_n(&table->used, table->used + 1, __ATOMIC_RELAXED);
+            }
+            return i;
+        }
+        if (strcmp(s->exchange, exchange) == 0 && strcmp(s->symbol, symbol) == 0)
+            return i;
+    }
+
+    if (!full_reported) {
+        printf("[WARNING] Analytics table full (%d symbols), new symbols are not tracked\n", ANALYTICS_TABLE_SLOTS);
+        full_reported = 1;
+    }
+    return -1;
+}
+
+/* ------------------------------------ Store ------------------------------------- */
+
+static void open_store(long day) {
+    if (store) fclose(store);
+    store = NULL;
+    store_day = day;
+
+    time_t t = (time_t)day * 86400;
+    struct tm tm;
+    gmtime_r(&t, &tm);
+    char filename[512];
+    snprintf(filename, sizeof(filename), "%s/analytics_%04d%02d%02d.json", output_dir,
+             tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday);
+
+    store = fopen(filename, "a");
+    if (!store) {
+        printf("[ERROR] Failed to open analytics store %s: %s\n", filename, strerror(errno));
+        return;
+    }
+    printf("[INFO] Writing analytics snapshots to %s\n", filename);
+}
+
+static void write_snapshot_line(const SymbolState *s, const char *time_text) {
+    fprintf(store, "{\"time\":\"%s\",\"exchange\":\"%s\",\"symbol\":\"%s\",\"price\":%.10g",
+            time_text, s->exchange, s->symbol, s->last_price);
+    for (int w = 0; w < ANALYTICS_WINDOWS; w++) {
+        AnalyticsWindow v;
+        window_values(s, w, &v);
+        fprintf(store, ",\"%s\":{\"trades\":%llu,\"volume\":%.10g,\"vwap\":%.10g,\"volatility\":%.6g,"
+                "\"avg_size\":%.10g,\"buy_volume\":%.10g,\"sell_volume\":%.10g,\"imbalance\":%.4f,\"open\":%.10g}",
+                window_names[w], (unsigned long long)v.trades, v.volume, v.vwap, v.volatility,
+                v.avg_size, v.buy_volume, v.sell_volume, v.imbalance, v.open);
+    }
+    fputs("}\n", store);
+}
+
+/* One line per symbol that traded since the last snapshot */
+static void write_snapshot(int64_t now_ns) {
+    int lines = 0;
+
+    if (output_dir) {
+        time_t seconds = (time_t)(now_ns / 1000000000LL);
+        long day = (long)(seconds / 86400);
+        if (day != store_day) open_store(day);
+
+        struct tm tm;
+        gmtime_r(&seconds, &tm);
+        char time_text[32];
+        strftime(time_text, sizeof(time_text), "%Y-%m-%dT%H:%M:%SZ", &tm);
+
+        for (int u = 0; store && u < used_count; u++) {
+            SymbolState *s = &states[used_index[u]];
+            if (!s->dirty) continue;
+            write_snapshot_line(s, time_text);
+            s->dirty = 0;
+            lines++;
+        }
+        if (store) fflush(store);
+    }
+
+    printf("[STATS] analytics: %d symbols, %llu trades over the last %.0f s, %d snapshot lines\n",
+           used_count, trades_since_snapshot, (now_ns - last_snapshot_ns) / 1e9, lines);
+    trades_since_snapshot = 0;
+    last_snapshot_ns = now_ns;
+}
+
+/* ------------------------------------- API -------------------------------------- */
+
+int trade_analytics_start(const char *name, const char *dir) {
+    states = huge_alloc(sizeof(SymbolState) * ANALYTICS_TABLE_SLOTS, "analytics windows");
+    if (!states) return -1;
+    used_count = 0;
+
+    if (name && create_table(name) != 0)
+        printf("[WARNING] Shared-memory analytics table disabled\n");
+
+    output_dir = dir;
+    if (output_dir && mkdir(output_dir, 0755) != 0 && errno != EEXIST) {
+        printf("[WARNING] Cannot create %s (%s), analytics snapshots disabled\n", output_dir, strerror(errno));
+        output_dir = NULL;
+    }
+
+    leaderboard_start();
+    int64_t now = realtime_ns();
+    next_refresh_ns = now + (int64_t)ANALYTICS_REFRESH_MS * 1000000;
+    next_snapshot_ns = now + (int64_t)ANALYTICS_SNAPSHOT_MS * 1000000;
+    last_snapshot_ns = now;
+    return 0;
+}
+
+void trade_analytics_record(const MarketRecord *record) {
+    if (!states || record->kind != MARKET_RECORD_TRADE || (record->flags & MARKET_FLAG_OUTLIER) ||
+        !(record->price > 0) || record->size < 0) return;
+    int index = state_for(record->exchange, record->symbol);
+    if (index < 0) return;
+    SymbolState *s = &states[index];
+
+    double r2 = 0.0;
+    if (s->last_price > 0) {
+        double r = log(record->price / s->last_price);
+        r2 = r * r;
+    }
+    s->last_price = record->price;
+    s->dirty = 1;
+
+    int64_t ms = record->recv_ns / 1000000;
+    for (int w = 0; w < ANALYTICS_WINDOWS; w++)
+        add_trade(s, w, ms / bucket_ms(w), record, r2);
+
+    publish(index, record->recv_ns);
+    trades_since_snapshot++;
+}
+
+void trade_analytics_poll() {
+    if (!states) return;
+    int64_t now = realtime_ns();
+    if (now < next_refresh_ns) return;
+    next_refresh_ns = now + (int64_t)ANALYTICS_REFRESH_MS * 1000000;
+
+    /* Age out symbols that have gone quiet; the longest window empties last */
+    int64_t ms = now / 1000000;
+    for (int u = 0; u < used_count; u++) {
+        SymbolState *s = &states[used_index[u]];
+        if (s->window[ANALYTICS_WINDOWS - 1].trades == 0) continue;
+        for (int w = 0; w < ANALYTICS_WINDOWS; w++) advance_window(s, w, ms / bucket_ms(w));
+        publish(used_index[u], now);
+    }
+    leaderboard_publish(now);
+
+    if (now >= next_snapshot_ns) {
+        next_snapshot_ns = now + (int64_t)ANALYTICS_SNAPSHOT_MS * 1000000;
+        write_snapshot(now);
+    }
+}
+
+void trade_analytics_stop() {
+    if (!states) return;
+    write_snapshot(realtime_ns());
+    leaderboard_publish(realtime_ns());
+    leaderboard_stop();
+    if (store) fclose(store);
+    store = NULL;
+    store_day = -1;
+
+    if (table) {
+        __atomic_store_n(&table->state, ANALYTICS_TABLE_CLOSED, __ATOMIC_RELEASE);
+        munmap(table, ANALYTICS_TABLE_SIZE);
+        shm_unlink(table_name);
+        table = NULL;
+        slots = NULL;
+    }
+
+    huge_free(states, sizeof(SymbolState) * ANALYTICS_TABLE_SLOTS);
+    states = NULL;
+}
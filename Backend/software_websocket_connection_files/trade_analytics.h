@@ -0,0 +1,63 @@
+/*
+ * Trade Analytics Header
+ *
+ * Declares the in-process analytics stage driven by the trade stream: per
+ * (exchange, symbol) rolling VWAP, realized volatility, trade count,
+ * buy/sell imbalance and average trade size over the windows listed in
+ * `analytics_table.h`.
+ *
+ * Features:
+ *  - Each window is a ring of ANALYTICS_BUCKETS time buckets plus running
+ *    totals. A trade is added to its bucket and the totals; buckets that
+ *    fall out of the window are subtracted as time moves on. Nothing is
+ *    rescanned, so a trade costs the same whatever the window length.
+ *  - Windows run on the collector's receive clock (`recv_ns`), so they
+ *    keep moving while a symbol is quiet and exchange clock skew does not
+ *    matter. Their edges move in steps of window / ANALYTICS_BUCKETS.
+ *  - Outputs: the shared-memory table (`analytics_table.h`), updated after
+ *    every trade, and a snapshot store: every ANALYTICS_SNAPSHOT_MS, one
+ *    JSON line per symbol that traded since the previous snapshot, in
+ *    `<dir>/analytics_YYYYMMDD.json`.
+ *  - The same window updates keep the top-N movers, volume and trade
+ *    count leaderboards (`leaderboard.h`), published with the refresh.
+ *  - Trades the price filter flagged as outliers are skipped.
+ *  - Buy/sell volume uses the record's aggressor side (`MarketSide`);
+ *    trades without one count towards volume only.
+ *  - Window state sits on prefaulted huge pages (`huge_alloc.h`).
+ *
+ * Dependencies:
+ *  - analytics_table.h, market_record.h, huge_alloc.h, leaderboard.h.
+ *
+ * Usage:
+ *  - Fed by `cryptofeed.c` (or the supervisor's aggregator) from the
+ *    service thread; every call must come from that one thread.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#ifndef TRADE_ANALYTICS_H
+#define TRADE_ANALYTICS_H
+
+#include "analytics_table.h"
+#include "market_record.h"
+
+#define ANALYTICS_OUTPUT_DIR "analytics_output"
+#define ANALYTICS_BUCKETS 30                // per window: 2 s buckets for 1m, 2 min for 1h
+#define ANALYTICS_REFRESH_MS 1000           // age out the windows of quiet symbols
+#define ANALYTICS_SNAPSHOT_MS 60000         // snapshot store period
+
+/* Allocate the window state and create the shared table `table_name` (NULL = no table) and
+ * the snapshot directory `output_dir` (NULL = no snapshots); returns 0, or -1 if out of memory */
+int trade_analytics_start(const char *table_name, const char *output_dir);
+
+/* Add one trade; other record kinds are ignored */
+void trade_analytics_record(const MarketRecord *record);
+
+/* Refresh quiet symbols and write the snapshot when due; cheap to call on every service pass */
+void trade_analytics_poll();
+
+/* Write a final snapshot, close the store and the table */
+void trade_analytics_stop();
+
+#endif // TRADE_ANALYTICS_H
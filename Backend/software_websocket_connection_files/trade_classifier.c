@@ -0,0 +1,108 @@
+/*
+ * Trade Classifier
+ *
+ * Implements the aggressor classification of `trade_classifier.h`. The
+ * quote comes from the symbol registry; the tick rule state (previous
+ * trade price and direction of the last price change) is kept here per
+ * registry id, since the registry's last price also moves with tickers.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#include "trade_classifier.h"
+#include "symbol_registry.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+enum { RULE_QUOTE = 0, RULE_TICK, RULE_NONE, RULES };
+
+static double last_trade[SYMBOL_REGISTRY_MAX];
+static int8_t last_direction[SYMBOL_REGISTRY_MAX];     // +1 uptick, -1 downtick, 0 none yet
+
+static int started = 0;
+static int64_t next_report_ns = 0;
+static unsigned long long inferred[RULES];             // venue-unlabelled trades, by the rule that decided them
+static unsigned long long labelled, checked, agreed;   // venue-labelled trades, and how often inference matched
+
+static void report(int64_t now) {
+    unsigned long long total = inferred[RULE_QUOTE] + inferred[RULE_TICK] + inferred[RULE_NONE];
+    printf("[STATS] trade classifier: %llu inferred (%llu quote rule, %llu tick rule, %llu unknown), "
+           "%llu venue-labelled (%.1f%% agreement) over the last %d s\n",
+           total, inferred[RULE_QUOTE], inferred[RULE_TICK], inferred[RULE_NONE], labelled,
+           checked ? 100.0 * agreed / checked : 0.0, TRADE_CLASSIFIER_REPORT_MS / 1000);
+    memset(inferred, 0, sizeof(inferred));
+    labelled = checked = agreed = 0;
+    next_report_ns = now + (int64_t)TRADE_CLASSIFIER_REPORT_MS * 1000000;
+}
+
+void trade_classifier_start() {
+    memset(last_trade, 0, sizeof(last_trade));
+    memset(last_direction, 0, sizeof(last_direction));
+    memset(inferred, 0, sizeof(inferred));
+    labelled = checked = agreed = 0;
+    next_report_ns = 0;
+    started = 1;
+}
+
+/* Tick rule: direction of the trade against the previous different trade price */
+static int tick_side(int id, double price) {
+    int direction = price > last_trade[id] ? 1 : price < last_trade[id] ? -1 : last_direction[id];
+    if (!last_trade[id]) direction = 0;
+    return direction > 0 ? MARKET_SIDE_BUY : direction < 0 ? MARKET_SIDE_SELL : MARKET_SIDE_UNKNOWN;
+}
+
+int trade_classifier_classify(int id, MarketRecord *record) {
+    if (!started || id < 0 || record->kind != MARKET_RECORD_TRADE || record->price <= 0)
+        return record->side;
+
+    int64_t now = record->recv_ns;
+    if (now >= next_report_ns) {
+        if (next_report_ns) report(now);
+        else next_report_ns = now + (int64_t)TRADE_CLASSIFIER_REPORT_MS * 1000000;
+    }
+
+    double price = record->price;
+    const SymbolQuote *q = &symbol_registry_info(id)->quote;
+    int usable = q->quote_ns && q->bid > 0 && q->ask > q->bid &&
+                 now - q->quote_ns <= (int64_t)TRADE_CLASSIFIER_QUOTE_STALE_MS * 1000000;
+
+    /* Quote rule first, tick rule at the mid or without a usable quote */
+    int side = MARKET_SIDE_UNKNOWN, rule = RULE_NONE;
+    if (usable) {
+        double mid = (q->bid + q->ask) / 2;
+        if (price > mid) side = MARKET_SIDE_BUY;
+        else if (price < mid) side = MARKET_SIDE_SELL;
+        if (side != MARKET_SIDE_UNKNOWN) rule = RULE_QUOTE;
+    }
+    if (side == MARKET_SIDE_UNKNOWN) {
+        side = tick_side(id, price);
+        if (side != MARKET_SIDE_UNKNOWN) rule = RULE_TICK;
+    }
+
+    if (last_trade[id] && price != last_trade[id]) last_direction[id] = price > last_trade[id] ? 1 : -1;
+    last_trade[id] = price;
+
+    if (record->side != MARKET_SIDE_UNKNOWN) {
+        labelled++;
+        if (side != MARKET_SIDE_UNKNOWN) {
+            checked++;
+            agreed += side == record->side;
+        }
+        return record->side;
+    }
+    inferred[rule]++;
+    record->side = side;
+    return side;
+}
+
+void trade_classifier_stop() {
+    if (!started) return;
+
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    report((int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec);
+    started = 0;
+}
@@ -0,0 +1,52 @@
+/*
+ * Trade Classifier Header
+ *
+ * Declares the aggressor classification of trades. The adapters map each
+ * venue's side field to `market_maker`; a trade that still arrives without
+ * one is matched against the prevailing top of book of the same venue
+ * symbol and the aggressor is inferred.
+ *
+ * Features:
+ *  - O(1) join: the prevailing bid/ask is the registry id's latest clean
+ *    quote (`symbol_registry.h`), so no lookup beyond the id the record
+ *    already resolved.
+ *  - Quote rule: a trade at or above the ask (or above the mid) was bought
+ *    by the taker, at or below the bid (or below the mid) sold.
+ *  - Lee-Ready fallback: trades at the mid, and trades without a usable
+ *    quote (none yet, crossed, or older than TRADE_CLASSIFIER_QUOTE_STALE_MS),
+ *    use the tick rule against the previous trade of the same symbol; a
+ *    zero tick keeps the direction of the last price change.
+ *  - Venue-labelled trades keep their label and are used to report how
+ *    often the inference agrees with the venue.
+ *  - A `[STATS] trade classifier` line every TRADE_CLASSIFIER_REPORT_MS.
+ *
+ * Dependencies:
+ *  - symbol_registry.h, market_record.h.
+ *
+ * Usage:
+ *  - `cryptofeed.c` calls `trade_classifier_classify()` for each clean
+ *    trade before it updates the registry, then fills
+ *    `TradeData.market_maker` from the side. Service thread only.
+ *
+ * Created: 10/17/2026
+ * Updated: 10/17/2026
+ */
+
+#ifndef TRADE_CLASSIFIER_H
+#define TRADE_CLASSIFIER_H
+
+#include "market_record.h"
+
+#define TRADE_CLASSIFIER_QUOTE_STALE_MS 5000    // older quotes no longer describe the book
+#define TRADE_CLASSIFIER_REPORT_MS 60000
+
+/* Clear the tick rule state and the counters */
+void trade_classifier_start();
+
+/* Set `record->side` of a clean trade of registry id `id` when the venue left it unknown; returns the side */
+int trade_classifier_classify(int id, MarketRecord *record);
+
+/* Report totals */
+void trade_classifier_stop();
+
+#endif // TRADE_CLASSIFIER_H